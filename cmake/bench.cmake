@@ -0,0 +1,140 @@
+##========================================================================== //
+## Copyright (c) 2022, Stephen Henry
+## All rights reserved.
+##
+## Redistribution and use in source and binary forms, with or without
+## modification, are permitted provided that the following conditions are met:
+##
+## * Redistributions of source code must retain the above copyright notice, this
+##   list of conditions and the following disclaimer.
+##
+## * Redistributions in binary form must reproduce the above copyright notice,
+##   this list of conditions and the following disclaimer in the documentation
+##   and/or other materials provided with the distribution.
+##
+## THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+## AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+## IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+## ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+## LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+## CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+## SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+## INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+## CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+## ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+## POSSIBILITY OF SUCH DAMAGE.
+##========================================================================== //
+
+# Benchmark result collation and comparison (run in script mode: cmake -P).
+#
+#   RESULT_DIR  Directory containing <workload>.json, as emitted by the Bench
+#               test.
+#   BASELINE    Checked-in baseline against which results are compared.
+#   WORKLOADS   Comma-separated list of workloads.
+#   TOLERANCE   (Optional) Tolerance (%) applied to host-level metrics,
+#               overriding that specified by the baseline.
+#   UPDATE      (Optional) Rewrite BASELINE with the current results.
+#
+# Metrics are integral (CMake arithmetic is integer-only). Host-level metrics
+# are compared one-sided (a regression fails, an improvement does not);
+# UUT-level metrics are compared two-sided, as any change in behavior is
+# notable. UUT-level metrics depend upon the number of measured cycles, and are
+# compared only where this matches that of the baseline.
+
+cmake_minimum_required(VERSION 3.20)
+
+set(BENCH_METRICS cycles_per_s ns_per_command notify_ppm query_error_ppm)
+set(BENCH_HOST_METRICS cycles_per_s ns_per_command)
+set(BENCH_DEFAULT_TOLERANCE 10)
+
+string(REPLACE "," ";" WORKLOADS "${WORKLOADS}")
+
+# Collate per-workload results.
+set(results "{\"workloads\": {}}")
+foreach (w ${WORKLOADS})
+  set(fn "${RESULT_DIR}/${w}.json")
+  if (NOT EXISTS "${fn}")
+    message(FATAL_ERROR "Benchmark result not found: ${fn}")
+  endif ()
+  file(READ "${fn}" r)
+  string(JSON results SET "${results}" workloads ${w} "${r}")
+  string(JSON context_n GET "${r}" context_n)
+  string(JSON entries_n GET "${r}" entries_n)
+  string(JSON cycles GET "${r}" cycles)
+endforeach ()
+string(JSON results SET "${results}" context_n ${context_n})
+string(JSON results SET "${results}" entries_n ${entries_n})
+string(JSON results SET "${results}" cycles ${cycles})
+file(WRITE "${RESULT_DIR}/results.json" "${results}\n")
+message(STATUS "Benchmark results: ${RESULT_DIR}/results.json")
+
+if (EXISTS "${BASELINE}")
+  file(READ "${BASELINE}" baseline)
+else ()
+  set(baseline "{\"tolerance\": {}, \"workloads\": {}}")
+endif ()
+
+if (UPDATE)
+  string(JSON w GET "${results}" workloads)
+  string(JSON baseline SET "${baseline}" workloads "${w}")
+  string(JSON baseline SET "${baseline}" context_n ${context_n})
+  string(JSON baseline SET "${baseline}" entries_n ${entries_n})
+  string(JSON baseline SET "${baseline}" cycles ${cycles})
+  file(WRITE "${BASELINE}" "${baseline}\n")
+  message(STATUS "Benchmark baseline updated: ${BASELINE}")
+  return ()
+endif ()
+
+string(JSON baseline_cycles ERROR_VARIABLE err GET "${baseline}" cycles)
+if (err)
+  set(baseline_cycles ${cycles})
+endif ()
+
+set(fail_n 0)
+foreach (w ${WORKLOADS})
+  foreach (m ${BENCH_METRICS})
+    string(JSON actual GET "${results}" workloads ${w} ${m})
+    string(JSON expected ERROR_VARIABLE err GET "${baseline}" workloads ${w} ${m})
+    if (err)
+      message(STATUS "  ${w}/${m}: ${actual} (no baseline)")
+      continue ()
+    endif ()
+    if ((NOT m IN_LIST BENCH_HOST_METRICS) AND
+        (NOT cycles EQUAL baseline_cycles))
+      message(STATUS
+        "  ${w}/${m}: ${actual} (baseline at ${baseline_cycles} cycles)")
+      continue ()
+    endif ()
+
+    string(JSON tol ERROR_VARIABLE err GET "${baseline}" tolerance ${m})
+    if (err)
+      set(tol ${BENCH_DEFAULT_TOLERANCE})
+    endif ()
+    if ((DEFINED TOLERANCE) AND (NOT TOLERANCE STREQUAL "") AND
+        (m IN_LIST BENCH_HOST_METRICS))
+      set(tol ${TOLERANCE})
+    endif ()
+
+    math(EXPR slack "${expected} * ${tol} / 100")
+    math(EXPR lo "${expected} - ${slack}")
+    math(EXPR hi "${expected} + ${slack}")
+    if (m STREQUAL "cycles_per_s")
+      # Higher is better.
+      set(hi ${actual})
+    elseif (m STREQUAL "ns_per_command")
+      # Lower is better.
+      set(lo ${actual})
+    endif ()
+
+    if ((actual LESS lo) OR (actual GREATER hi))
+      message(STATUS "  ${w}/${m}: ${actual} (baseline ${expected} +/- ${tol}%) FAIL")
+      math(EXPR fail_n "${fail_n} + 1")
+    else ()
+      message(STATUS "  ${w}/${m}: ${actual} (baseline ${expected} +/- ${tol}%)")
+    endif ()
+  endforeach ()
+endforeach ()
+
+if (fail_n GREATER 0)
+  message(FATAL_ERROR "Benchmark regressed on ${fail_n} metric(s).")
+endif ()
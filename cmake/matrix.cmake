@@ -0,0 +1,206 @@
+##========================================================================== //
+## Copyright (c) 2022, Stephen Henry
+## All rights reserved.
+##
+## Redistribution and use in source and binary forms, with or without
+## modification, are permitted provided that the following conditions are met:
+##
+## * Redistributions of source code must retain the above copyright notice, this
+##   list of conditions and the following disclaimer.
+##
+## * Redistributions in binary form must reproduce the above copyright notice,
+##   this list of conditions and the following disclaimer in the documentation
+##   and/or other materials provided with the distribution.
+##
+## THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+## AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+## IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+## ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+## LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+## CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+## SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+## INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+## CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+## ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+## POSSIBILITY OF SUCH DAMAGE.
+##========================================================================== //
+
+# Multi-configuration build matrix.
+#
+# Each entry of CONFIG_MATRIX, of the form CONTEXT_N:ENTRIES_N:ALLOW_DUPLICATES
+# (e.g. "4:4:ON;64:16:OFF"), is configured and built as an independent
+# sub-build of this source tree (matrix/<C>x<E>x<D>), with its own generated
+# configuration, Verilated library and driver. An entry may be followed by
+# further <KNOB>=<VALUE> fields selecting a non-default mode, where <KNOB> is
+# one of:
+#
+#   ENTRIES_BLOCK_N      (tag suffix _b<N>)
+#   UPDATE_PORTS_N       (tag suffix _u<N>)
+#   QUERY_PORTS_N        (tag suffix _q<N>)
+#   QUERY_FORWARD        (tag suffix _qf<0|1>)
+#   UPDATE_FULL_FORWARD  (tag suffix _ff<0|1>)
+#
+# (e.g. "16:16:ON:UPDATE_PORTS_N=2:QUERY_PORTS_N=2" builds
+# matrix/16x16x1_u2_q2).
+#
+# 'matrix' builds every entry; 'sweep' runs a fixed Bench workload against
+# each entry without knobs and plots the results (sweep/sweep.csv, and
+# sweep/sweep.png where gnuplot is present). 'matrix_synth' collates the
+# synthesis report of each (synth.json). For each entry, ctest runs the
+# Regress and directed tests of the sub-build (matrix_<tag>), having first
+# built it (matrix_<tag>_build).
+
+include(ExternalProject)
+
+set(SWEEP_WORKLOAD mixed CACHE STRING "Bench workload run by 'sweep'.")
+set(SWEEP_N 100000 CACHE STRING "Measured cycles per 'sweep' configuration.")
+
+find_program(GNUPLOT_EXE gnuplot)
+
+# Tests of each sub-build run per matrix entry.
+set(MATRIX_TESTS_REGEX "^(basic_|regress_|Check|Coro)")
+
+# Knobs which may be varied per entry, and their tag suffixes.
+set(MATRIX_KNOBS
+  ENTRIES_BLOCK_N
+  UPDATE_PORTS_N
+  QUERY_PORTS_N
+  QUERY_FORWARD
+  UPDATE_FULL_FORWARD)
+set(MATRIX_KNOB_SUFFIX_ENTRIES_BLOCK_N b)
+set(MATRIX_KNOB_SUFFIX_UPDATE_PORTS_N u)
+set(MATRIX_KNOB_SUFFIX_QUERY_PORTS_N q)
+set(MATRIX_KNOB_SUFFIX_QUERY_FORWARD qf)
+set(MATRIX_KNOB_SUFFIX_UPDATE_FULL_FORWARD ff)
+
+set(MATRIX_TAGS)
+set(MATRIX_DRIVERS)
+set(MATRIX_SWEEP_TAGS)
+set(MATRIX_SWEEP_DRIVERS)
+foreach (cfg ${CONFIG_MATRIX})
+  string(REPLACE ":" ";" fields "${cfg}")
+  list(LENGTH fields fields_n)
+  if (fields_n LESS 3)
+    message(FATAL_ERROR "Malformed CONFIG_MATRIX entry: ${cfg}")
+  endif ()
+  list(GET fields 0 context_n)
+  list(GET fields 1 entries_n)
+  list(GET fields 2 allow_duplicates)
+  set(knobs)
+  if (fields_n GREATER 3)
+    list(SUBLIST fields 3 -1 knobs)
+  endif ()
+  if (allow_duplicates)
+    set(allow_duplicates ON)
+    set(d 1)
+  else ()
+    set(allow_duplicates OFF)
+    set(d 0)
+  endif ()
+
+  set(tag "${context_n}x${entries_n}x${d}")
+  set(knob_args)
+  foreach (knob ${knobs})
+    if (NOT knob MATCHES "^([A-Z_]+)=(.+)$")
+      message(FATAL_ERROR "Malformed CONFIG_MATRIX knob: ${knob} (${cfg})")
+    endif ()
+    set(name "${CMAKE_MATCH_1}")
+    set(value "${CMAKE_MATCH_2}")
+    if (NOT name IN_LIST MATRIX_KNOBS)
+      message(FATAL_ERROR "Unsupported CONFIG_MATRIX knob: ${name} (${cfg})")
+    endif ()
+    if (name MATCHES "_FORWARD$")
+      if (value)
+        set(value ON)
+        set(v 1)
+      else ()
+        set(value OFF)
+        set(v 0)
+      endif ()
+    else ()
+      set(v ${value})
+    endif ()
+    string(APPEND tag "_${MATRIX_KNOB_SUFFIX_${name}}${v}")
+    list(APPEND knob_args "-D${name}=${value}")
+  endforeach ()
+
+  set(bin_dir "${CMAKE_BINARY_DIR}/matrix/${tag}")
+  ExternalProject_Add(matrix_${tag}
+    SOURCE_DIR "${CMAKE_SOURCE_DIR}"
+    BINARY_DIR "${bin_dir}"
+    CMAKE_ARGS
+      -DCMAKE_BUILD_TYPE=Release
+      -DCMAKE_CXX_COMPILER=${CMAKE_CXX_COMPILER}
+      -DVERILATOR_ROOT=${VERILATOR_ROOT}
+      -DCONTEXT_N=${context_n}
+      -DENTRIES_N=${entries_n}
+      -DALLOW_DUPLICATES=${allow_duplicates}
+      -DENABLE_VCD=OFF
+      ${knob_args}
+      -DCONFIG_MATRIX=
+    BUILD_COMMAND ${CMAKE_COMMAND} --build "${bin_dir}" --target driver
+    BUILD_ALWAYS ON
+    INSTALL_COMMAND ""
+    EXCLUDE_FROM_ALL ON)
+
+  list(APPEND MATRIX_TAGS ${tag})
+  list(APPEND MATRIX_DRIVERS "${bin_dir}/tb/driver")
+  if (NOT knobs)
+    list(APPEND MATRIX_SWEEP_TAGS ${tag})
+    list(APPEND MATRIX_SWEEP_DRIVERS "${bin_dir}/tb/driver")
+  endif ()
+
+  add_test(NAME matrix_${tag}_build
+    COMMAND ${CMAKE_COMMAND} --build "${CMAKE_BINARY_DIR}"
+      --target matrix_${tag})
+  # Sub-builds are driven from this build tree, therefore one at a time.
+  set_tests_properties(matrix_${tag}_build PROPERTIES
+    FIXTURES_SETUP matrix_${tag}
+    RESOURCE_LOCK matrix_build)
+  add_test(NAME matrix_${tag}
+    COMMAND ${CMAKE_CTEST_COMMAND} --test-dir "${bin_dir}"
+      -R "${MATRIX_TESTS_REGEX}" --output-on-failure)
+  set_tests_properties(matrix_${tag} PROPERTIES
+    FIXTURES_REQUIRED matrix_${tag})
+endforeach ()
+
+set(MATRIX_TARGETS)
+foreach (tag ${MATRIX_TAGS})
+  list(APPEND MATRIX_TARGETS matrix_${tag})
+endforeach ()
+
+add_custom_target(matrix DEPENDS ${MATRIX_TARGETS})
+
+string(REPLACE ";" "," MATRIX_SWEEP_TAGS_STR "${MATRIX_SWEEP_TAGS}")
+string(REPLACE ";" "," MATRIX_SWEEP_DRIVERS_STR "${MATRIX_SWEEP_DRIVERS}")
+add_custom_target(sweep
+  COMMAND ${CMAKE_COMMAND}
+    -DTAGS=${MATRIX_SWEEP_TAGS_STR}
+    -DDRIVERS=${MATRIX_SWEEP_DRIVERS_STR}
+    -DWORKLOAD=${SWEEP_WORKLOAD}
+    -DN=${SWEEP_N}
+    -DOUT_DIR=${CMAKE_BINARY_DIR}/sweep
+    -DGNUPLOT=${GNUPLOT_EXE}
+    -P ${CMAKE_SOURCE_DIR}/cmake/sweep.cmake
+  DEPENDS matrix
+  COMMENT "Running configuration sweep...")
+
+# 'matrix_synth' runs 'synth' in every configuration and collates the reports
+# (synth.json).
+set(MATRIX_SYNTH_COMMANDS)
+set(MATRIX_SYNTH_REPORTS)
+foreach (tag ${MATRIX_TAGS})
+  set(bin_dir "${CMAKE_BINARY_DIR}/matrix/${tag}")
+  list(APPEND MATRIX_SYNTH_COMMANDS
+    COMMAND ${CMAKE_COMMAND} --build "${bin_dir}" --target synth)
+  list(APPEND MATRIX_SYNTH_REPORTS "${bin_dir}/tb/synth/synth.json")
+endforeach ()
+string(REPLACE ";" "," MATRIX_SYNTH_REPORTS_STR "${MATRIX_SYNTH_REPORTS}")
+add_custom_target(matrix_synth
+  ${MATRIX_SYNTH_COMMANDS}
+  COMMAND ${CMAKE_COMMAND}
+    -DCOLLATE=${MATRIX_SYNTH_REPORTS_STR}
+    -DOUT=${CMAKE_BINARY_DIR}/synth.json
+    -P ${CMAKE_SOURCE_DIR}/cmake/synth.cmake
+  DEPENDS matrix
+  COMMENT "Synthesizing configuration matrix...")
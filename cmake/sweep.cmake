@@ -0,0 +1,157 @@
+##========================================================================== //
+## Copyright (c) 2022, Stephen Henry
+## All rights reserved.
+##
+## Redistribution and use in source and binary forms, with or without
+## modification, are permitted provided that the following conditions are met:
+##
+## * Redistributions of source code must retain the above copyright notice, this
+##   list of conditions and the following disclaimer.
+##
+## * Redistributions in binary form must reproduce the above copyright notice,
+##   this list of conditions and the following disclaimer in the documentation
+##   and/or other materials provided with the distribution.
+##
+## THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+## AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+## IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+## ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+## LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+## CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+## SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+## INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+## CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+## ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+## POSSIBILITY OF SUCH DAMAGE.
+##========================================================================== //
+
+# Configuration sweep (run in script mode: cmake -P).
+#
+#   TAGS      Comma-separated configuration tags (<C>x<E>x<D>).
+#   DRIVERS   Comma-separated driver executables, in the order of TAGS.
+#   WORKLOAD  Bench workload.
+#   N         Measured cycles per configuration.
+#   OUT_DIR   Directory to which results are written.
+#   GNUPLOT   (Optional) gnuplot executable; plots are emitted where present.
+#
+# Emits OUT_DIR/sweep.csv (one row per configuration, ordered by CONTEXT_N
+# then ENTRIES_N) and, where gnuplot is present, OUT_DIR/sweep.png: simulator
+# cycles/s and model cost (ns/cycle) against ENTRIES_N and CONTEXT_N, and the
+# initialization time (cycles) and state footprint (bits) against CONTEXT_N.
+
+cmake_minimum_required(VERSION 3.20)
+
+string(REPLACE "," ";" TAGS "${TAGS}")
+string(REPLACE "," ";" DRIVERS "${DRIVERS}")
+file(MAKE_DIRECTORY "${OUT_DIR}")
+
+set(rows)
+set(contexts)
+set(entries)
+set(dups)
+list(LENGTH TAGS tags_n)
+math(EXPR last "${tags_n} - 1")
+foreach (i RANGE ${last})
+  list(GET TAGS ${i} tag)
+  list(GET DRIVERS ${i} driver)
+  set(fn "${OUT_DIR}/${tag}.json")
+
+  message(STATUS "Sweep: ${tag}")
+  execute_process(
+    COMMAND "${driver}" --run Bench -a workload=${WORKLOAD} -a n=${N}
+      -a profile=1 -a out=${fn}
+    RESULT_VARIABLE rc
+    OUTPUT_QUIET)
+  if (NOT rc EQUAL 0)
+    message(FATAL_ERROR "Sweep failed on configuration ${tag}")
+  endif ()
+
+  file(READ "${fn}" r)
+  string(JSON c GET "${r}" context_n)
+  string(JSON e GET "${r}" entries_n)
+  string(JSON cps GET "${r}" cycles_per_s)
+  string(JSON npc GET "${r}" ns_per_command)
+  string(JSON mpc GET "${r}" model_ns_per_cycle)
+  string(JSON ic GET "${r}" init_cycles)
+  string(JSON mb GET "${r}" memory_bits)
+  string(REGEX REPLACE ".*x" "" d "${tag}")
+
+  # Zero-padded sort key: CONTEXT_N, ENTRIES_N, ALLOW_DUPLICATES.
+  string(LENGTH "${c}" cl)
+  string(LENGTH "${e}" el)
+  math(EXPR cp "8 - ${cl}")
+  math(EXPR ep "8 - ${el}")
+  string(REPEAT "0" ${cp} cz)
+  string(REPEAT "0" ${ep} ez)
+  list(APPEND rows "${cz}${c}${ez}${e}${d}|${c},${e},${d},${cps},${npc},${mpc},${ic},${mb}")
+  list(APPEND contexts ${c})
+  list(APPEND entries ${e})
+  list(APPEND dups ${d})
+endforeach ()
+
+list(SORT rows)
+list(REMOVE_DUPLICATES contexts)
+list(REMOVE_DUPLICATES entries)
+list(REMOVE_DUPLICATES dups)
+list(SORT contexts COMPARE NATURAL)
+list(SORT entries COMPARE NATURAL)
+
+set(csv "context_n,entries_n,allow_duplicates,cycles_per_s,ns_per_command,model_ns_per_cycle,init_cycles,memory_bits\n")
+foreach (row ${rows})
+  string(REGEX REPLACE "^[^|]*\\|" "" row "${row}")
+  string(APPEND csv "${row}\n")
+endforeach ()
+file(WRITE "${OUT_DIR}/sweep.csv" "${csv}")
+message(STATUS "Sweep results: ${OUT_DIR}/sweep.csv")
+
+if (NOT GNUPLOT)
+  message(STATUS "gnuplot not found; plots are not emitted.")
+  return ()
+endif ()
+
+string(REPLACE ";" " " contexts "${contexts}")
+string(REPLACE ";" " " entries "${entries}")
+string(REPLACE ";" " " dups "${dups}")
+file(WRITE "${OUT_DIR}/sweep.gp" "\
+set datafile separator ','
+set terminal pngcairo size 1200,1350
+set output '${OUT_DIR}/sweep.png'
+set multiplot layout 3,2 title 'Workload: ${WORKLOAD} (${N} cycles)'
+set key top right
+set grid
+f = '${OUT_DIR}/sweep.csv'
+set xlabel 'ENTRIES_N'
+set ylabel 'cycles/s'
+plot for [c in '${contexts}'] for [d in '${dups}'] f skip 1 \
+  using 2:(($1 == c + 0 && $3 == d + 0) ? $4 : 1/0) \
+  with linespoints title sprintf('C=%s D=%s', c, d)
+set ylabel 'model ns/cycle'
+plot for [c in '${contexts}'] for [d in '${dups}'] f skip 1 \
+  using 2:(($1 == c + 0 && $3 == d + 0) ? $6 : 1/0) \
+  with linespoints title sprintf('C=%s D=%s', c, d)
+set xlabel 'CONTEXT_N'
+set ylabel 'cycles/s'
+plot for [e in '${entries}'] for [d in '${dups}'] f skip 1 \
+  using 1:(($2 == e + 0 && $3 == d + 0) ? $4 : 1/0) \
+  with linespoints title sprintf('E=%s D=%s', e, d)
+set ylabel 'model ns/cycle'
+plot for [e in '${entries}'] for [d in '${dups}'] f skip 1 \
+  using 1:(($2 == e + 0 && $3 == d + 0) ? $6 : 1/0) \
+  with linespoints title sprintf('E=%s D=%s', e, d)
+set ylabel 'init cycles'
+plot for [e in '${entries}'] for [d in '${dups}'] f skip 1 \
+  using 1:(($2 == e + 0 && $3 == d + 0) ? $7 : 1/0) \
+  with linespoints title sprintf('E=%s D=%s', e, d)
+set ylabel 'state bits'
+plot for [e in '${entries}'] for [d in '${dups}'] f skip 1 \
+  using 1:(($2 == e + 0 && $3 == d + 0) ? $8 : 1/0) \
+  with linespoints title sprintf('E=%s D=%s', e, d)
+unset multiplot
+")
+execute_process(
+  COMMAND "${GNUPLOT}" "${OUT_DIR}/sweep.gp"
+  RESULT_VARIABLE rc)
+if (NOT rc EQUAL 0)
+  message(FATAL_ERROR "gnuplot failed")
+endif ()
+message(STATUS "Sweep plot: ${OUT_DIR}/sweep.png")
@@ -0,0 +1,188 @@
+##========================================================================== //
+## Copyright (c) 2022, Stephen Henry
+## All rights reserved.
+##
+## Redistribution and use in source and binary forms, with or without
+## modification, are permitted provided that the following conditions are met:
+##
+## * Redistributions of source code must retain the above copyright notice, this
+##   list of conditions and the following disclaimer.
+##
+## * Redistributions in binary form must reproduce the above copyright notice,
+##   this list of conditions and the following disclaimer in the documentation
+##   and/or other materials provided with the distribution.
+##
+## THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+## AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+## IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+## ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+## LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+## CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+## SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+## INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+## CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+## ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+## POSSIBILITY OF SUCH DAMAGE.
+##========================================================================== //
+
+# Logic-depth and area report (run in script mode: cmake -P).
+#
+#   SV2V       sv2v executable (SystemVerilog to Verilog-2005).
+#   YOSYS      yosys executable.
+#   SOURCES    Comma-separated RTL sources.
+#   INCLUDES   Comma-separated include paths (including that of the generated
+#              cfg_pkg.vh).
+#   MODULES    Comma-separated modules to be reported, each synthesized
+#              independently as top.
+#   LUT_K      LUT size targeted by technology mapping.
+#   OUT_DIR    Directory to which results are written.
+#   CONFIG     Configuration, as "CONTEXT_N,ENTRIES_N,ALLOW_DUPLICATES".
+#
+# or, to collate the reports of several configurations:
+#
+#   COLLATE    Comma-separated per-configuration reports.
+#   OUT        Collated report.
+#
+# Each module is synthesized (flattened) by the generic Yosys flow and mapped
+# onto LUT_K-input LUTs. Memories are not mapped, as they would be inferred as
+# BRAM by a vendor flow; they bound timing paths as do flops, and their bits
+# are counted before memory inference. Reported per module are: logic levels
+# (LUTs) on the longest register-to-register path, LUT, FF and total cell
+# counts, and BRAM bits.
+
+cmake_minimum_required(VERSION 3.20)
+
+if (COLLATE)
+  string(REPLACE "," ";" COLLATE "${COLLATE}")
+  set(r "{\"configurations\": []}")
+  set(i 0)
+  foreach (fn ${COLLATE})
+    file(READ "${fn}" c)
+    string(JSON r SET "${r}" configurations ${i} "${c}")
+    math(EXPR i "${i} + 1")
+  endforeach ()
+  file(WRITE "${OUT}" "${r}\n")
+  message(STATUS "Synthesis report: ${OUT}")
+  return ()
+endif ()
+
+string(REPLACE "," ";" SOURCES "${SOURCES}")
+string(REPLACE "," ";" INCLUDES "${INCLUDES}")
+string(REPLACE "," ";" MODULES "${MODULES}")
+string(REPLACE "," ";" CONFIG "${CONFIG}")
+list(GET CONFIG 0 context_n)
+list(GET CONFIG 1 entries_n)
+list(GET CONFIG 2 allow_duplicates)
+file(MAKE_DIRECTORY "${OUT_DIR}")
+
+# Yosys' SystemVerilog frontend does not support packages, structs and
+# interfaces as used by the RTL, therefore convert to Verilog-2005 first.
+set(sv2v_args)
+foreach (inc ${INCLUDES})
+  list(APPEND sv2v_args "-I${inc}")
+endforeach ()
+set(v_fn "${OUT_DIR}/v.v")
+execute_process(
+  COMMAND "${SV2V}" ${sv2v_args} ${SOURCES}
+  OUTPUT_FILE "${v_fn}"
+  RESULT_VARIABLE rc)
+if (NOT rc EQUAL 0)
+  message(FATAL_ERROR "sv2v failed")
+endif ()
+
+# Returns (in 'out') the statistics of 'module' from a 'stat -json' report.
+function (module_stat fn module out)
+  file(READ "${fn}" s)
+  string(JSON s GET "${s}" modules)
+  string(JSON n LENGTH "${s}")
+  math(EXPR last "${n} - 1")
+  foreach (i RANGE ${last})
+    string(JSON name MEMBER "${s}" ${i})
+    if (name MATCHES "^\\\\?${module}$")
+      string(JSON m GET "${s}" "${name}")
+      set(${out} "${m}" PARENT_SCOPE)
+      return ()
+    endif ()
+  endforeach ()
+  message(FATAL_ERROR "Module ${module} not found in ${fn}")
+endfunction ()
+
+set(r "{\"modules\": {}}")
+string(JSON r SET "${r}" context_n ${context_n})
+string(JSON r SET "${r}" entries_n ${entries_n})
+string(JSON r SET "${r}" allow_duplicates ${allow_duplicates})
+string(JSON r SET "${r}" lut_k ${LUT_K})
+
+foreach (m ${MODULES})
+  message(STATUS "Synthesizing: ${m}")
+  set(pfx "${OUT_DIR}/${m}")
+  file(WRITE "${pfx}.ys" "\
+read_verilog ${v_fn}
+hierarchy -check -top ${m}
+proc
+flatten
+tee -q -o ${pfx}.mem.json stat -json
+design -reset
+read_verilog ${v_fn}
+synth -flatten -top ${m} -run :fine
+opt -fast -full
+techmap
+opt -fast
+abc -lut ${LUT_K}
+opt -fast
+tee -q -o ${pfx}.stat.json stat -json
+tee -q -o ${pfx}.ltp.log ltp -noff
+")
+  execute_process(
+    COMMAND "${YOSYS}" -q -l "${pfx}.log" -s "${pfx}.ys"
+    RESULT_VARIABLE rc
+    OUTPUT_QUIET)
+  if (NOT rc EQUAL 0)
+    message(FATAL_ERROR "yosys failed on ${m} (see ${pfx}.log)")
+  endif ()
+
+  module_stat("${pfx}.mem.json" ${m} mem)
+  string(JSON bram_bits ERROR_VARIABLE err GET "${mem}" num_memory_bits)
+  if (err)
+    set(bram_bits 0)
+  endif ()
+
+  module_stat("${pfx}.stat.json" ${m} stat)
+  string(JSON cells GET "${stat}" num_cells)
+  string(JSON types GET "${stat}" num_cells_by_type)
+  string(JSON types_n LENGTH "${types}")
+  set(luts 0)
+  set(ffs 0)
+  if (types_n GREATER 0)
+    math(EXPR last "${types_n} - 1")
+    foreach (i RANGE ${last})
+      string(JSON t MEMBER "${types}" ${i})
+      string(JSON t_n GET "${types}" "${t}")
+      if (t STREQUAL "$lut")
+        math(EXPR luts "${luts} + ${t_n}")
+      elseif (t MATCHES "DFF")
+        math(EXPR ffs "${ffs} + ${t_n}")
+      endif ()
+    endforeach ()
+  endif ()
+
+  file(READ "${pfx}.ltp.log" ltp)
+  if (ltp MATCHES "length=([0-9]+)")
+    set(levels ${CMAKE_MATCH_1})
+  else ()
+    set(levels 0)
+  endif ()
+
+  set(e "{}")
+  string(JSON e SET "${e}" logic_levels ${levels})
+  string(JSON e SET "${e}" luts ${luts})
+  string(JSON e SET "${e}" ffs ${ffs})
+  string(JSON e SET "${e}" cells ${cells})
+  string(JSON e SET "${e}" bram_bits ${bram_bits})
+  string(JSON r SET "${r}" modules ${m} "${e}")
+  message(STATUS
+    "  ${m}: levels=${levels} luts=${luts} ffs=${ffs} bram_bits=${bram_bits}")
+endforeach ()
+
+file(WRITE "${OUT_DIR}/synth.json" "${r}\n")
+message(STATUS "Synthesis report: ${OUT_DIR}/synth.json")
@@ -34,6 +34,7 @@ set(LIB_SOURCES
   "${LIB_ROOT}/dffen.sv"
   "${LIB_ROOT}/dffr.sv"
   "${LIB_ROOT}/pd/${TARGET}/sram1r1w.sv"
+  "${LIB_ROOT}/pd/${TARGET}/tag1r1w.sv"
   )
 
 set(LIB_INCLUDE_PATHS
@@ -77,4 +77,25 @@ always_ff @(posedge clk)
   if (i_wen)
     mem_r [i_waddr] <= i_wdata;
 
+`ifdef VERILATOR
+// ========================================================================== //
+//                                                                            //
+//  Backdoor                                                                  //
+//                                                                            //
+// ========================================================================== //
+
+// Testbench backdoor write of 32b word 'i' at location 'addr' (bits beyond
+// W are discarded). Called from C++ outside of evaluation, with the scope set
+// to the instance to be written.
+export "DPI-C" function sram1r1w_backdoor_write;
+
+function automatic void sram1r1w_backdoor_write(
+  input int addr, input int i, input int unsigned data);
+  for (int b = 0; b < 32; b++) begin
+    if ((i * 32 + b) < W)
+      mem_r [addr[$clog2(N) - 1:0]][i * 32 + b] = data[b];
+  end
+endfunction
+`endif
+
 endmodule // sram1r1w
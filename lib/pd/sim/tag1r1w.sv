@@ -0,0 +1,150 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+`include "common_defs.vh"
+
+// Single-bit table with one (registered) read port, one write port, and a
+// synchronous flash-clear of all locations.
+//
+// Tags are packed W to a word and retained in RAM, with a per-word valid bit
+// held in flops. A clear resets the valid bits alone; a word whose valid bit
+// is clear reads as zero, irrespective of its contents, and is rewritten in
+// full (the addressed tag alone set) by the next write to it. Otherwise, a
+// write updates the addressed tag alone (by bit-enable). Flops, and the fan-in
+// of their read muxes, therefore scale with N / W rather than N.
+
+module tag1r1w #(
+
+// -------------------------------------------------------------------------- //
+// Word count
+  parameter int N
+
+// -------------------------------------------------------------------------- //
+// Tags per RAM word (a power of two)
+, parameter int W = 64
+) (
+// -------------------------------------------------------------------------- //
+// Read Interface
+  input                                           i_ren
+, input [$clog2(N) - 1:0]                         i_raddr
+//
+, output logic                                    o_rdata
+
+// -------------------------------------------------------------------------- //
+// Write Interface
+, input                                          i_wen
+, input [$clog2(N) - 1:0]                        i_waddr
+, input logic                                    i_wdata
+
+// -------------------------------------------------------------------------- //
+// Clear Interface (takes precedence over write)
+, input                                          i_clr
+
+// -------------------------------------------------------------------------- //
+// Clk/Reset
+, input                                           clk
+);
+
+// ========================================================================== //
+//                                                                            //
+//  Wires                                                                     //
+//                                                                            //
+// ========================================================================== //
+
+localparam int NW = (N + W - 1) / W;
+localparam int WORD_BITS = (NW > 1) ? $clog2(NW) : 1;
+
+typedef logic [WORD_BITS - 1:0]                  word_t;
+typedef logic [$clog2(W) - 1:0]                  bit_t;
+
+word_t                                           raddr_word;
+bit_t                                            raddr_bit;
+word_t                                           waddr_word;
+bit_t                                            waddr_bit;
+
+logic [W - 1:0]                                  mem_r [NW - 1:0];
+logic [NW - 1:0]                                 mem_vld_r;
+
+logic [W - 1:0]                                  rdata_word_r;
+logic                                            rdata_vld_r;
+bit_t                                            rdata_bit_r;
+
+// ========================================================================== //
+//                                                                            //
+//  Flops                                                                     //
+//                                                                            //
+// ========================================================================== //
+
+assign raddr_word = word_t'(int'(i_raddr) / W);
+assign raddr_bit = bit_t'(int'(i_raddr) % W);
+assign waddr_word = word_t'(int'(i_waddr) / W);
+assign waddr_bit = bit_t'(int'(i_waddr) % W);
+
+always_ff @(posedge clk)
+  if (i_ren) begin
+    rdata_word_r <= mem_r [raddr_word];
+    rdata_vld_r <= mem_vld_r [raddr_word];
+    rdata_bit_r <= raddr_bit;
+  end
+
+assign o_rdata = rdata_vld_r & rdata_word_r [rdata_bit_r];
+
+always_ff @(posedge clk)
+  if (i_clr)
+    mem_vld_r <= '0;
+  else if (i_wen)
+    mem_vld_r [waddr_word] <= 1'b1;
+
+always_ff @(posedge clk)
+  if (i_wen & (~i_clr)) begin
+    if (mem_vld_r [waddr_word])
+      mem_r [waddr_word][waddr_bit] <= i_wdata;
+    else
+      mem_r [waddr_word] <= W'(i_wdata) << waddr_bit;
+  end
+
+`ifdef VERILATOR
+// ========================================================================== //
+//                                                                            //
+//  Backdoor                                                                  //
+//                                                                            //
+// ========================================================================== //
+
+// Testbench backdoor write of 'data' at location 'addr'. Called from C++
+// outside of evaluation, with the scope set to the instance to be written.
+export "DPI-C" function tag1r1w_backdoor_write;
+
+function automatic void tag1r1w_backdoor_write(input int addr, input bit data);
+  if (!mem_vld_r [word_t'(addr / W)]) begin
+    mem_r [word_t'(addr / W)] = '0;
+    mem_vld_r [word_t'(addr / W)] = 1'b1;
+  end
+  mem_r [word_t'(addr / W)][bit_t'(addr % W)] = data;
+endfunction
+`endif
+
+endmodule // tag1r1w
@@ -29,14 +29,92 @@
 # RTL Parameterizations
 
 # The number of supported contexts
-set(CONTEXT_N 10)
+set(CONTEXT_N 10 CACHE STRING "The number of supported contexts.")
 
 # The number of unique entries per context
-set(ENTRIES_N 10)
+set(ENTRIES_N 10 CACHE STRING "The number of unique entries per context.")
+
+# The number of entries per block in the hierarchical organisation of a
+# Context (for deep Contexts). Entries are retained in sorted, packed blocks,
+# each block being indexed by its tail key. Equal to ENTRIES_N (the default),
+# the Context is organised as a single (flat) block.
+set(ENTRIES_BLOCK_N ${ENTRIES_N} CACHE STRING
+  "The number of entries per block (ENTRIES_N selects a flat context).")
+if (NOT ENTRIES_BLOCK_N EQUAL ENTRIES_N)
+  math(EXPR ENTRIES_BLOCK_N_REM "${ENTRIES_N} % ${ENTRIES_BLOCK_N}")
+  math(EXPR ENTRIES_BLOCK_N_POW2 "${ENTRIES_BLOCK_N} & (${ENTRIES_BLOCK_N} - 1)")
+  if ((ENTRIES_BLOCK_N LESS 2) OR (NOT ENTRIES_BLOCK_N_REM EQUAL 0) OR
+      (NOT ENTRIES_BLOCK_N_POW2 EQUAL 0))
+    message(FATAL_ERROR
+      "ENTRIES_BLOCK_N must be a power of two (>= 2) dividing ENTRIES_N.")
+  endif ()
+endif ()
+
+# The number of Update ports (1, 2 or 4). Contexts are partitioned over as many
+# banks, each with its own Update pipeline and state tables.
+set(UPDATE_PORTS_N 1 CACHE STRING "The number of update ports (1, 2 or 4).")
+if (NOT UPDATE_PORTS_N MATCHES "^(1|2|4)$")
+  message(FATAL_ERROR "UPDATE_PORTS_N must be one of 1, 2 or 4.")
+endif ()
+math(EXPR UPDATE_PORTS_CONTEXT_N_MIN "2 * ${UPDATE_PORTS_N}")
+if (CONTEXT_N LESS UPDATE_PORTS_CONTEXT_N_MIN)
+  message(FATAL_ERROR
+    "CONTEXT_N must be at least ${UPDATE_PORTS_CONTEXT_N_MIN} "
+    "(two Contexts per bank).")
+endif ()
+math(EXPR UPDATE_PORTS_CONTEXT_N_REM "${CONTEXT_N} % ${UPDATE_PORTS_N}")
+if (NOT UPDATE_PORTS_CONTEXT_N_REM EQUAL 0)
+  message(FATAL_ERROR
+    "CONTEXT_N must be a multiple of UPDATE_PORTS_N (equally sized banks).")
+endif ()
+
+# The number of Query (lookup) ports. Each port retains its own Query pipeline
+# and replica of the state tables.
+set(QUERY_PORTS_N 1 CACHE STRING "The number of query ports (1 to 4).")
+if (NOT QUERY_PORTS_N MATCHES "^[1-4]$")
+  message(FATAL_ERROR "QUERY_PORTS_N must be in the range 1 to 4.")
+endif ()
+
+# The number of levels (from the head) returned by a snapshot Query.
+if (ENTRIES_N LESS 4)
+  set(SNAPSHOT_K_DEFAULT ${ENTRIES_N})
+else ()
+  set(SNAPSHOT_K_DEFAULT 4)
+endif ()
+set(SNAPSHOT_K ${SNAPSHOT_K_DEFAULT} CACHE STRING
+  "The number of levels returned by a snapshot query.")
+if ((SNAPSHOT_K LESS 1) OR (SNAPSHOT_K GREATER ENTRIES_N))
+  message(FATAL_ERROR "SNAPSHOT_K must be in the range 1 to ENTRIES_N.")
+endif ()
+
+# The depth of the (per bank) coalescing Notify queue, in Contexts. Each
+# Context occupies at most one slot, therefore a queue of at least
+# CONTEXT_N / UPDATE_PORTS_N slots cannot overflow.
+set(NOTIFY_QUEUE_N 8 CACHE STRING
+  "The depth of the coalescing notify queue (a power of two).")
+math(EXPR NOTIFY_QUEUE_N_POW2 "${NOTIFY_QUEUE_N} & (${NOTIFY_QUEUE_N} - 1)")
+if ((NOTIFY_QUEUE_N LESS 2) OR (NOT NOTIFY_QUEUE_N_POW2 EQUAL 0))
+  message(FATAL_ERROR "NOTIFY_QUEUE_N must be a power of two (>= 2).")
+endif ()
+
+# Key and volume widths; shared by the RTL (cfg_pkg) and testbench (cfg.h), from
+# which all other field widths (cumulative volume, list size and state) are
+# derived.
+set(KEY_BITS 64)
+set(VOLUME_BITS 32)
 
 # Allow duplicate keys within a given context.
 declare_flag_option(ALLOW_DUPLICATES "Allow duplicate keys." ON)
 
+# Resolve Queries against in-flight Updates by forwarding, rather than
+# returning an error.
+declare_flag_option(QUERY_FORWARD "Forward in-flight updates to queries." OFF)
+
+# Forward state fully around the Update pipeline, such that Updates to the same
+# Context may be issued on every cycle.
+declare_flag_option(UPDATE_FULL_FORWARD
+  "Forward update state fully (back-to-back same-context updates)." OFF)
+
 # ---------------------------------------------------------------------------- #
 # Sources
 set(RTL_ROOT "${CMAKE_SOURCE_DIR}/rtl")
@@ -49,11 +127,13 @@ set(RTL_SOURCES
   "${RTL_ROOT}/common/cmp.sv"
   "${RTL_ROOT}/common/dec.sv"
   "${RTL_ROOT}/common/mux.sv"
+  "${RTL_ROOT}/v_pipe_update_idx.sv"
   "${RTL_ROOT}/v_pipe_update_cmp.sv"
   "${RTL_ROOT}/v_pipe_update_exe.sv"
   "${RTL_ROOT}/v_pipe_update.sv"
   "${RTL_ROOT}/v_pipe_query.sv"
-  "${RTL_ROOT}/v_init.sv"
+  "${RTL_ROOT}/v_state_table.sv"
+  "${RTL_ROOT}/v_notify.sv"
   "${RTL_ROOT}/v.sv"
   )
 
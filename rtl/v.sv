@@ -33,31 +33,90 @@
 module v (
 
 // -------------------------------------------------------------------------- //
-// List Update Bus
-  input                                           i_upd_vld
-, input v_pkg::id_t                               i_upd_prod_id
-, input v_pkg::cmd_t                              i_upd_cmd
-, input v_pkg::key_t                              i_upd_key
-, input v_pkg::size_t                             i_upd_size
+// List Update Bus (per port)
+  input [cfg_pkg::UPDATE_PORTS_N - 1:0]           i_upd_vld
+, input v_pkg::id_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_prod_id
+, input v_pkg::cmd_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_cmd
+, input v_pkg::key_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_key
+, input v_pkg::size_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_size
 
 // -------------------------------------------------------------------------- //
-// List Query Bus
-, input                                           i_lut_vld
-, input v_pkg::id_t                               i_lut_prod_id
-, input v_pkg::level_t                            i_lut_level
+// List Query Bus (per port)
+, input [cfg_pkg::QUERY_PORTS_N - 1:0]            i_lut_vld
+, input v_pkg::id_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_prod_id
+, input v_pkg::level_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_level
+, input [cfg_pkg::QUERY_PORTS_N - 1:0]            i_lut_snap
+, input [cfg_pkg::QUERY_PORTS_N - 1:0]            i_lut_cum
+, input [cfg_pkg::QUERY_PORTS_N - 1:0]            i_lut_rev
+, input v_pkg::key_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_key
 //
-, output logic                                    o_lut_vld_r
-, output v_pkg::key_t                             o_lut_key
-, output v_pkg::size_t                            o_lut_size
-, output logic                                    o_lut_error
-, output v_pkg::listsize_t                        o_lut_listsize
+, output logic [cfg_pkg::QUERY_PORTS_N - 1:0]     o_lut_vld_r
+, output v_pkg::key_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_key
+, output v_pkg::size_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_size
+, output logic [cfg_pkg::QUERY_PORTS_N - 1:0]     o_lut_error
+, output v_pkg::listsize_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_listsize
+//
+, output logic [cfg_pkg::QUERY_PORTS_N - 1:0]     o_lut_snap_r
+, output v_pkg::snap_vld_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_snap_vld
+, output v_pkg::snap_key_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_snap_key
+, output v_pkg::snap_volume_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_snap_size
+//
+, output logic [cfg_pkg::QUERY_PORTS_N - 1:0]     o_lut_cum_r
+, output v_pkg::cum_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_cum
+//
+, output logic [cfg_pkg::QUERY_PORTS_N - 1:0]     o_lut_rev_vld_r
+, output logic [cfg_pkg::QUERY_PORTS_N - 1:0]     o_lut_rev_hit
+, output v_pkg::level_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_rev_level
+, output v_pkg::size_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_rev_size
+, output v_pkg::listsize_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_rev_better
+, output logic [cfg_pkg::QUERY_PORTS_N - 1:0]     o_lut_rev_error
 
 // -------------------------------------------------------------------------- //
-// Notify Bus
-, output logic                                    o_lv0_vld_r
-, output v_pkg::id_t                              o_lv0_prod_id_r
-, output v_pkg::key_t                             o_lv0_key_r
-, output v_pkg::size_t                            o_lv0_size_r
+// Notify Bus (per bank)
+, output logic [cfg_pkg::UPDATE_PORTS_N - 1:0]    o_lv0_vld_r
+, output v_pkg::id_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_lv0_prod_id_r
+, output v_pkg::key_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_lv0_key_r
+, output v_pkg::size_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_lv0_size_r
+
+// -------------------------------------------------------------------------- //
+// Notify Subscription
+, input                                           i_sub_vld
+, input v_pkg::id_t                               i_sub_prod_id
+, input                                           i_sub_en
+
+// -------------------------------------------------------------------------- //
+// Coalesced Notify Egress (per bank)
+, output logic [cfg_pkg::UPDATE_PORTS_N - 1:0]    o_nfy_vld_r
+, output v_pkg::id_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_nfy_prod_id_r
+, output v_pkg::key_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_nfy_key
+, output v_pkg::size_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_nfy_size
+, input [cfg_pkg::UPDATE_PORTS_N - 1:0]           i_nfy_ready
+//
+, output logic [cfg_pkg::UPDATE_PORTS_N - 1:0][31:0]
+                                                  o_nfy_overflow_r
 
 // -------------------------------------------------------------------------- //
 // Status
@@ -69,6 +128,18 @@ module v (
 , input                                           arst_n
 );
 
+localparam int P = cfg_pkg::UPDATE_PORTS_N;
+localparam int Q = cfg_pkg::QUERY_PORTS_N;
+
+// Update command, as steered from port to bank.
+typedef struct packed {
+  v_pkg::id_t prod_id;
+  v_pkg::cmd_t cmd;
+  v_pkg::key_t key;
+  v_pkg::size_t size;
+} upd_t;
+localparam int UPD_BITS = $bits(upd_t);
+
 // ========================================================================== //
 //                                                                            //
 //  Wires                                                                     //
@@ -76,37 +147,44 @@ module v (
 // ========================================================================== //
 
 //
-logic                                   update_ren;
-v_pkg::addr_t                           update_raddr;
-v_pkg::state_t                          update_rdata;
+upd_t [P - 1:0]                         upd_port;
+v_pkg::bank_t [P - 1:0]                 upd_port_bank;
+logic [P - 1:0][P - 1:0]                upd_bank_sel;
+logic [P - 1:0]                         upd_bank_vld;
+upd_t [P - 1:0]                         upd_bank;
+//
+logic [P - 1:0]                         update_ren;
+v_pkg::addr_t [P - 1:0]                 update_raddr;
+v_pkg::state_t [P - 1:0]                update_rdata;
 //
-logic                                   query_ren;
-v_pkg::addr_t                           query_raddr;
-v_pkg::state_t                          query_rdata;
+logic [Q - 1:0]                         query_ren;
+v_pkg::addr_t [Q - 1:0]                 query_raddr;
+v_pkg::bank_t [Q - 1:0]                 query_bank;
 //
-logic                                   init_wen_r;
-v_pkg::addr_t                           init_waddr_r;
-v_pkg::state_t                          init_wdata_r;
+v_pkg::bank_t                           sub_bank;
+v_pkg::state_t [Q - 1:0][P - 1:0]       query_rdata;
 //
-logic                                   state_wen_r;
-v_pkg::addr_t                           state_waddr_r;
-v_pkg::state_t                          state_wdata_r;
+logic [P - 1:0]                         state_wen_r;
+v_pkg::addr_t [P - 1:0]                 state_waddr_r;
+v_pkg::state_t [P - 1:0]                state_wdata_r;
 //
-logic                                   wen;
-v_pkg::addr_t                           waddr;
-v_pkg::state_t                          wdata;
+logic [P - 1:0]                         wen;
+v_pkg::bank_addr_t [P - 1:0]            waddr;
+v_pkg::state_t [P - 1:0]                wdata;
 
 //
-logic                                   s1_upd_vld_r;
-v_pkg::id_t                             s1_upd_prod_id_r;
-logic                                   s2_upd_vld_r;
-v_pkg::id_t                             s2_upd_prod_id_r;
-logic                                   s3_upd_vld_r;
-v_pkg::id_t                             s3_upd_prod_id_r;
-logic                                   s4_upd_vld_r;
-v_pkg::id_t                             s4_upd_prod_id_r;
-logic                                   s5_upd_vld_r;
-v_pkg::id_t                             s5_upd_prod_id_r;
+logic [P - 1:0]                         s1_upd_vld_r;
+v_pkg::id_t [P - 1:0]                   s1_upd_prod_id_r;
+logic [P - 1:0]                         s2_upd_vld_r;
+v_pkg::id_t [P - 1:0]                   s2_upd_prod_id_r;
+logic [P - 1:0]                         s3_upd_vld_r;
+v_pkg::id_t [P - 1:0]                   s3_upd_prod_id_r;
+logic [P - 1:0]                         s4_upd_vld_r;
+v_pkg::id_t [P - 1:0]                   s4_upd_prod_id_r;
+logic [P - 1:0]                         s5_upd_vld_r;
+v_pkg::id_t [P - 1:0]                   s5_upd_prod_id_r;
+v_pkg::state_t [P - 1:0]                s4_upd_state;
+v_pkg::state_t [P - 1:0]                s5_upd_state_r;
 
 // ========================================================================== //
 //                                                                            //
@@ -115,6 +193,7 @@ v_pkg::id_t                             s5_upd_prod_id_r;
 // ========================================================================== //
 
 `V_DFFR(logic, init, 'b1);
+`V_DFFR(logic, busy, 'b1);
 
 // ========================================================================== //
 //                                                                            //
@@ -128,12 +207,48 @@ v_pkg::id_t                             s5_upd_prod_id_r;
 assign init_w = '0;
 
 // -------------------------------------------------------------------------- //
-// Mux. in BRAM initialization channels when active (otherwise, infer BRAM which
-// are initialized to zero).
+// Initialization clears the tags of all state tables in a single cycle; the
+// machine is busy only for the duration of that cycle.
 //
-assign wen   = o_busy_r ? init_wen_r : state_wen_r;
-assign waddr = o_busy_r ? init_waddr_r : state_waddr_r;
-assign wdata = o_busy_r ? init_wdata_r : state_wdata_r;
+assign busy_w = init_r;
+
+// -------------------------------------------------------------------------- //
+// Steer each Update port to the pipeline of the bank in which its Context
+// resides. Stimulus is constrained such that at most one Update is issued to
+// each bank on any cycle (the bank conflict rule); the selection into each
+// bank is therefore 1-hot (or null).
+//
+for (genvar p = 0; p < P; p++) begin : port_GEN
+
+assign upd_port [p].prod_id = i_upd_prod_id [p];
+assign upd_port [p].cmd = i_upd_cmd [p];
+assign upd_port [p].key = i_upd_key [p];
+assign upd_port [p].size = i_upd_size [p];
+
+assign upd_port_bank [p] =
+    {P{i_upd_vld [p]}} & v_pkg::bank_dec(i_upd_prod_id [p]);
+
+  for (genvar b = 0; b < P; b++) begin : bank_sel_GEN
+
+assign upd_bank_sel [b][p] = upd_port_bank [p][b];
+
+  end // block: bank_sel_GEN
+
+end // block: port_GEN
+
+// -------------------------------------------------------------------------- //
+// Query lookup is issued to the bank in which the Context resides.
+//
+for (genvar q = 0; q < Q; q++) begin : query_bank_GEN
+
+assign query_bank [q] = v_pkg::bank_dec(query_raddr [q]);
+
+end // block: query_bank_GEN
+
+// -------------------------------------------------------------------------- //
+// Subscription is issued to the bank in which the Context resides.
+//
+assign sub_bank = {P{i_sub_vld}} & v_pkg::bank_dec(i_sub_prod_id);
 
 // ========================================================================== //
 //                                                                            //
@@ -141,39 +256,62 @@ assign wdata = o_busy_r ? init_wdata_r : state_wdata_r;
 //                                                                            //
 // ========================================================================== //
 
+for (genvar b = 0; b < P; b++) begin : bank_GEN
+
+// -------------------------------------------------------------------------- //
+//
+assign upd_bank_vld [b] = (|upd_bank_sel [b]);
+
+mux #(.N(P), .W(UPD_BITS)) u_upd_mux (
+  //
+    .i_x                                (upd_port)
+  , .i_sel                              (upd_bank_sel [b])
+  //
+  , .o_y                                (upd_bank [b])
+);
+
+// -------------------------------------------------------------------------- //
+// Writeback to state tables.
+//
+assign wen [b]   = state_wen_r [b];
+assign waddr [b] = v_pkg::bank_addr(state_waddr_r [b]);
+assign wdata [b] = state_wdata_r [b];
+
 // -------------------------------------------------------------------------- //
 //
 v_pipe_update u_v_pipe_update (
   //
-    .i_upd_vld                          (i_upd_vld)
-  , .i_upd_prod_id                      (i_upd_prod_id)
-  , .i_upd_cmd                          (i_upd_cmd)
-  , .i_upd_key                          (i_upd_key)
-  , .i_upd_size                         (i_upd_size)
+    .i_upd_vld                          (upd_bank_vld [b])
+  , .i_upd_prod_id                      (upd_bank [b].prod_id)
+  , .i_upd_cmd                          (upd_bank [b].cmd)
+  , .i_upd_key                          (upd_bank [b].key)
+  , .i_upd_size                         (upd_bank [b].size)
   //
-  , .i_state_rdata                      (update_rdata)
-  , .o_state_ren                        (update_ren)
-  , .o_state_raddr                      (update_raddr)
+  , .i_state_rdata                      (update_rdata [b])
+  , .o_state_ren                        (update_ren [b])
+  , .o_state_raddr                      (update_raddr [b])
   //
-  , .o_state_wen_r                      (state_wen_r)
-  , .o_state_waddr_r                    (state_waddr_r)
-  , .o_state_wdata_r                    (state_wdata_r)
+  , .o_state_wen_r                      (state_wen_r [b])
+  , .o_state_waddr_r                    (state_waddr_r [b])
+  , .o_state_wdata_r                    (state_wdata_r [b])
   //
-  , .o_lv0_vld_r                        (o_lv0_vld_r)
-  , .o_lv0_prod_id_r                    (o_lv0_prod_id_r)
-  , .o_lv0_key_r                        (o_lv0_key_r)
-  , .o_lv0_size_r                       (o_lv0_size_r)
+  , .o_lv0_vld_r                        (o_lv0_vld_r [b])
+  , .o_lv0_prod_id_r                    (o_lv0_prod_id_r [b])
+  , .o_lv0_key_r                        (o_lv0_key_r [b])
+  , .o_lv0_size_r                       (o_lv0_size_r [b])
   //
-  , .o_s1_upd_vld_r                     (s1_upd_vld_r)
-  , .o_s1_upd_prod_id_r                 (s1_upd_prod_id_r)
-  , .o_s2_upd_vld_r                     (s2_upd_vld_r)
-  , .o_s2_upd_prod_id_r                 (s2_upd_prod_id_r)
-  , .o_s3_upd_vld_r                     (s3_upd_vld_r)
-  , .o_s3_upd_prod_id_r                 (s3_upd_prod_id_r)
-  , .o_s4_upd_vld_r                     (s4_upd_vld_r)
-  , .o_s4_upd_prod_id_r                 (s4_upd_prod_id_r)
-  , .o_s5_upd_vld_r                     (s5_upd_vld_r)
-  , .o_s5_upd_prod_id_r                 (s5_upd_prod_id_r)
+  , .o_s1_upd_vld_r                     (s1_upd_vld_r [b])
+  , .o_s1_upd_prod_id_r                 (s1_upd_prod_id_r [b])
+  , .o_s2_upd_vld_r                     (s2_upd_vld_r [b])
+  , .o_s2_upd_prod_id_r                 (s2_upd_prod_id_r [b])
+  , .o_s3_upd_vld_r                     (s3_upd_vld_r [b])
+  , .o_s3_upd_prod_id_r                 (s3_upd_prod_id_r [b])
+  , .o_s4_upd_vld_r                     (s4_upd_vld_r [b])
+  , .o_s4_upd_prod_id_r                 (s4_upd_prod_id_r [b])
+  , .o_s5_upd_vld_r                     (s5_upd_vld_r [b])
+  , .o_s5_upd_prod_id_r                 (s5_upd_prod_id_r [b])
+  , .o_s4_upd_state                     (s4_upd_state [b])
+  , .o_s5_upd_state_r                   (s5_upd_state_r [b])
   //
   , .init_r                             (init_r)
   //
@@ -182,46 +320,41 @@ v_pipe_update u_v_pipe_update (
 
 // -------------------------------------------------------------------------- //
 //
-sram1r1w #(.N(cfg_pkg::CONTEXT_N), .W(v_pkg::STATE_BITS)) u_sram1r1w_update (
+v_state_table u_state_update (
   //
-    .i_ren                              (update_ren)
-  , .i_raddr                            (update_raddr)
-  , .o_rdata                            (update_rdata)
+    .i_ren                              (update_ren [b])
+  , .i_raddr                            (v_pkg::bank_addr(update_raddr [b]))
+  , .o_rdata                            (update_rdata [b])
   //
-  , .i_wen                              (wen)
-  , .i_waddr                            (waddr)
-  , .i_wdata                            (wdata)
+  , .i_wen                              (wen [b])
+  , .i_waddr                            (waddr [b])
+  , .i_wdata                            (wdata [b])
+  //
+  , .init_r                             (init_r)
   //
   , .clk                                (clk)
 );
 
 // -------------------------------------------------------------------------- //
-v_pipe_query u_v_pipe_query (
+//
+v_notify u_v_notify (
   //
-    .i_lut_vld                          (i_lut_vld)
-  , .i_lut_prod_id                      (i_lut_prod_id)
-  , .i_lut_level                        (i_lut_level)
+    .i_lv0_vld_r                        (o_lv0_vld_r [b])
+  , .i_lv0_prod_id_r                    (o_lv0_prod_id_r [b])
+  , .i_lv0_key_r                        (o_lv0_key_r [b])
+  , .i_lv0_size_r                       (o_lv0_size_r [b])
   //
-  , .o_lut_vld_r                        (o_lut_vld_r)
-  , .o_lut_key                          (o_lut_key)
-  , .o_lut_size                         (o_lut_size)
-  , .o_lut_error                        (o_lut_error)
-  , .o_lut_listsize                     (o_lut_listsize)
+  , .i_sub_vld                          (sub_bank [b])
+  , .i_sub_prod_id                      (i_sub_prod_id)
+  , .i_sub_en                           (i_sub_en)
   //
-  , .i_state_rdata                      (query_rdata)
-  , .o_state_ren                        (query_ren)
-  , .o_state_raddr                      (query_raddr)
+  , .o_nfy_vld_r                        (o_nfy_vld_r [b])
+  , .o_nfy_prod_id_r                    (o_nfy_prod_id_r [b])
+  , .o_nfy_key                          (o_nfy_key [b])
+  , .o_nfy_size                         (o_nfy_size [b])
+  , .i_nfy_ready                        (i_nfy_ready [b])
   //
-  , .i_s1_upd_vld_r                     (s1_upd_vld_r)
-  , .i_s1_upd_prod_id_r                 (s1_upd_prod_id_r)
-  , .i_s2_upd_vld_r                     (s2_upd_vld_r)
-  , .i_s2_upd_prod_id_r                 (s2_upd_prod_id_r)
-  , .i_s3_upd_vld_r                     (s3_upd_vld_r)
-  , .i_s3_upd_prod_id_r                 (s3_upd_prod_id_r)
-  , .i_s4_upd_vld_r                     (s4_upd_vld_r)
-  , .i_s4_upd_prod_id_r                 (s4_upd_prod_id_r)
-  , .i_s5_upd_vld_r                     (s5_upd_vld_r)
-  , .i_s5_upd_prod_id_r                 (s5_upd_prod_id_r)
+  , .o_nfy_overflow_r                   (o_nfy_overflow_r [b])
   //
   , .init_r                             (init_r)
   //
@@ -229,33 +362,92 @@ v_pipe_query u_v_pipe_query (
 );
 
 // -------------------------------------------------------------------------- //
+// Each Query port retains its own replica of the state table, each of which
+// receives the same (broadcast) writeback.
 //
-sram1r1w #(.N(cfg_pkg::CONTEXT_N), .W(v_pkg::STATE_BITS)) u_sram1r1w_query (
+  for (genvar q = 0; q < Q; q++) begin : replica_GEN
+
+v_state_table u_state_query (
   //
-    .i_ren                              (query_ren)
-  , .i_raddr                            (query_raddr)
-  , .o_rdata                            (query_rdata)
+    .i_ren                              (query_ren [q] & query_bank [q][b])
+  , .i_raddr                            (v_pkg::bank_addr(query_raddr [q]))
+  , .o_rdata                            (query_rdata [q][b])
   //
-  , .i_wen                              (wen)
-  , .i_waddr                            (waddr)
-  , .i_wdata                            (wdata)
+  , .i_wen                              (wen [b])
+  , .i_waddr                            (waddr [b])
+  , .i_wdata                            (wdata [b])
+  //
+  , .init_r                             (init_r)
   //
   , .clk                                (clk)
 );
 
+  end // block: replica_GEN
+
+end // block: bank_GEN
+
+for (genvar q = 0; q < Q; q++) begin : query_GEN
+
 // -------------------------------------------------------------------------- //
-//
-v_init #(.N(cfg_pkg::CONTEXT_N), .W(v_pkg::STATE_BITS)) u_init (
+v_pipe_query u_v_pipe_query (
+  //
+    .i_lut_vld                          (i_lut_vld [q])
+  , .i_lut_prod_id                      (i_lut_prod_id [q])
+  , .i_lut_level                        (i_lut_level [q])
+  , .i_lut_snap                         (i_lut_snap [q])
+  , .i_lut_cum                          (i_lut_cum [q])
+  , .i_lut_rev                          (i_lut_rev [q])
+  , .i_lut_key                          (i_lut_key [q])
   //
-    .o_init_wen_r                       (init_wen_r)
-  , .o_init_waddr_r                     (init_waddr_r)
-  , .o_init_wdata_r                     (init_wdata_r)
+  , .o_lut_vld_r                        (o_lut_vld_r [q])
+  , .o_lut_key                          (o_lut_key [q])
+  , .o_lut_size                         (o_lut_size [q])
+  , .o_lut_error                        (o_lut_error [q])
+  , .o_lut_listsize                     (o_lut_listsize [q])
   //
-  , .i_init                             (init_r)
+  , .o_lut_snap_r                       (o_lut_snap_r [q])
+  , .o_lut_snap_vld                     (o_lut_snap_vld [q])
+  , .o_lut_snap_key                     (o_lut_snap_key [q])
+  , .o_lut_snap_size                    (o_lut_snap_size [q])
+  , .o_lut_cum_r                        (o_lut_cum_r [q])
+  , .o_lut_cum                          (o_lut_cum [q])
+  , .o_lut_rev_vld_r                    (o_lut_rev_vld_r [q])
+  , .o_lut_rev_hit                      (o_lut_rev_hit [q])
+  , .o_lut_rev_level                    (o_lut_rev_level [q])
+  , .o_lut_rev_size                     (o_lut_rev_size [q])
+  , .o_lut_rev_better                   (o_lut_rev_better [q])
+  , .o_lut_rev_error                    (o_lut_rev_error [q])
   //
-  , .o_busy_r                           (o_busy_r)
+  , .i_state_rdata                      (query_rdata [q])
+  , .o_state_ren                        (query_ren [q])
+  , .o_state_raddr                      (query_raddr [q])
+  //
+  , .i_s1_upd_vld_r                     (s1_upd_vld_r)
+  , .i_s1_upd_prod_id_r                 (s1_upd_prod_id_r)
+  , .i_s2_upd_vld_r                     (s2_upd_vld_r)
+  , .i_s2_upd_prod_id_r                 (s2_upd_prod_id_r)
+  , .i_s3_upd_vld_r                     (s3_upd_vld_r)
+  , .i_s3_upd_prod_id_r                 (s3_upd_prod_id_r)
+  , .i_s4_upd_vld_r                     (s4_upd_vld_r)
+  , .i_s4_upd_prod_id_r                 (s4_upd_prod_id_r)
+  , .i_s5_upd_vld_r                     (s5_upd_vld_r)
+  , .i_s5_upd_prod_id_r                 (s5_upd_prod_id_r)
+  , .i_s4_upd_state                     (s4_upd_state)
+  , .i_s5_upd_state_r                   (s5_upd_state_r)
+  //
+  , .init_r                             (init_r)
   //
   , .clk                                (clk)
 );
 
+end // block: query_GEN
+
+// ========================================================================== //
+//                                                                            //
+//  Outputs                                                                   //
+//                                                                            //
+// ========================================================================== //
+
+assign o_busy_r = busy_r;
+
 endmodule // v
@@ -0,0 +1,288 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+`include "common_defs.vh"
+`include "macros.vh"
+
+`include "v_pkg.vh"
+`include "cfg_pkg.vh"
+
+// Coalescing Notify queue (per bank). Top-of-book notifications of subscribed
+// Contexts are retained until accepted by the downstream consumer (on a
+// valid/ready egress). A Context occupies at most one slot in the queue;
+// subsequent notifications to a Context already queued replace its payload,
+// such that only the latest top-of-book is emitted. A notification which
+// requires a slot, where none is available, is dropped and counted.
+
+module v_notify (
+// -------------------------------------------------------------------------- //
+// Notify Ingress (from Update pipeline)
+  input wire logic                                i_lv0_vld_r
+, input wire v_pkg::id_t                          i_lv0_prod_id_r
+, input wire v_pkg::key_t                         i_lv0_key_r
+, input wire v_pkg::size_t                        i_lv0_size_r
+
+// -------------------------------------------------------------------------- //
+// Subscription Interface
+, input wire logic                                i_sub_vld
+, input wire v_pkg::id_t                          i_sub_prod_id
+, input wire logic                                i_sub_en
+
+// -------------------------------------------------------------------------- //
+// Notify Egress
+, output wire logic                               o_nfy_vld_r
+, output wire v_pkg::id_t                         o_nfy_prod_id_r
+, output wire v_pkg::key_t                        o_nfy_key
+, output wire v_pkg::size_t                       o_nfy_size
+, input wire logic                                i_nfy_ready
+//
+, output wire logic [31:0]                        o_nfy_overflow_r
+
+// -------------------------------------------------------------------------- //
+// Initialization
+, input wire logic                                init_r
+
+// -------------------------------------------------------------------------- //
+// Clk
+, input wire logic                                clk
+);
+
+localparam int N = cfg_pkg::BANK_CONTEXT_N;
+localparam int D = cfg_pkg::NOTIFY_QUEUE_N;
+localparam int PAYLOAD_BITS = $bits(v_pkg::key_t) + $bits(v_pkg::size_t);
+
+typedef logic [$clog2(D) - 1:0]         ptr_t;
+typedef logic [$clog2(D + 1) - 1:0]     cnt_t;
+
+// ========================================================================== //
+//                                                                            //
+//  Wires                                                                     //
+//                                                                            //
+// ========================================================================== //
+
+v_pkg::bank_addr_t                      lv0_addr;
+logic [N - 1:0]                         lv0_sel;
+logic                                   lv0_sub;
+logic                                   lv0_pend;
+logic                                   lv0_acc;
+logic                                   lv0_new;
+//
+v_pkg::bank_addr_t                      sub_addr;
+logic [N - 1:0]                         sub_sel;
+//
+logic                                   queue_empty;
+logic                                   queue_full;
+logic                                   push;
+logic                                   pop;
+logic [D - 1:0]                         push_ptr_sel;
+logic [D - 1:0]                         pop_ptr_sel;
+v_pkg::id_t                             head_prod_id;
+v_pkg::bank_addr_t                      head_addr;
+logic [N - 1:0]                         head_sel;
+logic                                   overflow;
+//
+v_pkg::key_t                            payload_key;
+v_pkg::size_t                           payload_size;
+
+// ========================================================================== //
+//                                                                            //
+//  Flops                                                                     //
+//                                                                            //
+// ========================================================================== //
+
+// Per Context subscription and pending (queued) flags.
+`V_DFF(logic [N - 1:0], sub);
+`V_DFF(logic [N - 1:0], pend);
+
+// Queue of pending Contexts, in order of arrival.
+`V_DFFE(v_pkg::id_t [D - 1:0], queue, push);
+`V_DFFE(ptr_t, wr_ptr, push | init_r);
+`V_DFFE(ptr_t, rd_ptr, pop | init_r);
+`V_DFF(cnt_t, cnt);
+
+// Egress
+`V_DFF(logic, nfy_vld);
+`V_DFFE(v_pkg::id_t, nfy_prod_id, pop);
+`V_DFFE(logic [31:0], nfy_overflow, overflow | init_r);
+
+// ========================================================================== //
+//                                                                            //
+//  Subscription                                                              //
+//                                                                            //
+// ========================================================================== //
+
+// -------------------------------------------------------------------------- //
+// All Contexts are subscribed on initialization.
+//
+assign sub_addr = v_pkg::bank_addr(i_sub_prod_id);
+
+dec #(.N(N)) u_sub_dec (
+//
+  .i_x                                  (sub_addr)
+//
+, .o_y                                  (sub_sel)
+);
+
+for (genvar i = 0; i < N; i++) begin : sub_GEN
+
+assign sub_w [i] =
+    init_r | ((i_sub_vld & sub_sel [i]) ? i_sub_en : sub_r [i]);
+
+end // block: sub_GEN
+
+// ========================================================================== //
+//                                                                            //
+//  Ingress                                                                   //
+//                                                                            //
+// ========================================================================== //
+
+assign lv0_addr = v_pkg::bank_addr(i_lv0_prod_id_r);
+
+dec #(.N(N)) u_lv0_dec (
+//
+  .i_x                                  (lv0_addr)
+//
+, .o_y                                  (lv0_sel)
+);
+
+assign lv0_sub = ((lv0_sel & sub_r) != '0);
+assign lv0_pend = ((lv0_sel & pend_r) != '0);
+
+// -------------------------------------------------------------------------- //
+// A notification to a subscribed Context always updates the retained payload
+// of the Context. It requires a slot in the queue only where the Context is
+// not already queued, or is being dequeued on the current cycle (in which
+// case the dequeued payload predates the notification).
+//
+assign lv0_acc = i_lv0_vld_r & lv0_sub;
+assign lv0_new =
+    lv0_acc & ((~lv0_pend) | (pop & (head_prod_id == i_lv0_prod_id_r)));
+
+assign push = lv0_new & ((~queue_full) | pop);
+assign overflow = lv0_new & (~push);
+
+// ========================================================================== //
+//                                                                            //
+//  Queue                                                                     //
+//                                                                            //
+// ========================================================================== //
+
+assign queue_empty = (cnt_r == '0);
+assign queue_full = (cnt_r == cnt_t'(D));
+
+assign cnt_w = init_r ? '0 : (cnt_r + cnt_t'(push) - cnt_t'(pop));
+
+assign wr_ptr_w = init_r ? '0 : (wr_ptr_r + 'b1);
+assign rd_ptr_w = init_r ? '0 : (rd_ptr_r + 'b1);
+
+dec #(.N(D)) u_push_dec (
+//
+  .i_x                                  (wr_ptr_r)
+//
+, .o_y                                  (push_ptr_sel)
+);
+
+dec #(.N(D)) u_pop_dec (
+//
+  .i_x                                  (rd_ptr_r)
+//
+, .o_y                                  (pop_ptr_sel)
+);
+
+for (genvar i = 0; i < D; i++) begin : queue_GEN
+
+assign queue_w [i] = push_ptr_sel [i] ? i_lv0_prod_id_r : queue_r [i];
+
+end // block: queue_GEN
+
+mux #(.N(D), .W($bits(v_pkg::id_t))) u_head_mux (
+//
+  .i_x                                  (queue_r)
+, .i_sel                                (pop_ptr_sel)
+//
+, .o_y                                  (head_prod_id)
+);
+
+assign head_addr = v_pkg::bank_addr(head_prod_id);
+
+dec #(.N(N)) u_head_dec (
+//
+  .i_x                                  (head_addr)
+//
+, .o_y                                  (head_sel)
+);
+
+// -------------------------------------------------------------------------- //
+// Dequeue into the egress register whenever it is empty or being drained.
+//
+assign pop = (~queue_empty) & ((~nfy_vld_r) | i_nfy_ready);
+
+assign pend_w =
+    {N{~init_r}} & ((pend_r & ~({N{pop}} & head_sel)) | ({N{push}} & lv0_sel));
+
+// -------------------------------------------------------------------------- //
+// Payload: the latest top-of-book of each Context, read on dequeue.
+//
+sram1r1w #(.N(N), .W(PAYLOAD_BITS)) u_sram1r1w_payload (
+  //
+    .i_ren                              (pop)
+  , .i_raddr                            (head_addr)
+  , .o_rdata                            ({payload_key, payload_size})
+  //
+  , .i_wen                              (lv0_acc)
+  , .i_waddr                            (lv0_addr)
+  , .i_wdata                            ({i_lv0_key_r, i_lv0_size_r})
+  //
+  , .clk                                (clk)
+);
+
+// ========================================================================== //
+//                                                                            //
+//  Egress                                                                    //
+//                                                                            //
+// ========================================================================== //
+
+assign nfy_vld_w = (~init_r) & (pop | (nfy_vld_r & (~i_nfy_ready)));
+assign nfy_prod_id_w = head_prod_id;
+
+assign nfy_overflow_w = init_r ? '0 : (nfy_overflow_r + 'b1);
+
+// ========================================================================== //
+//                                                                            //
+//  Outputs                                                                   //
+//                                                                            //
+// ========================================================================== //
+
+assign o_nfy_vld_r = nfy_vld_r;
+assign o_nfy_prod_id_r = nfy_prod_id_r;
+assign o_nfy_key = payload_key;
+assign o_nfy_size = payload_size;
+assign o_nfy_overflow_r = nfy_overflow_r;
+
+endmodule // v_notify
+
+`include "unmacros.vh"
@@ -37,38 +37,73 @@ module v_pipe_query (
   input wire logic                                i_lut_vld
 , input wire v_pkg::id_t                          i_lut_prod_id
 , input wire v_pkg::level_t                       i_lut_level
+, input wire logic                                i_lut_snap
+, input wire logic                                i_lut_cum
+, input wire logic                                i_lut_rev
+, input wire v_pkg::key_t                         i_lut_key
 //
 , output wire logic                               o_lut_vld_r
 , output wire v_pkg::key_t                        o_lut_key
 , output wire v_pkg::volume_t                     o_lut_size
 , output wire logic                               o_lut_error
 , output wire v_pkg::listsize_t                   o_lut_listsize
+//
+, output wire logic                               o_lut_snap_r
+, output wire v_pkg::snap_vld_t                   o_lut_snap_vld
+, output wire v_pkg::snap_key_t                   o_lut_snap_key
+, output wire v_pkg::snap_volume_t                o_lut_snap_size
+//
+, output wire logic                               o_lut_cum_r
+, output wire v_pkg::cum_t                        o_lut_cum
+//
+, output wire logic                               o_lut_rev_vld_r
+, output wire logic                               o_lut_rev_hit
+, output wire v_pkg::level_t                      o_lut_rev_level
+, output wire v_pkg::volume_t                     o_lut_rev_size
+, output wire v_pkg::listsize_t                   o_lut_rev_better
+, output wire logic                               o_lut_rev_error
 
 // -------------------------------------------------------------------------- //
-// State Interface
+// State Interface (per bank)
 //
-, input wire v_pkg::state_t                       i_state_rdata
+, input wire v_pkg::state_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_state_rdata
 //
 , output wire logic                               o_state_ren
 , output wire v_pkg::addr_t                       o_state_raddr
 
 // -------------------------------------------------------------------------- //
-// Update Pipeline Interface
+// Update Pipeline Interface (per bank)
+//
+, input wire logic [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_s1_upd_vld_r
+, input wire v_pkg::id_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_s1_upd_prod_id_r
 //
-, input wire logic                                i_s1_upd_vld_r
-, input wire v_pkg::id_t                          i_s1_upd_prod_id_r
+, input wire logic [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_s2_upd_vld_r
+, input wire v_pkg::id_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_s2_upd_prod_id_r
 //
-, input wire logic                                i_s2_upd_vld_r
-, input wire v_pkg::id_t                          i_s2_upd_prod_id_r
+, input wire logic [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_s3_upd_vld_r
+, input wire v_pkg::id_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_s3_upd_prod_id_r
 //
-, input wire logic                                i_s3_upd_vld_r
-, input wire v_pkg::id_t                          i_s3_upd_prod_id_r
+, input wire logic [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_s4_upd_vld_r
+, input wire v_pkg::id_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_s4_upd_prod_id_r
 //
-, input wire logic                                i_s4_upd_vld_r
-, input wire v_pkg::id_t                          i_s4_upd_prod_id_r
+, input wire logic [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_s5_upd_vld_r
+, input wire v_pkg::id_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_s5_upd_prod_id_r
 //
-, input wire logic                                i_s5_upd_vld_r
-, input wire v_pkg::id_t                          i_s5_upd_prod_id_r
+, input wire v_pkg::state_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_s4_upd_state
+, input wire v_pkg::state_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_s5_upd_state_r
 
 // -------------------------------------------------------------------------- //
 // Initialization
@@ -89,16 +124,38 @@ module v_pipe_query (
 logic                                   s0_state_ren;
 v_pkg::id_t                             s0_state_raddr;
 logic                                   s1_lut_en;
-logic                                   s0_lut_error_is_busy;
+// In-flight Updates to the addressed Context, per stage and bank.
+v_pkg::bank_t                           s0_lut_hit_s1;
+v_pkg::bank_t                           s0_lut_hit_s2;
+v_pkg::bank_t                           s0_lut_hit_s3;
+v_pkg::bank_t                           s0_lut_hit_s4;
+v_pkg::bank_t                           s0_lut_hit_s5;
 
 // S1
 
+v_pkg::state_t                          s1_lut_rdata;
+v_pkg::state_t                          s1_lut_state;
 v_pkg::listsize_t                       s1_lut_listsize;
 v_pkg::key_t                            s1_lut_key;
 v_pkg::volume_t                         s1_lut_volume;
+v_pkg::cum_t                            s1_lut_cum;
 logic                                   s1_lut_error_invalid_entry;
-logic                                   s1_lut_error_was_busy;
+logic                                   s1_lut_error_invalid_level;
 logic                                   s1_lut_error;
+logic                                   s2_lut_rev_en;
+
+// S2
+logic                                   s2_lut_rev_match_hit;
+logic [cfg_pkg::ENTRIES_N - 1:0]        s2_lut_rev_match_sel;
+logic [cfg_pkg::ENTRIES_N - 1:0]        s2_lut_rev_mask_cmp;
+logic                                   s3_lut_rev_en;
+
+// S3
+logic [cfg_pkg::ENTRIES_N - 1:0]        s3_lut_rev_sel;
+logic                                   s3_lut_rev_full;
+v_pkg::level_t                          s3_lut_rev_level;
+v_pkg::listsize_t                       s3_lut_rev_better;
+v_pkg::volume_t                         s3_lut_rev_volume;
 
 // ========================================================================== //
 //                                                                            //
@@ -107,9 +164,31 @@ logic                                   s1_lut_error;
 // ========================================================================== //
 
 `V_DFF(logic, s1_lut_vld);
-`V_DFFE(v_pkg::id_t, s1_lut_prod_id, s1_lut_en);
-`V_DFFE(logic, s1_lut_error, s1_lut_en);
-`V_DFFE(logic [cfg_pkg::ENTRIES_N - 1:0], s1_lut_level_dec, s1_lut_en);
+`V_DFFE(v_pkg::bank_t, s1_lut_bank, s1_lut_en);
+`V_DFFE(logic, s1_lut_snap, s1_lut_en);
+`V_DFFE(logic, s1_lut_cum, s1_lut_en);
+`V_DFFE(logic, s1_lut_rev, s1_lut_en);
+`V_DFFE(v_pkg::key_t, s1_lut_rev_key, s1_lut_en);
+
+`V_DFF(logic, s2_lut_rev_vld);
+`V_DFFE(v_pkg::key_t, s2_lut_rev_key, s2_lut_rev_en);
+`V_DFFE(logic [cfg_pkg::ENTRIES_N - 1:0], s2_lut_rev_stvld, s2_lut_rev_en);
+`V_DFFE(v_pkg::key_t [cfg_pkg::ENTRIES_N - 1:0], s2_lut_rev_keys,
+        s2_lut_rev_en);
+`V_DFFE(v_pkg::volume_t [cfg_pkg::ENTRIES_N - 1:0], s2_lut_rev_volumes,
+        s2_lut_rev_en);
+`V_DFFE(logic [cfg_pkg::ENTRIES_BLOCKS_N - 1:0], s2_lut_rev_idx_le,
+        s2_lut_rev_en);
+`V_DFFE(logic [cfg_pkg::ENTRIES_BLOCKS_N - 1:0], s2_lut_rev_idx_lt,
+        s2_lut_rev_en);
+`V_DFFE(logic, s2_lut_rev_error, s2_lut_rev_en);
+
+`V_DFF(logic, s3_lut_rev_vld);
+`V_DFFE(logic, s3_lut_rev_hit, s3_lut_rev_en);
+`V_DFFE(logic [cfg_pkg::ENTRIES_N - 1:0], s3_lut_rev_cmp, s3_lut_rev_en);
+`V_DFFE(v_pkg::volume_t [cfg_pkg::ENTRIES_N - 1:0], s3_lut_rev_volumes,
+        s3_lut_rev_en);
+`V_DFFE(logic, s3_lut_rev_error, s3_lut_rev_en);
 
 // ========================================================================== //
 //                                                                            //
@@ -118,12 +197,146 @@ logic                                   s1_lut_error;
 // ========================================================================== //
 
 // -------------------------------------------------------------------------- //
-// State table lookup
+// State table lookup; the lookup is issued to the bank in which the Context
+// resides (the bank select is retained to S1 to select the read data).
 assign s0_state_ren     = i_lut_vld;
 assign s0_state_raddr   = i_lut_prod_id;
 
 assign s1_lut_vld_w     = i_lut_vld & (~init_r);
 assign s1_lut_en        = s1_lut_vld_w;
+assign s1_lut_bank_w    = v_pkg::bank_dec(i_lut_prod_id);
+assign s1_lut_snap_w    = i_lut_snap;
+assign s1_lut_cum_w     = i_lut_cum;
+assign s1_lut_rev_w     = i_lut_rev;
+assign s1_lut_rev_key_w = i_lut_key;
+
+// -------------------------------------------------------------------------- //
+// Update pipelines holding the addressed Context. A Context resides in exactly
+// one bank, therefore at most one bank may hit at each stage.
+//
+for (genvar b = 0; b < cfg_pkg::UPDATE_PORTS_N; b++) begin : hit_GEN
+
+assign s0_lut_hit_s1 [b] =
+    i_s1_upd_vld_r [b] & (i_s1_upd_prod_id_r [b] == i_lut_prod_id);
+assign s0_lut_hit_s2 [b] =
+    i_s2_upd_vld_r [b] & (i_s2_upd_prod_id_r [b] == i_lut_prod_id);
+assign s0_lut_hit_s3 [b] =
+    i_s3_upd_vld_r [b] & (i_s3_upd_prod_id_r [b] == i_lut_prod_id);
+assign s0_lut_hit_s4 [b] =
+    i_s4_upd_vld_r [b] & (i_s4_upd_prod_id_r [b] == i_lut_prod_id);
+assign s0_lut_hit_s5 [b] =
+    i_s5_upd_vld_r [b] & (i_s5_upd_prod_id_r [b] == i_lut_prod_id);
+
+end // block: hit_GEN
+
+// ========================================================================== //
+//                                                                            //
+//  In-flight Updates                                                         //
+//                                                                            //
+// ========================================================================== //
+
+// -------------------------------------------------------------------------- //
+// Select the read data of the bank addressed in S0.
+//
+mux #(.N(cfg_pkg::UPDATE_PORTS_N), .W(v_pkg::STATE_BITS)) u_s1_rdata_mux (
+//
+  .i_x                                  (i_state_rdata)
+, .i_sel                                (s1_lut_bank_r)
+//
+, .o_y                                  (s1_lut_rdata)
+);
+
+if (cfg_pkg::QUERY_FORWARD) begin : fwd_GEN
+
+// -------------------------------------------------------------------------- //
+// Queries are resolved against the newest state of the addressed Context by
+// forwarding from the Update pipeline. A Query issued on cycle 'q' is ordered
+// after those Updates issued on cycles up to and including 'q - 3' (which
+// reach the EXE stage by the time the Query reaches S1), and before those
+// issued on later cycles. Therefore, a Query never errors on an in-flight
+// Update.
+//
+// In S1, the newest state is taken from (in order of priority):
+//
+//  1. The EXE output (S4): Update issued on 'q - 3'.
+//
+//  2. The writeback (S5): Update issued on 'q - 4'.
+//
+//  3. The writeback as seen in S0: Update issued on 'q - 5'. The writeback is
+//     committed on the same cycle on which the Query reads the state table,
+//     and is therefore not observed by the read; it is retained in S1.
+//
+//  4. The state table.
+//
+// Each is taken from the Update pipeline of the bank addressed in S0.
+//
+logic [2:0]                             s1_lut_fwd_sel;
+logic                                   s1_lut_wrbk_en;
+v_pkg::state_t                          s1_lut_exe_state;
+v_pkg::state_t                          s1_lut_s5_state;
+
+`V_DFFE(logic [2:0], s1_lut_fwd, s1_lut_en);
+`V_DFFE(v_pkg::state_t, s1_lut_wrbk, s1_lut_wrbk_en);
+
+assign s1_lut_fwd_w [2] = (|s0_lut_hit_s3);
+assign s1_lut_fwd_w [1] = (|s0_lut_hit_s4);
+assign s1_lut_fwd_w [0] = (|s0_lut_hit_s5);
+
+assign s1_lut_wrbk_en = s1_lut_vld_w & s1_lut_fwd_w [0];
+
+mux #(.N(cfg_pkg::UPDATE_PORTS_N), .W(v_pkg::STATE_BITS)) u_s0_wrbk_mux (
+//
+  .i_x                                  (i_s5_upd_state_r)
+, .i_sel                                (s0_lut_hit_s5)
+//
+, .o_y                                  (s1_lut_wrbk_w)
+);
+
+mux #(.N(cfg_pkg::UPDATE_PORTS_N), .W(v_pkg::STATE_BITS)) u_s1_exe_mux (
+//
+  .i_x                                  (i_s4_upd_state)
+, .i_sel                                (s1_lut_bank_r)
+//
+, .o_y                                  (s1_lut_exe_state)
+);
+
+mux #(.N(cfg_pkg::UPDATE_PORTS_N), .W(v_pkg::STATE_BITS)) u_s1_s5_mux (
+//
+  .i_x                                  (i_s5_upd_state_r)
+, .i_sel                                (s1_lut_bank_r)
+//
+, .o_y                                  (s1_lut_s5_state)
+);
+
+pri #(.W(3)) u_s1_fwd_pri (
+  //
+    .i_x                                (s1_lut_fwd_r)
+  //
+  , .o_y                                (s1_lut_fwd_sel)
+);
+
+// -------------------------------------------------------------------------- //
+// As with the Update pipeline, the late-arriving state (here, from the EXE
+// stage and from RAM) is injected late into the logic cone.
+//
+assign s1_lut_state =
+   ({v_pkg::STATE_BITS{s1_lut_fwd_sel[2]}} & s1_lut_exe_state) |
+   ({v_pkg::STATE_BITS{s1_lut_fwd_sel[1]}} & s1_lut_s5_state) |
+   ({v_pkg::STATE_BITS{s1_lut_fwd_sel[0]}} & s1_lut_wrbk_r) |
+   ({v_pkg::STATE_BITS{~(|s1_lut_fwd_r)}} & s1_lut_rdata);
+
+// -------------------------------------------------------------------------- //
+// Form final error state
+assign s1_lut_error = s1_lut_error_invalid_level;
+
+end else begin : busy_GEN
+
+logic                                   s0_lut_error_is_busy;
+logic                                   s1_lut_error_was_busy;
+
+`V_DFFE(v_pkg::id_t, s1_lut_prod_id, s1_lut_en);
+`V_DFFE(logic, s1_lut_error, s1_lut_en);
+
 assign s1_lut_prod_id_w = i_lut_prod_id;
 
 // -------------------------------------------------------------------------- //
@@ -132,26 +345,43 @@ assign s1_lut_prod_id_w = i_lut_prod_id;
 // We consider the "list busy" whenever there is a in-flight operation to the
 // currently addressed ID in the update pipeline. Whenever an update is
 // in-flight, we simply error-out. Otherwise, it would be possible to use some
-// more sophisticated forwarding, but this is probably overkill in this
-// context and is not required by the specification.
+// more sophisticated forwarding (see QUERY_FORWARD), but this is probably
+// overkill in this context and is not required by the specification.
 //
 assign s0_lut_error_is_busy   =
-    (i_s1_upd_vld_r & (i_s1_upd_prod_id_r == i_lut_prod_id)) |
-    (i_s2_upd_vld_r & (i_s2_upd_prod_id_r == i_lut_prod_id)) |
-    (i_s3_upd_vld_r & (i_s3_upd_prod_id_r == i_lut_prod_id)) |
-    (i_s4_upd_vld_r & (i_s4_upd_prod_id_r == i_lut_prod_id)) |
-    (i_s5_upd_vld_r & (i_s5_upd_prod_id_r == i_lut_prod_id));
+    (|s0_lut_hit_s1) |
+    (|s0_lut_hit_s2) |
+    (|s0_lut_hit_s3) |
+    (|s0_lut_hit_s4) |
+    (|s0_lut_hit_s5);
 
 assign s1_lut_error_w = s0_lut_error_is_busy;
 
 // -------------------------------------------------------------------------- //
+// Update and Query commands which are co-incident must be checked at the input
+// to the machine. In S0, for this to happen, we would need to consider the
+// input to the update pipeline. For reasons of timing, we've simply pushed to
+// the next stage so we can get this state from flops.
 //
-dec #(.N(cfg_pkg::ENTRIES_N)) u_s0_id_dec (
-//
-  .i_x                                  (i_lut_level)
-//
-, .o_y                                  (s1_lut_level_dec_w)
-);
+v_pkg::bank_t                           s1_lut_hit_s1;
+
+for (genvar b = 0; b < cfg_pkg::UPDATE_PORTS_N; b++) begin : was_busy_GEN
+
+assign s1_lut_hit_s1 [b] =
+    i_s1_upd_vld_r [b] & (i_s1_upd_prod_id_r [b] == s1_lut_prod_id_r);
+
+end // block: was_busy_GEN
+
+assign s1_lut_error_was_busy = (|s1_lut_hit_s1);
+
+assign s1_lut_state = s1_lut_rdata;
+
+// -------------------------------------------------------------------------- //
+// Form final error state
+assign s1_lut_error =
+    (s1_lut_error_r | s1_lut_error_invalid_level | s1_lut_error_was_busy);
+
+end // block: busy_GEN
 
 // ========================================================================== //
 //                                                                            //
@@ -173,7 +403,20 @@ dec #(.N(cfg_pkg::ENTRIES_N)) u_s0_id_dec (
 // the table itself which is updated each time an entry is modified. The query
 // pipeline simply retains this pre-computed state.
 //
-assign s1_lut_listsize = i_state_rdata.listsize;
+assign s1_lut_listsize = s1_lut_state.listsize;
+
+if (cfg_pkg::ENTRIES_BLOCKS_N == 1) begin : level_flat_GEN
+
+`V_DFFE(logic [cfg_pkg::ENTRIES_N - 1:0], s1_lut_level_dec, s1_lut_en);
+
+// -------------------------------------------------------------------------- //
+//
+dec #(.N(cfg_pkg::ENTRIES_N)) u_s0_id_dec (
+//
+  .i_x                                  (i_lut_level)
+//
+, .o_y                                  (s1_lut_level_dec_w)
+);
 
 // -------------------------------------------------------------------------- //
 // A 'level' is invalid if its associated valid bit is 'b0. As above, we retain
@@ -184,53 +427,316 @@ assign s1_lut_listsize = i_state_rdata.listsize;
 // state from the RAM.
 //
 assign s1_lut_error_invalid_entry =
-    ((s1_lut_level_dec_r & i_state_rdata.vld) == '0);
+    ((s1_lut_level_dec_r & s1_lut_state.vld) == '0);
 
 // -------------------------------------------------------------------------- //
-// Update and Query commands which are co-incident must be checked at the input
-// to the machine. In S0, for this to happen, we would need to consider the
-// input to the update pipeline. For reasons of timing, we've simply pushed to
-// the next stage so we can get this state from flops.
 //
-assign s1_lut_error_was_busy =
-    (i_s1_upd_vld_r & (i_s1_upd_prod_id_r == s1_lut_prod_id_r));
+mux #(.N(cfg_pkg::ENTRIES_N), .W(v_pkg::KEY_BITS)) u_s1_key_mux (
+//
+  .i_x                                  (s1_lut_state.key)
+, .i_sel                                (s1_lut_level_dec_r)
+//
+, .o_y                                  (s1_lut_key)
+);
 
 // -------------------------------------------------------------------------- //
-// Form final error state
-assign s1_lut_error =
-    (s1_lut_error_r | s1_lut_error_invalid_entry | s1_lut_error_was_busy);
+//
+mux #(.N(cfg_pkg::ENTRIES_N), .W(v_pkg::VOLUME_BITS)) u_s1_volume_mux (
+//
+  .i_x                                  (s1_lut_state.volume)
+, .i_sel                                (s1_lut_level_dec_r)
+//
+, .o_y                                  (s1_lut_volume)
+);
 
 // -------------------------------------------------------------------------- //
 //
-mux #(.N(cfg_pkg::ENTRIES_N), .W(v_pkg::KEY_BITS)) u_s1_key_mux (
+mux #(.N(cfg_pkg::ENTRIES_N), .W(v_pkg::CUM_BITS)) u_s1_cum_mux (
 //
-  .i_x                                  (i_state_rdata.key)
+  .i_x                                  (s1_lut_state.cum)
 , .i_sel                                (s1_lut_level_dec_r)
 //
-, .o_y                                  (s1_lut_key)
+, .o_y                                  (s1_lut_cum)
 );
 
+end else begin : level_blk_GEN
+
 // -------------------------------------------------------------------------- //
+// Hierarchical organisation: the level is decomposed into its block (upper
+// bits) and its position within the block (lower bits), each decoded
+// independently in S0. In S1, the addressed block is selected first, followed
+// by the entry within it; this bounds the fan-in of each mux to the larger of
+// ENTRIES_BLOCKS_N and ENTRIES_BLOCK_N, rather than ENTRIES_N.
 //
-mux #(.N(cfg_pkg::ENTRIES_N), .W(v_pkg::VOLUME_BITS)) u_s1_volume_mux (
+localparam int B = cfg_pkg::ENTRIES_BLOCK_N;
+localparam int NB = cfg_pkg::ENTRIES_BLOCKS_N;
+localparam int LEVEL_BITS = $clog2(cfg_pkg::ENTRIES_N);
+localparam int ENT_BITS = $clog2(B);
+
+logic [B - 1:0]                         s1_lut_blk_vld;
+v_pkg::key_t [B - 1:0]                  s1_lut_blk_key;
+v_pkg::volume_t [B - 1:0]               s1_lut_blk_volume;
+v_pkg::cum_t [B - 1:0]                  s1_lut_blk_cum;
+
+`V_DFFE(logic [NB - 1:0], s1_lut_level_blk_dec, s1_lut_en);
+`V_DFFE(logic [B - 1:0], s1_lut_level_ent_dec, s1_lut_en);
+
+dec #(.N(NB)) u_s0_blk_dec (
 //
-  .i_x                                  (i_state_rdata.volume)
-, .i_sel                                (s1_lut_level_dec_r)
+  .i_x                                  (i_lut_level [LEVEL_BITS - 1:ENT_BITS])
+//
+, .o_y                                  (s1_lut_level_blk_dec_w)
+);
+
+dec #(.N(B)) u_s0_ent_dec (
+//
+  .i_x                                  (i_lut_level [ENT_BITS - 1:0])
+//
+, .o_y                                  (s1_lut_level_ent_dec_w)
+);
+
+// -------------------------------------------------------------------------- //
+// Block select.
+//
+mux #(.N(NB), .W(B)) u_s1_blk_vld_mux (
+//
+  .i_x                                  (s1_lut_state.vld)
+, .i_sel                                (s1_lut_level_blk_dec_r)
+//
+, .o_y                                  (s1_lut_blk_vld)
+);
+
+mux #(.N(NB), .W(B * v_pkg::KEY_BITS)) u_s1_blk_key_mux (
+//
+  .i_x                                  (s1_lut_state.key)
+, .i_sel                                (s1_lut_level_blk_dec_r)
+//
+, .o_y                                  (s1_lut_blk_key)
+);
+
+mux #(.N(NB), .W(B * v_pkg::VOLUME_BITS)) u_s1_blk_volume_mux (
+//
+  .i_x                                  (s1_lut_state.volume)
+, .i_sel                                (s1_lut_level_blk_dec_r)
+//
+, .o_y                                  (s1_lut_blk_volume)
+);
+
+mux #(.N(NB), .W(B * v_pkg::CUM_BITS)) u_s1_blk_cum_mux (
+//
+  .i_x                                  (s1_lut_state.cum)
+, .i_sel                                (s1_lut_level_blk_dec_r)
+//
+, .o_y                                  (s1_lut_blk_cum)
+);
+
+// -------------------------------------------------------------------------- //
+// Entry select (within block).
+//
+assign s1_lut_error_invalid_entry =
+    ((s1_lut_level_ent_dec_r & s1_lut_blk_vld) == '0);
+
+mux #(.N(B), .W(v_pkg::KEY_BITS)) u_s1_key_mux (
+//
+  .i_x                                  (s1_lut_blk_key)
+, .i_sel                                (s1_lut_level_ent_dec_r)
+//
+, .o_y                                  (s1_lut_key)
+);
+
+mux #(.N(B), .W(v_pkg::VOLUME_BITS)) u_s1_volume_mux (
+//
+  .i_x                                  (s1_lut_blk_volume)
+, .i_sel                                (s1_lut_level_ent_dec_r)
 //
 , .o_y                                  (s1_lut_volume)
 );
 
+mux #(.N(B), .W(v_pkg::CUM_BITS)) u_s1_cum_mux (
+//
+  .i_x                                  (s1_lut_blk_cum)
+, .i_sel                                (s1_lut_level_ent_dec_r)
+//
+, .o_y                                  (s1_lut_cum)
+);
+
+end // block: level_blk_GEN
+
+// A snapshot carries no level; the validity of each returned level is
+// instead presented alongside it. Similarly, a Key Lookup carries no level
+// (a key absent from the Context is a miss, not an error).
+assign s1_lut_error_invalid_level =
+    s1_lut_error_invalid_entry & (~s1_lut_snap_r) & (~s1_lut_rev_r);
+
+// -------------------------------------------------------------------------- //
+// Snapshot: the leading levels of the Context. Entries are retained in sorted
+// order in the state, therefore the snapshot is a simple slice of the state
+// (requiring no muxing), and, being formed from a single read of the state, is
+// consistent by construction.
+//
+assign o_lut_snap_vld = s1_lut_state.vld [cfg_pkg::SNAPSHOT_K - 1:0];
+assign o_lut_snap_key = s1_lut_state.key [cfg_pkg::SNAPSHOT_K - 1:0];
+assign o_lut_snap_size = s1_lut_state.volume [cfg_pkg::SNAPSHOT_K - 1:0];
+
+// -------------------------------------------------------------------------- //
+// Cumulative Query: the total volume through the addressed level. The
+// cumulative volume is retained, pre-computed, in the state (as the list
+// size), therefore it is selected alongside the volume of the level, at the
+// same latency.
+//
+assign o_lut_cum = s1_lut_cum;
+
+// ========================================================================== //
+//                                                                            //
+//  Key Lookup                                                                //
+//                                                                            //
+// ========================================================================== //
+
+// -------------------------------------------------------------------------- //
+// Key Lookup (reverse Query): locate a key within the addressed Context,
+// returning its level and volume, and the count of entries ordered strictly
+// before it (those better priced). The lookup reuses the comparator structure
+// of the Update pipeline (in either the flat or hierarchical organisation) and
+// is performed over three stages, mirroring S2 and S3 of the Update pipeline:
+//
+//  S1: The (forwarded) state of the Context is retained alongside the key. In
+//      the hierarchical organisation, the first level of the search (against
+//      the block index) is taken upon the late-arriving state, as in S2 of the
+//      Update pipeline, and its outcome is retained.
+//
+//  S2: The key is compared against the entries of the Context (the target
+//      block, where hierarchical); the outcome, alongside the volume of each
+//      entry, is retained.
+//
+//  S3: The position of the key is reduced from the comparison outcome and the
+//      response is formed.
+//
+// Neither the comparison nor the reduction (a priority detect and encode
+// across ENTRIES_N) may follow the state read in S1, therefore the Key Lookup
+// incurs two cycles of additional latency relative to the level Query and is
+// returned on its own response bus. A level Query and a Key Lookup issued on
+// nearby cycles never collide.
+//
+v_pipe_update_idx u_s1_rev_idx (
+//
+  .i_pipe_key                           (s1_lut_rev_key_r)
+//
+, .i_stcur_vld                          (s1_lut_state.vld)
+, .i_stcur_keys                         (s1_lut_state.key)
+//
+, .o_idx_le                             (s2_lut_rev_idx_le_w)
+, .o_idx_lt                             (s2_lut_rev_idx_lt_w)
+);
+
+assign s2_lut_rev_vld_w = s1_lut_vld_r & s1_lut_rev_r & (~init_r);
+assign s2_lut_rev_en = s2_lut_rev_vld_w;
+
+assign s2_lut_rev_key_w = s1_lut_rev_key_r;
+assign s2_lut_rev_stvld_w = s1_lut_state.vld;
+assign s2_lut_rev_keys_w = s1_lut_state.key;
+assign s2_lut_rev_volumes_w = s1_lut_state.volume;
+assign s2_lut_rev_error_w = s1_lut_error;
+
+// -------------------------------------------------------------------------- //
+// S2
+//
+v_pipe_update_cmp u_s2_rev_cmp (
+//
+  .i_pipe_key_r                         (s2_lut_rev_key_r)
+//
+, .i_stcur_vld_r                        (s2_lut_rev_stvld_r)
+, .i_stcur_keys_r                       (s2_lut_rev_keys_r)
+//
+, .i_idx_le_r                           (s2_lut_rev_idx_le_r)
+, .i_idx_lt_r                           (s2_lut_rev_idx_lt_r)
+//
+, .o_match_hit                          (s2_lut_rev_match_hit)
+, .o_match_full                         ()
+, .o_match_sel                          (s2_lut_rev_match_sel)
+, .o_mask_cmp                           (s2_lut_rev_mask_cmp)
+);
+
+assign s3_lut_rev_vld_w = s2_lut_rev_vld_r & (~init_r);
+assign s3_lut_rev_en = s3_lut_rev_vld_w;
+
+assign s3_lut_rev_hit_w = s2_lut_rev_match_hit;
+assign s3_lut_rev_volumes_w = s2_lut_rev_volumes_r;
+assign s3_lut_rev_error_w = s2_lut_rev_error_r;
+
+// -------------------------------------------------------------------------- //
+// Entries are retained in sorted order, therefore those ordered strictly
+// before the key form a contiguous run from the head. The comparison mask
+// denotes those entries ordered before or equal to the key; excluding the
+// matching entries, the run is terminated by the first entry not ordered
+// strictly before the key.
+//
+assign s3_lut_rev_cmp_w = s2_lut_rev_mask_cmp & (~s2_lut_rev_match_sel);
+
+// -------------------------------------------------------------------------- //
+// S3
+//
+// The first entry not ordered strictly before the key is, on a hit, the first
+// matching entry, and on a miss, the position at which the key would be
+// inserted. Where all entries are ordered before the key (a miss on a full
+// Context), no position is selected.
+//
+lzd #(.W(cfg_pkg::ENTRIES_N), .DETECT_ZERO(1), .FROM_LSB(1)) u_s3_rev_lzd (
+  //
+    .i_x                                (s3_lut_rev_cmp_r)
+  //
+  , .o_y                                (s3_lut_rev_sel)
+);
+
+assign s3_lut_rev_full = (s3_lut_rev_sel == '0);
+
+// -------------------------------------------------------------------------- //
+// Encode the (one-hot) position to form the level.
+//
+for (genvar k = 0; k < $bits(v_pkg::level_t); k++) begin : rev_enc_GEN
+
+logic [cfg_pkg::ENTRIES_N - 1:0]        enc_mask;
+
+for (genvar i = 0; i < cfg_pkg::ENTRIES_N; i++) begin : ent_GEN
+
+assign enc_mask [i] = ((i >> k) & 1) != 0;
+
+end : ent_GEN
+
+assign s3_lut_rev_level [k] = ((s3_lut_rev_sel & enc_mask) != '0);
+
+end : rev_enc_GEN
+
+assign s3_lut_rev_better =
+    s3_lut_rev_full ? v_pkg::listsize_t'(cfg_pkg::ENTRIES_N)
+                    : v_pkg::listsize_t'(s3_lut_rev_level);
+
+mux #(.N(cfg_pkg::ENTRIES_N), .W(v_pkg::VOLUME_BITS)) u_s3_rev_volume_mux (
+//
+  .i_x                                  (s3_lut_rev_volumes_r)
+, .i_sel                                (s3_lut_rev_sel)
+//
+, .o_y                                  (s3_lut_rev_volume)
+);
+
 // ========================================================================== //
 //                                                                            //
 //  Outputs                                                                   //
 //                                                                            //
 // ========================================================================== //
 
-assign o_lut_vld_r = s1_lut_vld_r;
+assign o_lut_vld_r = s1_lut_vld_r & (~s1_lut_rev_r);
 assign o_lut_key = s1_lut_key;
 assign o_lut_size = s1_lut_volume;
 assign o_lut_error = s1_lut_error;
 assign o_lut_listsize = s1_lut_listsize;
+assign o_lut_snap_r = s1_lut_snap_r;
+assign o_lut_cum_r = s1_lut_cum_r;
+assign o_lut_rev_vld_r = s3_lut_rev_vld_r;
+assign o_lut_rev_hit = s3_lut_rev_hit_r;
+assign o_lut_rev_level = s3_lut_rev_level;
+assign o_lut_rev_size = s3_lut_rev_volume;
+assign o_lut_rev_better = s3_lut_rev_better;
+assign o_lut_rev_error = s3_lut_rev_error_r;
 
 assign o_state_ren = s0_state_ren;
 assign o_state_raddr = s0_state_raddr;
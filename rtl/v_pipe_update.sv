@@ -76,6 +76,9 @@ module v_pipe_update (
 //
 , output wire logic                               o_s5_upd_vld_r
 , output wire v_pkg::id_t                         o_s5_upd_prod_id_r
+//
+, output wire v_pkg::state_t                      o_s4_upd_state
+, output wire v_pkg::state_t                      o_s5_upd_state_r
 
 // -------------------------------------------------------------------------- //
 // Initialization
@@ -105,7 +108,8 @@ logic                                             s2_upd_en;
 // S2:
 //
 logic [1:0]                                       s2_upd_state_fwd;
-logic [1:0]                                       s2_upd_state_sel;
+logic                                             s2_upd_state_fwd_wrbk;
+logic [2:0]                                       s2_upd_state_sel;
 logic                                             s2_upd_state_sel_early;
 v_pkg::state_t                                    s2_upd_state_early;
 //
@@ -113,6 +117,10 @@ logic                                             s3_upd_en;
 
 // S3:
 //
+logic                                             s3_upd_state_fwd_exe;
+v_pkg::state_t                                    s3_upd_state_cur;
+logic [cfg_pkg::ENTRIES_BLOCKS_N - 1:0]           s3_upd_idx_le_cur;
+logic [cfg_pkg::ENTRIES_BLOCKS_N - 1:0]           s3_upd_idx_lt_cur;
 logic [cfg_pkg::ENTRIES_N - 1:0]                  s3_exe_stcur_vld_r;
 v_pkg::key_t [cfg_pkg::ENTRIES_N - 1:0]           s3_exe_stcur_keys_r;
 logic                                             s3_upd_match_hit;
@@ -127,11 +135,13 @@ logic                                             s4_upd_en;
 logic [cfg_pkg::ENTRIES_N - 1:0]                  s4_exe_stcur_vld_r;
 v_pkg::key_t [cfg_pkg::ENTRIES_N - 1:0]           s4_exe_stcur_keys_r;
 v_pkg::volume_t [cfg_pkg::ENTRIES_N - 1:0]        s4_exe_stcur_volumes_r;
+v_pkg::cum_t [cfg_pkg::ENTRIES_N - 1:0]           s4_exe_stcur_cums_r;
 v_pkg::listsize_t                                 s4_exe_stcur_listsize_r;
 //
 logic [cfg_pkg::ENTRIES_N - 1:0]                  s4_exe_stnxt_vld;
 v_pkg::key_t [cfg_pkg::ENTRIES_N - 1:0]           s4_exe_stnxt_keys;
 v_pkg::volume_t [cfg_pkg::ENTRIES_N - 1:0]        s4_exe_stnxt_volumes;
+v_pkg::cum_t [cfg_pkg::ENTRIES_N - 1:0]           s4_exe_stnxt_cums;
 v_pkg::listsize_t                                 s4_exe_stnxt_listsize;
 
 
@@ -172,6 +182,8 @@ logic                                             lv0_en;
 `V_DFFE(v_pkg::key_t, s3_upd_key, s3_upd_en);
 `V_DFFE(v_pkg::size_t, s3_upd_size, s3_upd_en);
 `V_DFFE(v_pkg::state_t, s3_upd_state, s3_upd_en);
+`V_DFFE(logic [cfg_pkg::ENTRIES_BLOCKS_N - 1:0], s3_upd_idx_le, s3_upd_en);
+`V_DFFE(logic [cfg_pkg::ENTRIES_BLOCKS_N - 1:0], s3_upd_idx_lt, s3_upd_en);
 
 `V_DFF(logic, s4_upd_vld);
 `V_DFFE(v_pkg::id_t, s4_upd_prod_id, s4_upd_en);
@@ -251,21 +263,32 @@ assign s2_upd_state_fwd [1] = wrbk_vld_w & (wrbk_prod_id_w == s2_upd_prod_id_r);
 // Otherwise, attempt hit on prior writeback
 assign s2_upd_state_fwd [0] = s2_upd_wrbk_vld_r;
 
-pri #(.W(2)) u_s2_forwarding_pri (
+// -------------------------------------------------------------------------- //
+// Otherwise, attempt hit on the registered writeback (an Update to the same
+// Context issued three cycles prior). The state table was read in S1 one cycle
+// before this writeback was committed, and is therefore stale.
+//
+assign s2_upd_state_fwd_wrbk =
+    wrbk_vld_r & (wrbk_prod_id_r == s2_upd_prod_id_r);
+
+pri #(.W(3)) u_s2_forwarding_pri (
   //
-    .i_x                                (s2_upd_state_fwd)
+    .i_x                                ({s2_upd_state_fwd [1],
+                                          s2_upd_state_fwd_wrbk,
+                                          s2_upd_state_fwd [0]})
   //
   , .o_y                                (s2_upd_state_sel)
 );
 
-assign s2_upd_state_sel_early = (|s2_upd_state_fwd);
+assign s2_upd_state_sel_early = (|s2_upd_state_fwd) | s2_upd_state_fwd_wrbk;
 
 // -------------------------------------------------------------------------- //
 // Early state forwarding; the state that is expected to arrival
 // relatively early into the current cycle.
 //
 assign s2_upd_state_early =
-   ({v_pkg::STATE_BITS{s2_upd_state_sel[1]}} & wrbk_state_w) |
+   ({v_pkg::STATE_BITS{s2_upd_state_sel[2]}} & wrbk_state_w) |
+   ({v_pkg::STATE_BITS{s2_upd_state_sel[1]}} & wrbk_state_r) |
    ({v_pkg::STATE_BITS{s2_upd_state_sel[0]}} & s2_upd_wrbk_r);
 
 // -------------------------------------------------------------------------- //
@@ -277,6 +300,23 @@ assign s3_upd_state_w =
    ({v_pkg::STATE_BITS{ s2_upd_state_sel_early}} & s2_upd_state_early) |
    ({v_pkg::STATE_BITS{~s2_upd_state_sel_early}} & i_state_rdata);
 
+// -------------------------------------------------------------------------- //
+// Hierarchical organisation: the first level of the search (against the block
+// index) is performed here, upon the final state, such that only the search
+// within the target block remains in S3. In the flat organisation, the
+// outcome is unused.
+//
+v_pipe_update_idx u_s2_v_pipe_update_idx (
+  //
+    .i_pipe_key                         (s2_upd_key_r)
+  //
+  , .i_stcur_vld                        (s3_upd_state_w.vld)
+  , .i_stcur_keys                       (s3_upd_state_w.key)
+  //
+  , .o_idx_le                           (s3_upd_idx_le_w)
+  , .o_idx_lt                           (s3_upd_idx_lt_w)
+);
+
 
 assign s3_upd_vld_w = s2_upd_vld_r & (~init_r);
 
@@ -292,8 +332,53 @@ assign s3_upd_size_w = s2_upd_size_r;
 //                                                                            //
 // ========================================================================== //
 
-assign s3_exe_stcur_vld_r = s3_upd_state_r.vld;
-assign s3_exe_stcur_keys_r = s3_upd_state_r.key;
+// -------------------------------------------------------------------------- //
+// With full forwarding, an Update to the same Context issued on the prior
+// cycle is currently in EXE. Its outcome is forwarded directly into the
+// compare stage. This places EXE and the comparators in series and is
+// therefore the critical path of this configuration. Without, the stimulus
+// is constrained such that this case does not arise.
+//
+assign s3_upd_state_fwd_exe =
+    cfg_pkg::UPDATE_FULL_FORWARD &
+    wrbk_vld_w & (wrbk_prod_id_w == s3_upd_prod_id_r);
+
+assign s3_upd_state_cur =
+   s3_upd_state_fwd_exe ? wrbk_state_w : s3_upd_state_r;
+
+// -------------------------------------------------------------------------- //
+// The block index outcome computed in S2 is stale where state is forwarded
+// from EXE; the first level of the search is then repeated upon the forwarded
+// state. This remains in series with EXE, as before.
+//
+if (cfg_pkg::UPDATE_FULL_FORWARD) begin : s3_idx_fwd_GEN
+
+logic [cfg_pkg::ENTRIES_BLOCKS_N - 1:0]           idx_le_exe;
+logic [cfg_pkg::ENTRIES_BLOCKS_N - 1:0]           idx_lt_exe;
+
+v_pipe_update_idx u_s3_v_pipe_update_idx (
+  //
+    .i_pipe_key                         (s3_upd_key_r)
+  //
+  , .i_stcur_vld                        (wrbk_state_w.vld)
+  , .i_stcur_keys                       (wrbk_state_w.key)
+  //
+  , .o_idx_le                           (idx_le_exe)
+  , .o_idx_lt                           (idx_lt_exe)
+);
+
+assign s3_upd_idx_le_cur = s3_upd_state_fwd_exe ? idx_le_exe : s3_upd_idx_le_r;
+assign s3_upd_idx_lt_cur = s3_upd_state_fwd_exe ? idx_lt_exe : s3_upd_idx_lt_r;
+
+end else begin : s3_idx_GEN
+
+assign s3_upd_idx_le_cur = s3_upd_idx_le_r;
+assign s3_upd_idx_lt_cur = s3_upd_idx_lt_r;
+
+end // block: s3_idx_GEN
+
+assign s3_exe_stcur_vld_r = s3_upd_state_cur.vld;
+assign s3_exe_stcur_keys_r = s3_upd_state_cur.key;
 
 v_pipe_update_cmp u_v_pipe_update_cmp (
   //
@@ -302,6 +387,9 @@ v_pipe_update_cmp u_v_pipe_update_cmp (
   , .i_stcur_vld_r                      (s3_exe_stcur_vld_r)
   , .i_stcur_keys_r                     (s3_exe_stcur_keys_r)
   //
+  , .i_idx_le_r                         (s3_upd_idx_le_cur)
+  , .i_idx_lt_r                         (s3_upd_idx_lt_cur)
+  //
   , .o_match_hit                        (s3_upd_match_hit)
   , .o_match_full                       (s3_upd_match_full)
   , .o_mask_cmp                         (s3_upd_mask_cmp)
@@ -317,7 +405,7 @@ assign s4_upd_prod_id_w = s3_upd_prod_id_r;
 assign s4_upd_cmd_w = s3_upd_cmd_r;
 assign s4_upd_key_w = s3_upd_key_r;
 assign s4_upd_size_w = s3_upd_size_r;
-assign s4_upd_state_w = s3_upd_state_r;
+assign s4_upd_state_w = s3_upd_state_cur;
 assign s4_upd_mask_cmp_w = s3_upd_mask_cmp;
 assign s4_upd_match_hit_w = s3_upd_match_hit;
 assign s4_upd_match_full_w = s3_upd_match_full;
@@ -334,6 +422,7 @@ assign s4_upd_match_sel_w = s3_upd_match_sel;
 assign s4_exe_stcur_vld_r = s4_upd_state_r.vld;
 assign s4_exe_stcur_keys_r = s4_upd_state_r.key;
 assign s4_exe_stcur_volumes_r = s4_upd_state_r.volume;
+assign s4_exe_stcur_cums_r = s4_upd_state_r.cum;
 assign s4_exe_stcur_listsize_r = s4_upd_state_r.listsize;
 
 // -------------------------------------------------------------------------- //
@@ -351,11 +440,13 @@ v_pipe_update_exe u_v_pipe_update_exe (
   , .i_stcur_vld_r                      (s4_exe_stcur_vld_r)
   , .i_stcur_keys_r                     (s4_exe_stcur_keys_r)
   , .i_stcur_volumes_r                  (s4_exe_stcur_volumes_r)
+  , .i_stcur_cums_r                     (s4_exe_stcur_cums_r)
   , .i_stcur_listsize_r                 (s4_exe_stcur_listsize_r)
   //
   , .o_stnxt_vld                        (s4_exe_stnxt_vld)
   , .o_stnxt_keys                       (s4_exe_stnxt_keys)
   , .o_stnxt_volumes                    (s4_exe_stnxt_volumes)
+  , .o_stnxt_cums                       (s4_exe_stnxt_cums)
   , .o_stnxt_listsize                   (s4_exe_stnxt_listsize)
   //
   , .o_notify_vld                       (exe_notify_vld)
@@ -371,6 +462,7 @@ assign wrbk_state_w.vld = s4_exe_stnxt_vld;
 assign wrbk_state_w.listsize = s4_exe_stnxt_listsize;
 assign wrbk_state_w.key = s4_exe_stnxt_keys;
 assign wrbk_state_w.volume = s4_exe_stnxt_volumes;
+assign wrbk_state_w.cum = s4_exe_stnxt_cums;
 
 // -------------------------------------------------------------------------- //
 // Emit messages
@@ -413,6 +505,8 @@ assign o_s4_upd_vld_r = s4_upd_vld_r;
 assign o_s4_upd_prod_id_r = s4_upd_prod_id_r;
 assign o_s5_upd_vld_r = wrbk_vld_r;
 assign o_s5_upd_prod_id_r = wrbk_prod_id_r;
+assign o_s4_upd_state = wrbk_state_w;
+assign o_s5_upd_state_r = wrbk_state_r;
 
 endmodule // v_pipe_update
 
@@ -40,6 +40,12 @@ module v_pipe_update_cmp (
 , input wire logic [cfg_pkg::ENTRIES_N - 1:0]        i_stcur_vld_r
 , input wire v_pkg::key_t [cfg_pkg::ENTRIES_N - 1:0] i_stcur_keys_r
 
+// -------------------------------------------------------------------------- //
+// Block Index Interface (hierarchical organisation only; see
+// v_pipe_update_idx)
+, input wire logic [cfg_pkg::ENTRIES_BLOCKS_N - 1:0] i_idx_le_r
+, input wire logic [cfg_pkg::ENTRIES_BLOCKS_N - 1:0] i_idx_lt_r
+
 // -------------------------------------------------------------------------- //
 // Command Interface
 , output wire logic                                  o_match_hit
@@ -59,16 +65,23 @@ logic [cfg_pkg::ENTRIES_N - 1:0]           match_sel;
 logic                                      match_hit;
 logic                                      match_full;
 
-logic [cfg_pkg::ENTRIES_N - 1:0]           cmp_eq;
-logic [cfg_pkg::ENTRIES_N - 1:0]           cmp_gt;
-logic [cfg_pkg::ENTRIES_N - 1:0]           cmp_lt;
-
 // ========================================================================== //
 //                                                                            //
 //  Table match logic                                                         //
 //                                                                            //
 // ========================================================================== //
 
+// -------------------------------------------------------------------------- //
+// Flag indicating that all Entries in the  context are full
+//
+assign match_full = (i_stcur_vld_r == '1);
+
+if (cfg_pkg::ENTRIES_BLOCKS_N == 1) begin : flat_GEN
+
+logic [cfg_pkg::ENTRIES_N - 1:0]           cmp_eq;
+logic [cfg_pkg::ENTRIES_N - 1:0]           cmp_gt;
+logic [cfg_pkg::ENTRIES_N - 1:0]           cmp_lt;
+
 // -------------------------------------------------------------------------- //
 // Construct one-hot vector denoting the position of matching keys in the
 // current state (if any).
@@ -84,17 +97,6 @@ end // for (genvar i = 0; i < cfg_pkg::ENTRIES_N; i++)
 //
 assign match_hit = (match_sel != '0);
 
-// -------------------------------------------------------------------------- //
-// Flag indicating that all Entries in the  context are full
-//
-assign match_full = (i_stcur_vld_r == '1);
-
-// ========================================================================== //
-//                                                                            //
-//  Comparison                                                                //
-//                                                                            //
-// ========================================================================== //
-
 // -------------------------------------------------------------------------- //
 // Compare table keys against current command key.a
 //
@@ -126,6 +128,156 @@ end : cmp_GEN
 assign mask_cmp =
    i_stcur_vld_r & (cmp_eq | (cfg_pkg::IS_BID_TABLE ? cmp_gt : cmp_lt));
 
+end else begin : blk_GEN
+
+// -------------------------------------------------------------------------- //
+// Hierarchical organisation: the Context is retained as sorted, packed blocks
+// (all blocks but the last are fully occupied). Each block is indexed by its
+// tail (last) key. The search proceeds in two levels: first against the index
+// (one comparator per block) to locate the target block, then within the
+// target block (one comparator per entry of the block). The comparator count
+// is therefore (ENTRIES_BLOCKS_N + 2 * ENTRIES_BLOCK_N), rather than
+// ENTRIES_N.
+//
+// The two levels are pipelined: the index comparison is performed on the
+// prior stage (v_pipe_update_idx) and its outcome is presented, registered,
+// on i_idx_le_r/i_idx_lt_r. This stage selects the target block and performs
+// the comparison within it.
+//
+localparam int B = cfg_pkg::ENTRIES_BLOCK_N;
+localparam int NB = cfg_pkg::ENTRIES_BLOCKS_N;
+
+typedef logic [B - 1:0]                    blk_vld_t;
+typedef v_pkg::key_t [B - 1:0]             blk_keys_t;
+
+blk_vld_t [NB - 1:0]                       stcur_blk_vld;
+blk_keys_t [NB - 1:0]                      stcur_blk_keys;
+
+logic [NB - 1:0]                           idx_le;
+logic [NB - 1:0]                           idx_lt_key;
+
+logic [NB - 1:0]                           add_blk_sel;
+blk_vld_t                                  add_blk_vld;
+blk_keys_t                                 add_blk_keys;
+logic [B - 1:0]                            add_cmp_eq;
+logic [B - 1:0]                            add_cmp_gt;
+logic [B - 1:0]                            add_cmp_lt;
+blk_vld_t                                  add_blk_mask_cmp;
+
+logic [NB - 1:0]                           match_blk_sel;
+blk_vld_t                                  match_blk_vld;
+blk_keys_t                                 match_blk_keys;
+blk_vld_t                                  match_blk_sel_ent;
+
+// Block view of state (a reinterpretation; entry 'i' resides in block
+// 'i / B' at position 'i % B').
+assign stcur_blk_vld = i_stcur_vld_r;
+assign stcur_blk_keys = i_stcur_keys_r;
+
+// -------------------------------------------------------------------------- //
+// Index: blocks which are ordered wholly before (or equal to) the key, and
+// those ordered wholly before the key, as computed on the prior stage.
+//
+assign idx_le = i_idx_le_r;
+assign idx_lt_key = i_idx_lt_r;
+
+// -------------------------------------------------------------------------- //
+// Add: the insertion position resides in the first block which is not ordered
+// wholly before (or equal to) the key. Blocks prior are wholly within the
+// comparison mask, and blocks following are wholly outside it.
+//
+lzd #(.W(NB), .DETECT_ZERO(1), .FROM_LSB(1)) u_add_lzd (
+  //
+    .i_x                                (idx_le)
+  //
+  , .o_y                                (add_blk_sel)
+);
+
+mux #(.N(NB), .W(B)) u_add_vld_mux (
+//
+  .i_x                                  (stcur_blk_vld)
+, .i_sel                                (add_blk_sel)
+//
+, .o_y                                  (add_blk_vld)
+);
+
+mux #(.N(NB), .W(B * v_pkg::KEY_BITS)) u_add_keys_mux (
+//
+  .i_x                                  (stcur_blk_keys)
+, .i_sel                                (add_blk_sel)
+//
+, .o_y                                  (add_blk_keys)
+);
+
+for (genvar i = 0; i < B; i++) begin : add_cmp_GEN
+
+cmp #(.W(v_pkg::KEY_BITS)) u_cmp (
+//
+  .i_a                                  (add_blk_keys [i])
+, .i_b                                  (i_pipe_key_r)
+//
+, .o_eq                                 (add_cmp_eq [i])
+, .o_gt                                 (add_cmp_gt [i])
+, .o_lt                                 (add_cmp_lt [i])
+);
+
+end : add_cmp_GEN
+
+assign add_blk_mask_cmp = add_blk_vld &
+   (add_cmp_eq | (cfg_pkg::IS_BID_TABLE ? add_cmp_gt : add_cmp_lt));
+
+// -------------------------------------------------------------------------- //
+// Delete/Replace: the first entry equal to the key (if any) resides in the
+// first block which is not ordered wholly before the key. As in the flat
+// organisation, only the right-most match is subsequently considered.
+//
+lzd #(.W(NB), .DETECT_ZERO(1), .FROM_LSB(1)) u_match_lzd (
+  //
+    .i_x                                (idx_lt_key)
+  //
+  , .o_y                                (match_blk_sel)
+);
+
+mux #(.N(NB), .W(B)) u_match_vld_mux (
+//
+  .i_x                                  (stcur_blk_vld)
+, .i_sel                                (match_blk_sel)
+//
+, .o_y                                  (match_blk_vld)
+);
+
+mux #(.N(NB), .W(B * v_pkg::KEY_BITS)) u_match_keys_mux (
+//
+  .i_x                                  (stcur_blk_keys)
+, .i_sel                                (match_blk_sel)
+//
+, .o_y                                  (match_blk_keys)
+);
+
+for (genvar i = 0; i < B; i++) begin : match_GEN
+
+assign match_blk_sel_ent [i] =
+    match_blk_vld [i] & (i_pipe_key_r == match_blk_keys [i]);
+
+end : match_GEN
+
+assign match_hit = (match_blk_sel_ent != '0);
+
+// -------------------------------------------------------------------------- //
+// Expand the block-level outcome to the (flat) form expected by EXE.
+//
+for (genvar j = 0; j < NB; j++) begin : expand_GEN
+
+assign mask_cmp [j * B +: B] =
+    ({B{idx_le [j]}} & stcur_blk_vld [j]) |
+    ({B{add_blk_sel [j]}} & add_blk_mask_cmp);
+
+assign match_sel [j * B +: B] = {B{match_blk_sel [j]}} & match_blk_sel_ent;
+
+end : expand_GEN
+
+end // block: blk_GEN
+
 // ========================================================================== //
 //                                                                            //
 //  Outputs                                                                   //
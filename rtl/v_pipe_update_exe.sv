@@ -47,6 +47,7 @@ module v_pipe_update_exe (
 , input wire logic [cfg_pkg::ENTRIES_N - 1:0]            i_stcur_vld_r
 , input wire v_pkg::key_t [cfg_pkg::ENTRIES_N - 1:0]     i_stcur_keys_r
 , input wire v_pkg::volume_t [cfg_pkg::ENTRIES_N - 1:0]  i_stcur_volumes_r
+, input wire v_pkg::cum_t [cfg_pkg::ENTRIES_N - 1:0]     i_stcur_cums_r
 //
 , input wire v_pkg::listsize_t                           i_stcur_listsize_r
 
@@ -55,6 +56,7 @@ module v_pipe_update_exe (
 , output wire logic [cfg_pkg::ENTRIES_N - 1:0]           o_stnxt_vld
 , output wire v_pkg::key_t [cfg_pkg::ENTRIES_N - 1:0]    o_stnxt_keys
 , output wire v_pkg::volume_t [cfg_pkg::ENTRIES_N - 1:0] o_stnxt_volumes
+, output wire v_pkg::cum_t [cfg_pkg::ENTRIES_N - 1:0]    o_stnxt_cums
 //
 , output wire v_pkg::listsize_t                          o_stnxt_listsize
 
@@ -120,10 +122,19 @@ logic [cfg_pkg::ENTRIES_N - 1:0]           stnxt_volumes_do_upt;
 v_pkg::volume_t [cfg_pkg::ENTRIES_N - 1:0] stnxt_volumes_upt;
 v_pkg::volume_t [cfg_pkg::ENTRIES_N - 1:0] stnxt_volumes;
 
+// Cumulative Volume:
+logic [cfg_pkg::ENTRIES_N - 1:0]           cum_do_upt;
+v_pkg::cum_t                               cum_delta;
+v_pkg::cum_t [cfg_pkg::ENTRIES_N - 1:0]    cum_take_right;
+v_pkg::cum_t [cfg_pkg::ENTRIES_N - 1:0]    cum_take_left;
+v_pkg::cum_t [cfg_pkg::ENTRIES_N - 1:0]    cum_base;
+v_pkg::cum_t [cfg_pkg::ENTRIES_N - 1:0]    stnxt_cums;
+
 // Notify:
 logic                                      notify_cleared_list;
 logic                                      notify_did_add;
 logic                                      notify_did_del;
+logic                                      notify_did_rep;
 logic                                      notify_did_rep_or_del;
 logic                                      notify_vld;
 v_pkg::key_t                               notify_key;
@@ -334,10 +345,11 @@ assign mask_left = ({cfg_pkg::ENTRIES_N{op_del}} & del_mask_left);
 assign mask_insert_key = ({cfg_pkg::ENTRIES_N{op_add}} & add_mask_insert);
 
 // -------------------------------------------------------------------------- //
-// Update volume on ADD or REPlacement commands
+// Update volume on ADD or REPlacement commands. As with delete, a replacement
+// is applied to only the right-most matching element.
 //
 assign mask_insert_vol = ({cfg_pkg::ENTRIES_N{op_add}} & add_mask_insert) |
-                         ({cfg_pkg::ENTRIES_N{op_rep}} & i_pipe_match_sel_r);
+                         ({cfg_pkg::ENTRIES_N{op_rep}} & del_sel);
 
 // -------------------------------------------------------------------------- //
 // State update logic
@@ -422,6 +434,61 @@ for (genvar i = 0; i < cfg_pkg::ENTRIES_N; i++) begin : upt_GEN
 
 end : upt_GEN
 
+// ========================================================================== //
+//                                                                            //
+//  Cumulative Volume                                                         //
+//                                                                            //
+// ========================================================================== //
+
+// -------------------------------------------------------------------------- //
+// The cumulative volume of each entry (the sum of its volume and those of all
+// entries ahead of it) is retained alongside its volume and is updated
+// incrementally. A command modifies the cumulative volume of only those
+// entries at, or behind, the entry inserted, removed or replaced. Each takes
+// the cumulative volume of the entry which it accepts, offset by a single
+// delta common to all entries:
+//
+//  Add     cum'[i] = cum[i - 1] + volume                   (i >= insertion)
+//
+//  Del     cum'[i] = cum[i + 1] - volume[match]            (i >= match)
+//
+//  Rep     cum'[i] = cum[i] + volume - volume[match]       (i >= match)
+//
+// (where cum[-1] is zero). The update therefore requires a single adder per
+// entry, each in parallel, rather than a carry chain across the Context. On a
+// clear, the cumulative volumes are invalidated alongside the entries.
+//
+assign cum_do_upt = ({cfg_pkg::ENTRIES_N{op_add}} & add_mask_left) |
+                    ({cfg_pkg::ENTRIES_N{op_del | op_rep}} & del_mask_left);
+
+assign cum_delta =
+    ({v_pkg::CUM_BITS{op_add | op_rep}} & v_pkg::cum_t'(i_pipe_volume_r)) -
+    ({v_pkg::CUM_BITS{op_del | op_rep}} & v_pkg::cum_t'(match_volume));
+
+// -------------------------------------------------------------------------- //
+// Accept right (on add; the right-most entry has no predecessor), or accept
+// left (on delete; the left-most entry is invalidated).
+//
+assign cum_take_right =
+    {i_stcur_cums_r [cfg_pkg::ENTRIES_N - 2:0], v_pkg::cum_t'(0)};
+assign cum_take_left =
+    {i_stcur_cums_r [cfg_pkg::ENTRIES_N - 1],
+     i_stcur_cums_r [cfg_pkg::ENTRIES_N - 1:1]};
+
+for (genvar i = 0; i < cfg_pkg::ENTRIES_N; i++) begin : cum_GEN
+
+  assign cum_base [i] =
+      ({v_pkg::CUM_BITS{op_add}} & cum_take_right [i]) |
+      ({v_pkg::CUM_BITS{op_del}} & cum_take_left [i]) |
+      ({v_pkg::CUM_BITS{op_rep}} & i_stcur_cums_r [i]);
+
+  // Select update or retain prior.
+  assign stnxt_cums [i] =
+      ({v_pkg::CUM_BITS{ cum_do_upt [i]}} & (cum_base [i] + cum_delta)) |
+      ({v_pkg::CUM_BITS{~cum_do_upt [i]}} & i_stcur_cums_r [i]);
+
+end : cum_GEN
+
 // ========================================================================== //
 //                                                                            //
 //  List Size                                                                 //
@@ -470,6 +537,11 @@ assign notify_did_add = op_add & add_mask_insert [0];
 //
 assign notify_did_del = op_del & i_pipe_match_sel_r [0];
 
+// -------------------------------------------------------------------------- //
+// Notify on replacement command on the head element.
+//
+assign notify_did_rep = op_rep & i_pipe_match_sel_r [0];
+
 // -------------------------------------------------------------------------- //
 // Notify on delete to or replacement on head element
 //
@@ -489,22 +561,24 @@ assign notify_vld =
 assign notify_key = i_pipe_key_r;
 
 // -------------------------------------------------------------------------- //
-// Select volume for matching Entry
+// Select volume for matching Entry (prioritized, as the match vector is not
+// 1-hot whenever duplicate keys are present).
 //
 mux #(.N(cfg_pkg::ENTRIES_N), .W(v_pkg::VOLUME_BITS)) u_max_match_volume (
   //
     .i_x                      (i_stcur_volumes_r)
-  , .i_sel                    (i_pipe_match_sel_r)
+  , .i_sel                    (del_sel)
   //
   , .o_y                      (match_volume)
 );
 
 // -------------------------------------------------------------------------- //
-// Notify volume is the volume placed into the head position, or the value just
-// removed. On clear, we don't case since the volume is to become invalid and we
-// don't consider if the context was initially empty.
+// Notify volume is the volume placed into the head position (on add or
+// replacement), or the value just removed. On clear, we don't case since the
+// volume is to become invalid and we don't consider if the context was
+// initially empty.
 assign notify_volume =
-  ({v_pkg::VOLUME_BITS{notify_did_add}} & i_pipe_volume_r) |
+  ({v_pkg::VOLUME_BITS{notify_did_add | notify_did_rep}} & i_pipe_volume_r) |
   ({v_pkg::VOLUME_BITS{notify_did_del}} & match_volume);
 
 // ========================================================================== //
@@ -515,6 +589,7 @@ assign notify_volume =
 
 assign o_stnxt_keys = stnxt_keys;
 assign o_stnxt_volumes = stnxt_volumes;
+assign o_stnxt_cums = stnxt_cums;
 assign o_stnxt_listsize = stnxt_listsize;
 
 assign o_notify_vld =  notify_vld;
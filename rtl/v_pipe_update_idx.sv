@@ -0,0 +1,123 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+`include "common_defs.vh"
+
+`include "v_pkg.vh"
+`include "cfg_pkg.vh"
+
+module v_pipe_update_idx (
+// -------------------------------------------------------------------------- //
+// Command Interface
+  input wire v_pkg::key_t                            i_pipe_key
+
+// -------------------------------------------------------------------------- //
+// State Current
+, input wire logic [cfg_pkg::ENTRIES_N - 1:0]        i_stcur_vld
+, input wire v_pkg::key_t [cfg_pkg::ENTRIES_N - 1:0] i_stcur_keys
+
+// -------------------------------------------------------------------------- //
+// Block Index Interface
+, output wire logic [cfg_pkg::ENTRIES_BLOCKS_N - 1:0] o_idx_le
+, output wire logic [cfg_pkg::ENTRIES_BLOCKS_N - 1:0] o_idx_lt
+);
+
+// ========================================================================== //
+//                                                                            //
+//  Wires                                                                     //
+//                                                                            //
+// ========================================================================== //
+
+localparam int B = cfg_pkg::ENTRIES_BLOCK_N;
+localparam int NB = cfg_pkg::ENTRIES_BLOCKS_N;
+
+typedef logic [B - 1:0]                    blk_vld_t;
+typedef v_pkg::key_t [B - 1:0]             blk_keys_t;
+
+blk_vld_t [NB - 1:0]                       stcur_blk_vld;
+blk_keys_t [NB - 1:0]                      stcur_blk_keys;
+
+logic [NB - 1:0]                           idx_vld;
+logic [NB - 1:0]                           idx_eq;
+logic [NB - 1:0]                           idx_gt;
+logic [NB - 1:0]                           idx_lt;
+logic [NB - 1:0]                           idx_le;
+logic [NB - 1:0]                           idx_lt_key;
+
+// ========================================================================== //
+//                                                                            //
+//  Block Index                                                               //
+//                                                                            //
+// ========================================================================== //
+
+// -------------------------------------------------------------------------- //
+// First level of the hierarchical search (see v_pipe_update_cmp): the key is
+// compared against the index of the Context, that is, the tail (last) key of
+// each block. The outcome is a function of the key and state alone, and is
+// therefore computed a stage ahead of the remainder of the search, from which
+// it is separated by a register.
+//
+// Block view of state (a reinterpretation; entry 'i' resides in block
+// 'i / B' at position 'i % B').
+assign stcur_blk_vld = i_stcur_vld;
+assign stcur_blk_keys = i_stcur_keys;
+
+// A block whose tail is invalid is not fully occupied (and is the last
+// occupied block, if any).
+//
+for (genvar j = 0; j < NB; j++) begin : idx_GEN
+
+assign idx_vld [j] = stcur_blk_vld [j][B - 1];
+
+cmp #(.W(v_pkg::KEY_BITS)) u_cmp (
+//
+  .i_a                                  (stcur_blk_keys [j][B - 1])
+, .i_b                                  (i_pipe_key)
+//
+, .o_eq                                 (idx_eq [j])
+, .o_gt                                 (idx_gt [j])
+, .o_lt                                 (idx_lt [j])
+);
+
+end : idx_GEN
+
+// Blocks which are ordered wholly before (or equal to) the key; as the
+// Context is sorted, these form a contiguous run from the LSB.
+//
+assign idx_lt_key = idx_vld & (cfg_pkg::IS_BID_TABLE ? idx_gt : idx_lt);
+assign idx_le = idx_lt_key | (idx_vld & idx_eq);
+
+// ========================================================================== //
+//                                                                            //
+//  Outputs                                                                   //
+//                                                                            //
+// ========================================================================== //
+
+assign o_idx_le = idx_le;
+assign o_idx_lt = idx_lt_key;
+
+endmodule // v_pipe_update_idx
@@ -46,13 +46,18 @@ typedef enum logic [1:0] {
   CMD_REPLACE = 2'b11
 } cmd_t;
 
-typedef logic [63:0] key_t;
+typedef logic [cfg_pkg::KEY_BITS - 1:0] key_t;
 localparam int KEY_BITS = $bits(key_t);
 
-typedef logic [31:0] volume_t;
+typedef logic [cfg_pkg::VOLUME_BITS - 1:0] volume_t;
 localparam int VOLUME_BITS = $bits(volume_t);
 
-typedef logic [31:0] size_t;
+typedef logic [cfg_pkg::VOLUME_BITS - 1:0] size_t;
+
+// Cumulative volume: the sum of the volumes of a level and all levels ahead
+// of it (wide enough to retain the sum of a full Context without overflow).
+typedef logic [VOLUME_BITS + $clog2(cfg_pkg::ENTRIES_N) - 1:0] cum_t;
+localparam int CUM_BITS = $bits(cum_t);
 
 typedef logic [$clog2(cfg_pkg::ENTRIES_N) - 1:0]  level_t;
 
@@ -64,11 +69,33 @@ typedef struct packed {
   logic [cfg_pkg::ENTRIES_N - 1:0] vld;
   key_t [cfg_pkg::ENTRIES_N - 1:0] key;
   volume_t [cfg_pkg::ENTRIES_N - 1:0] volume;
+  cum_t [cfg_pkg::ENTRIES_N - 1:0] cum;
 } state_t;
 localparam int STATE_BITS = $bits(state_t);
 
 typedef logic [$clog2(cfg_pkg::CONTEXT_N) - 1:0] addr_t;
 
+// Snapshot Query response: the leading SNAPSHOT_K levels of a Context.
+typedef logic [cfg_pkg::SNAPSHOT_K - 1:0] snap_vld_t;
+typedef key_t [cfg_pkg::SNAPSHOT_K - 1:0] snap_key_t;
+typedef volume_t [cfg_pkg::SNAPSHOT_K - 1:0] snap_volume_t;
+
+// Bank select (1-hot) and address within bank. The address retains at least
+// one bit where a bank holds a single Context (excluded by rtl.cmake).
+typedef logic [cfg_pkg::UPDATE_PORTS_N - 1:0] bank_t;
+localparam int BANK_ADDR_BITS =
+  (cfg_pkg::BANK_CONTEXT_N > 1) ? $clog2(cfg_pkg::BANK_CONTEXT_N) : 1;
+typedef logic [BANK_ADDR_BITS - 1:0] bank_addr_t;
+
+// Evaluated at int width; UPDATE_PORTS_N need not be representable in id_t.
+function automatic bank_t bank_dec(id_t id);
+  return bank_t'(1) << (int'(id) % cfg_pkg::UPDATE_PORTS_N);
+endfunction
+
+function automatic bank_addr_t bank_addr(id_t id);
+  return bank_addr_t'(int'(id) / cfg_pkg::UPDATE_PORTS_N);
+endfunction
+
 endpackage // v_pkg
 
 `endif
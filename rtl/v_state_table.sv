@@ -0,0 +1,200 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+`include "common_defs.vh"
+
+`include "v_pkg.vh"
+`include "cfg_pkg.vh"
+
+// State table of a bank. The Context state is retained across a number of
+// narrower memory columns (metadata, keys, volumes, cumulative volumes), each
+// of which is indexed by the same address and accessed in unison. This avoids
+// a single very wide word per Context, and maps naturally onto banks of
+// discrete (narrow) RAM macros for deep tables.
+//
+// Each Context is additionally associated with a tag, held in flops, denoting
+// whether its state is live. A Context whose tag is clear reads as empty,
+// irrespective of the contents of the columns. All tags are cleared on
+// initialization, in a single cycle, and an empty state (as produced by a
+// Clear) is retained by clearing the tag alone, without a write to the
+// columns.
+
+module v_state_table (
+// -------------------------------------------------------------------------- //
+// Read Interface
+  input wire logic                                i_ren
+, input wire v_pkg::bank_addr_t                   i_raddr
+//
+, output wire v_pkg::state_t                      o_rdata
+
+// -------------------------------------------------------------------------- //
+// Write Interface
+, input wire logic                                i_wen
+, input wire v_pkg::bank_addr_t                   i_waddr
+, input wire v_pkg::state_t                       i_wdata
+
+// -------------------------------------------------------------------------- //
+// Initialization
+, input wire logic                                init_r
+
+// -------------------------------------------------------------------------- //
+// Clk
+, input wire logic                                clk
+);
+
+// ========================================================================== //
+//                                                                            //
+//  Wires                                                                     //
+//                                                                            //
+// ========================================================================== //
+
+// Metadata column: list size and valid vector.
+localparam int META_BITS = v_pkg::LISTSIZE_W + cfg_pkg::ENTRIES_N;
+localparam int KEY_COL_BITS = cfg_pkg::ENTRIES_N * v_pkg::KEY_BITS;
+localparam int VOLUME_COL_BITS = cfg_pkg::ENTRIES_N * v_pkg::VOLUME_BITS;
+localparam int CUM_COL_BITS = cfg_pkg::ENTRIES_N * v_pkg::CUM_BITS;
+
+logic [META_BITS - 1:0]                 meta_rdata;
+logic [META_BITS - 1:0]                 meta_wdata;
+logic [KEY_COL_BITS - 1:0]              key_rdata;
+logic [VOLUME_COL_BITS - 1:0]           volume_rdata;
+logic [CUM_COL_BITS - 1:0]              cum_rdata;
+logic                                   tag_rdata;
+logic                                   tag_wdata;
+logic                                   col_wen;
+
+// ========================================================================== //
+//                                                                            //
+//  Tags                                                                      //
+//                                                                            //
+// ========================================================================== //
+
+// The state is live if any Entry is valid; otherwise, it is equivalent to the
+// initial (empty) state.
+assign tag_wdata = (i_wdata.vld != '0);
+
+// -------------------------------------------------------------------------- //
+//
+tag1r1w #(.N(cfg_pkg::BANK_CONTEXT_N)) u_tag1r1w (
+  //
+    .i_ren                              (i_ren)
+  , .i_raddr                            (i_raddr)
+  , .o_rdata                            (tag_rdata)
+  //
+  , .i_wen                              (i_wen)
+  , .i_waddr                            (i_waddr)
+  , .i_wdata                            (tag_wdata)
+  //
+  , .i_clr                              (init_r)
+  //
+  , .clk                                (clk)
+);
+
+// Columns are written only where the resultant state is live.
+assign col_wen = i_wen & tag_wdata;
+
+// ========================================================================== //
+//                                                                            //
+//  Columns                                                                   //
+//                                                                            //
+// ========================================================================== //
+
+assign meta_wdata = {i_wdata.listsize, i_wdata.vld};
+
+// -------------------------------------------------------------------------- //
+//
+sram1r1w #(.N(cfg_pkg::BANK_CONTEXT_N), .W(META_BITS)) u_sram1r1w_meta (
+  //
+    .i_ren                              (i_ren)
+  , .i_raddr                            (i_raddr)
+  , .o_rdata                            (meta_rdata)
+  //
+  , .i_wen                              (col_wen)
+  , .i_waddr                            (i_waddr)
+  , .i_wdata                            (meta_wdata)
+  //
+  , .clk                                (clk)
+);
+
+// -------------------------------------------------------------------------- //
+//
+sram1r1w #(.N(cfg_pkg::BANK_CONTEXT_N), .W(KEY_COL_BITS)) u_sram1r1w_key (
+  //
+    .i_ren                              (i_ren)
+  , .i_raddr                            (i_raddr)
+  , .o_rdata                            (key_rdata)
+  //
+  , .i_wen                              (col_wen)
+  , .i_waddr                            (i_waddr)
+  , .i_wdata                            (i_wdata.key)
+  //
+  , .clk                                (clk)
+);
+
+// -------------------------------------------------------------------------- //
+//
+sram1r1w #(.N(cfg_pkg::BANK_CONTEXT_N), .W(VOLUME_COL_BITS)) u_sram1r1w_volume (
+  //
+    .i_ren                              (i_ren)
+  , .i_raddr                            (i_raddr)
+  , .o_rdata                            (volume_rdata)
+  //
+  , .i_wen                              (col_wen)
+  , .i_waddr                            (i_waddr)
+  , .i_wdata                            (i_wdata.volume)
+  //
+  , .clk                                (clk)
+);
+
+// -------------------------------------------------------------------------- //
+//
+sram1r1w #(.N(cfg_pkg::BANK_CONTEXT_N), .W(CUM_COL_BITS)) u_sram1r1w_cum (
+  //
+    .i_ren                              (i_ren)
+  , .i_raddr                            (i_raddr)
+  , .o_rdata                            (cum_rdata)
+  //
+  , .i_wen                              (col_wen)
+  , .i_waddr                            (i_waddr)
+  , .i_wdata                            (i_wdata.cum)
+  //
+  , .clk                                (clk)
+);
+
+// ========================================================================== //
+//                                                                            //
+//  Outputs                                                                   //
+//                                                                            //
+// ========================================================================== //
+
+// Columns are concatenated in the order of the (packed) state structure; the
+// state of a Context which is not live is empty.
+assign o_rdata =
+    {v_pkg::STATE_BITS{tag_rdata}} &
+    {meta_rdata, key_rdata, volume_rdata, cum_rdata};
+
+endmodule // v_state_table
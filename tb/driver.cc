@@ -29,11 +29,16 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string_view>
+#include <vector>
 
 #include "log.h"
 #include "model.h"
 #include "rnd.h"
+#include "snapshot.h"
+#include "stats.h"
 #include "tb.h"
 #include "test.h"
 
@@ -62,10 +67,16 @@ class Driver {
   void execute();
   void print_usage(std::ostream& os) const;
   void print_tests(std::ostream& os, bool as_json = false) const;
+  std::vector<const tb::TestBuilder*> select_tests();
   int report(bool failed = false) const;
 
   tb::TestRegistry tr_;
   int status_ = 0;
+  bool run_all_ = false;
+  bool stats_ = false;
+  std::optional<std::string> stats_json_fn_;
+  std::optional<std::string> preload_fn_;
+  bool preload_full_ = false;
   std::unique_ptr<std::ofstream> ofs_;
 };
 
@@ -94,7 +105,7 @@ int Driver::run(int argc, char** argv) {
     std::cout << "Driver execution failed with:" << ex.what() << "!\n";
     failed = true;
   }
-  return report(failed);
+  return report(failed || (status_ != 0));
 }
 
 auto Driver::parse_args(int argc, char** argv) -> ArgResult {
@@ -134,9 +145,34 @@ auto Driver::parse_args(int argc, char** argv) -> ArgResult {
       status_ = 1;
       return ArgResult::Bad;
 #endif
+    } else if (is_one_of(argstr, "--record")) {
+      // --record: Record driven stimulus to trace file.
+      tb::Sim::record_fn = vs.at(++i);
+    } else if (is_one_of(argstr, "--preload")) {
+      // --preload: Preload state tables from book snapshot file.
+      preload_fn_ = vs.at(++i);
+    } else if (is_one_of(argstr, "--preload-full")) {
+      // --preload-full: Preload state tables with a random, full book.
+      preload_full_ = true;
+    } else if (is_one_of(argstr, "--stats")) {
+      // --stats: Print interface statistics on completion of each test.
+      stats_ = true;
+    } else if (is_one_of(argstr, "--stats-json")) {
+      // --stats-json: Write interface statistics (per test) to JSON file.
+      stats_json_fn_ = vs.at(++i);
     } else if (is_one_of(argstr, "--run")) {
-      // -r|--run: Testname to run.
-      tb::Sim::test_name = vs.at(++i);
+      // -r|--run: Testname(s) to run (comma-separated).
+      std::string_view names{vs.at(++i)};
+      std::string_view::size_type j;
+      do {
+        j = names.find(',');
+        tb::Sim::test_names.emplace_back(names.substr(0, j));
+        names.remove_prefix((j == std::string_view::npos) ? names.size()
+                                                          : (j + 1));
+      } while (j != std::string_view::npos);
+    } else if (is_one_of(argstr, "--run-all")) {
+      // --run-all: Run all testcases which do not require arguments.
+      run_all_ = true;
     } else if (is_one_of(argstr, "-e", "--errors")) {
       // -e|--errors: Tolerated error count (integer)
       const std::string sstr{vs.at(++i)};
@@ -154,26 +190,105 @@ auto Driver::parse_args(int argc, char** argv) -> ArgResult {
 }
 
 void Driver::finalize() {
+  if (preload_fn_) {
+    tb::Sim::snapshot =
+        std::make_shared<tb::Snapshot>(tb::Snapshot::load(*preload_fn_));
+  } else if (preload_full_) {
+    tb::Sim::snapshot = std::make_shared<tb::Snapshot>(
+        tb::Snapshot::full(tb::Sim::random.get()));
+  }
   tb::Sim::kernel = std::make_unique<tb::Kernel>();
 }
 
+std::vector<const tb::TestBuilder*> Driver::select_tests() {
+  std::vector<const tb::TestBuilder*> tbs;
+  if (run_all_) {
+    for (const tb::TestBuilder* tb : tr_.tests()) {
+      // Parameterized tests must be named explicitly.
+      if (!tb->has_args()) tbs.push_back(tb);
+    }
+  }
+  for (const std::string& name : tb::Sim::test_names) {
+    if (const tb::TestBuilder* tb = tr_.get(name); tb != nullptr) {
+      tbs.push_back(tb);
+    } else {
+      std::cout << "Unknown test: " << name << "\n";
+      status_ = 1;
+    }
+  }
+  return tbs;
+}
+
 void Driver::execute() {
-  if (!tb::Sim::test_name) {
+  const std::vector<const tb::TestBuilder*> tbs{select_tests()};
+  if (status_ != 0) return;
+
+  if (tbs.empty()) {
     std::cout << "No testname provided!\n";
     print_usage(std::cout);
     status_ = 1;
-  } else if (const tb::TestBuilder* tb = tr_.get(*tb::Sim::test_name);
-             tb != nullptr) {
+    return;
+  }
+  if (tb::Sim::record_fn && (tbs.size() > 1)) {
+    throw std::runtime_error("Stimulus may be recorded from one test only");
+  }
+
+  // Tests are run in sequence on the same Kernel; the UUT is reset and the
+  // model cleared at the start of each. Error and warning counts are
+  // retained per test, such that each passes or fails independently.
+  int errors = 0, warnings = 0;
+  std::size_t failed_n = 0;
+  tb::JsonDict stats_json;
+  for (const tb::TestBuilder* tb : tbs) {
+    tb::Sim::errors = 0;
+    tb::Sim::warnings = 0;
+    tb::Sim::fail_class.reset();
+
     tb::Scope* test_scope{nullptr};
     if (tb::Sim::logger) {
       test_scope = tb::Sim::logger->top()->create_child("test");
     }
     std::unique_ptr<tb::Test> t{tb->construct(test_scope)};
-    status_ = t->run() ? 1 : 0;
-  } else {
-    std::cout << "Unknown test: " << *tb::Sim::test_name << "\n";
-    status_ = 1;
+    const bool failed =
+        t->run() || (tb::Sim::errors != 0) || (tb::Sim::warnings != 0);
+    if (failed) {
+      ++failed_n;
+      status_ = 1;
+    }
+    if (tb::Sim::model) {
+      const tb::Stats& stats{tb::Sim::model->stats()};
+      if (stats_) {
+        std::cout << tb->name() << " ";
+        stats.report(std::cout);
+      }
+      if (stats_json_fn_) stats_json.add(tb->name(), stats.to_json());
+    }
+    if (tbs.size() > 1) {
+      std::cout << (failed ? "[FAIL] " : "[PASS] ") << tb->name()
+                << " (errors: " << tb::Sim::errors
+                << ", warnings: " << tb::Sim::warnings << ")\n";
+    }
+    errors += tb::Sim::errors;
+    warnings += tb::Sim::warnings;
   }
+  tb::Sim::kernel->end();
+
+  if (stats_json_fn_) {
+    std::ofstream ofs{*stats_json_fn_};
+    if (!ofs) {
+      throw std::runtime_error("Unable to open statistics file: " +
+                               *stats_json_fn_);
+    }
+    stats_json.serialize(ofs);
+    ofs << "\n";
+  }
+
+  if (tbs.size() > 1) {
+    std::cout << (tbs.size() - failed_n) << "/" << tbs.size()
+              << " test(s) passed\n";
+  }
+  tb::Sim::errors = errors;
+  tb::Sim::warnings = warnings;
 }
 
 void Driver::print_usage(std::ostream& os) const {
@@ -187,7 +302,13 @@ void Driver::print_usage(std::ostream& os) const {
 #ifndef ENABLE_VCD
      << "   --vcd             Enable waveform tracing (VCD)\n"
 #endif
-     << "   --run <test>      Run testcase\n"
+     << "   --record <file>   Record driven stimulus to trace file\n"
+     << "   --preload <file>  Preload state tables from book snapshot\n"
+     << "   --preload-full    Preload state tables with random, full book\n"
+     << "   --stats           Print interface statistics per testcase\n"
+     << "   --stats-json <f>  Write interface statistics to JSON file\n"
+     << "   --run <test>[,..] Run testcase(s) in sequence\n"
+     << "   --run-all         Run all testcases without arguments\n"
      << "   -e|--errors <arg> Tolerated error count\n"
      << "   -a|--args <arg>   Append testcase argument\n";
 }
@@ -223,6 +344,9 @@ int Driver::report(bool failed) const {
     logger->write(thin_row);
     logger->write("   Error(s)   - ", tb::Sim::errors);
     logger->write("   Warning(s) - ", tb::Sim::warnings);
+    if (tb::Sim::fail_class) {
+      logger->write("   Mismatch   - ", *tb::Sim::fail_class);
+    }
     logger->write(thick_row);
     logger->write(issue_n ? tb::Sim::fail_note : tb::Sim::pass_note);
   }
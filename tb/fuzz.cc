@@ -0,0 +1,242 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+// libFuzzer front end. Each input is decoded into a cycle-level stream of
+// Update and Query commands which is driven onto the UUT and checked against
+// the model. The Kernel persists across inputs: the UUT is reset in-process
+// at the start of each run. Feedback is provided by the SanitizerCoverage
+// instrumentation of the verilated model (which follows the branch structure
+// of the RTL) and by a set of functional coverage counters (pipeline
+// occupancy, forwarding, Context occupancy and duplicate keys) exported to
+// libFuzzer as extra counters.
+//
+// On mismatch, the decoded stream is written to 'fuzz-crash.trace' (for use
+// with Replay and Minimise) and the process aborts.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "Vobj/Vtb.h"
+#include "cfg.h"
+#include "model.h"
+#include "rnd.h"
+#include "stats.h"
+#include "tb.h"
+#include "trace.h"
+#include "tests/reset.h"
+
+namespace {
+
+// Bytes consumed per cycle of stimulus.
+constexpr const std::size_t FRAME_BYTES = 6;
+
+// Cycles of stimulus per input, at most.
+constexpr const std::size_t FRAMES_MAX = 4096;
+
+// Cycles for which the UUT is run following the final command.
+constexpr const int WIND_DOWN_N = 10;
+
+// Keys are drawn from a small alphabet such that duplicates, and the
+// replacement of the head Entry, are commonplace.
+constexpr const tb::key_t KEYS_N = 32;
+
+// Functional coverage counters.
+constexpr const std::size_t OCC_N = 64;
+constexpr const std::size_t COV_PIPE_BASE = 0;
+constexpr const std::size_t COV_PIPE_N = 32 * 16;
+constexpr const std::size_t COV_UPD_BASE = COV_PIPE_BASE + COV_PIPE_N;
+constexpr const std::size_t COV_UPD_N = 4 * OCC_N * 2;
+constexpr const std::size_t COV_LUT_BASE = COV_UPD_BASE + COV_UPD_N;
+constexpr const std::size_t COV_LUT_N = 2 * OCC_N;
+constexpr const std::size_t COV_NR_BASE = COV_LUT_BASE + COV_LUT_N;
+constexpr const std::size_t COV_NR_N = OCC_N;
+constexpr const std::size_t COV_N = COV_NR_BASE + COV_NR_N;
+
+__attribute__((used, section("__libfuzzer_extra_counters")))
+std::array<std::uint8_t, COV_N> coverage;
+
+void cover(std::size_t i) {
+  if (coverage[i] != 0xFF) ++coverage[i];
+}
+
+std::size_t occupancy_bin(std::size_t n) { return std::min(n, OCC_N - 1); }
+
+tb::Cmd decode_cmd(std::uint8_t b) {
+  // Add is weighted such that Contexts fill (and overflow).
+  switch ((b >> 1) & 0x7) {
+    case 4: return tb::Cmd::Del;
+    case 5: return tb::Cmd::Rep;
+    case 6: return tb::Cmd::Clr;
+    default: return tb::Cmd::Add;
+  }
+}
+
+// Decode input to a stream of frames. Update commands which would violate
+// the same-Context spacing rule are dropped.
+std::vector<tb::trace::Frame> decode(const std::uint8_t* data,
+                                     std::size_t size) {
+  std::vector<tb::trace::Frame> fs;
+  tb::UpdateSpacing spacing;
+  const std::size_t n = std::min(size / FRAME_BYTES, FRAMES_MAX);
+  fs.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const std::uint8_t* b = data + i * FRAME_BYTES;
+
+    tb::UpdateCommand uc{};
+    if (b[0] & 0x01) {
+      const tb::prod_id_t prod_id = b[1] % cfg::CONTEXT_N;
+      if (spacing.permits(prod_id)) {
+        uc = tb::UpdateCommand{prod_id, decode_cmd(b[0]),
+                               static_cast<tb::key_t>(b[2] % KEYS_N),
+                               static_cast<tb::volume_t>(b[3])};
+      }
+    }
+    spacing.issue(uc);
+
+    tb::QueryCommand qc{};
+    if (b[0] & 0x10) {
+      // Queries optionally target the Context of the concurrent Update, and
+      // are optionally cumulative or Key Lookups.
+      const tb::prod_id_t prod_id =
+          ((b[0] & 0x20) && uc.vld()) ? uc.prod_id() : (b[4] % cfg::CONTEXT_N);
+      if (b[0] & 0x80) {
+        qc = tb::QueryCommand::lookup(prod_id,
+                                      static_cast<tb::key_t>(b[5] % KEYS_N));
+      } else {
+        qc = tb::QueryCommand{
+            prod_id, static_cast<tb::level_t>(b[5] % (cfg::ENTRIES_N + 1)),
+            false, (b[0] & 0x40) != 0};
+      }
+    }
+    fs.push_back(tb::trace::encode(uc, qc));
+  }
+  return fs;
+}
+
+struct FuzzCB : public tb::KernelCallbacks {
+  FuzzCB(const tb::trace::Frame* begin, const tb::trace::Frame* end)
+      : rstt_(nullptr, true), it_(begin), end_(end) {}
+
+  bool on_negedge_clk(Vtb* tb) override {
+    if (!rstt_.is_done()) {
+      rstt_.check_reset(tb);
+      return !rstt_.is_failed();
+    }
+
+    sample(tb);
+
+    if (it_ == end_) {
+      tb::VDriver::issue(tb, tb::UpdateCommand{});
+      tb::VDriver::issue(tb, tb::QueryCommand{});
+      return (--wind_down_n_ > 0);
+    }
+
+    const tb::trace::Frame& f{*it_++};
+    const tb::UpdateCommand uc{tb::trace::decode(f.uc)};
+    tb::VDriver::issue(tb, uc);
+    tb::VDriver::issue(tb, tb::trace::decode(f.qc));
+    if (uc.vld()) {
+      // Command against the occupancy of the Context prior to issue.
+      const std::size_t occ{
+          occupancy_bin(mv_.active_entries_n(uc.prod_id()))};
+      const bool dup = mv_.has_key(uc.prod_id(), uc.key());
+      cover(COV_UPD_BASE +
+            ((static_cast<std::size_t>(uc.cmd()) * OCC_N + occ) * 2) + dup);
+    }
+    return true;
+  }
+
+ private:
+  void sample(Vtb* tb) {
+    const tb::PipeSample ps{tb::VSampler::pipe(tb)};
+    for (std::size_t b = 0; b < cfg::UPDATE_PORTS_N; ++b) {
+      // S2 forwarding paths qualified by S2, and S3 forwarding by S3.
+      const std::size_t fwd =
+          (((ps.upd_vld[b] >> 1) & 1) ? (ps.upd_fwd[b] & 0x7) : 0) |
+          (((ps.upd_vld[b] >> 2) & 1) ? (ps.upd_fwd[b] & 0x8) : 0);
+      cover(COV_PIPE_BASE + (ps.upd_vld[b] & 0x1F) * 16 + fwd);
+    }
+
+    const tb::QueryResponse qr{tb::VSampler::qr(tb)};
+    if (qr.vld()) {
+      cover(COV_LUT_BASE + (qr.error() ? OCC_N : 0) +
+            occupancy_bin(qr.listsize()));
+    }
+    const tb::NotifyResponse nr{tb::VSampler::nr(tb)};
+    if (nr.vld()) {
+      cover(COV_NR_BASE + occupancy_bin(mv_.active_entries_n(nr.prod_id())));
+    }
+  }
+
+  tb::ResetTracker rstt_;
+  tb::ModelValidation mv_;
+  const tb::trace::Frame* it_;
+  const tb::trace::Frame* end_;
+  int wind_down_n_ = WIND_DOWN_N;
+};
+
+void write_trace(const std::vector<tb::trace::Frame>& fs) {
+  tb::trace::Writer w{"fuzz-crash.trace"};
+  for (const tb::trace::Frame& f : fs) {
+    w.write(tb::trace::decode(f.uc), tb::trace::decode(f.qc));
+  }
+  w.close();
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv) {
+  tb::Sim::random = std::make_unique<tb::Random>();
+  tb::Sim::kernel = std::make_unique<tb::Kernel>();
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      std::size_t size) {
+  const std::vector<tb::trace::Frame> fs{decode(data, size)};
+  if (fs.empty()) return -1;
+
+  tb::Sim::errors = 0;
+  tb::Sim::warnings = 0;
+  tb::Sim::fail_class.reset();
+
+  FuzzCB cb{fs.data(), fs.data() + fs.size()};
+  const bool failed = tb::Sim::kernel->run(std::addressof(cb));
+  if (failed || (tb::Sim::errors != 0)) {
+    std::cerr << "Mismatch: " << tb::Sim::fail_class.value_or("<unknown>")
+              << " (" << fs.size() << " cycles)\n";
+    write_trace(fs);
+    std::abort();
+  }
+  return 0;
+}
@@ -55,13 +55,13 @@
 
 #define V_LOG_IF(__lg, __cond, __level, ...) \
   MACRO_BEGIN \
-  if ((__lg) && (__cond)) { \
-    __lg->__level(__VA_ARGS__); \
-  } \
-  switch (::tb::Level::__level) { \
-  case ::tb::Level::Warning: ++::tb::Sim::warnings; break; \
-  case ::tb::Level::Error:   ++::tb::Sim::errors; break; \
-  default: break; \
+  if (__cond) { \
+    if (__lg) __lg->__level(__VA_ARGS__); \
+    switch (::tb::Level::__level) { \
+    case ::tb::Level::Warning: ++::tb::Sim::warnings; break; \
+    case ::tb::Level::Error:   ++::tb::Sim::errors; break; \
+    default: break; \
+    } \
   } \
   MACRO_END
 
@@ -151,7 +151,9 @@ struct StreamRenderer<vluint8_t> {
 
 #define GENERIC_TYPES(__func) \
   __func(vlsint64_t) \
+  __func(vluint16_t) \
   __func(vluint32_t) \
+  __func(vluint64_t) \
   __func(int) \
   __func(std::string) \
   __func(std::string_view)
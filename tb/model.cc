@@ -27,7 +27,9 @@
 
 #include "model.h"
 
+#include <algorithm>
 #include <array>
+#include <deque>
 #include <sstream>
 #include <vector>
 
@@ -35,6 +37,8 @@
 #include "cfg.h"
 #include "log.h"
 #include "rnd.h"
+#include "snapshot.h"
+#include "stats.h"
 #include "tb.h"
 
 namespace tb {
@@ -63,6 +67,49 @@ bool operator!=(const UpdateCommand& lhs, const UpdateCommand& rhs) {
   return !operator==(lhs, rhs);
 }
 
+bool UpdateSpacing::permits(prod_id_t prod_id) const {
+  if (staged_n_ == cfg::UPDATE_PORTS_N) return false;
+
+  const std::size_t bank = prod_id % cfg::UPDATE_PORTS_N;
+  for (std::size_t p = 0; p < staged_n_; p++) {
+    const UpdateCommand& uc{staged_[p]};
+    if (uc.vld() && ((uc.prod_id() % cfg::UPDATE_PORTS_N) == bank))
+      return false;
+  }
+
+  if (cfg::update_full_forward) return true;
+
+  // history_[i] holds the commands issued (i + 1) cycles prior.
+  for (const UpdateCommand& uc : history_[0]) {
+    if (uc.vld() && (uc.prod_id() == prod_id)) return false;
+  }
+  return true;
+}
+
+void UpdateSpacing::stage(const UpdateCommand& uc) {
+  if (staged_n_ < cfg::UPDATE_PORTS_N) staged_[staged_n_++] = uc;
+}
+
+void UpdateSpacing::advance() {
+  for (std::size_t i = HISTORY_N - 1; i > 0; i--) {
+    history_[i] = history_[i - 1];
+  }
+  history_[0] = staged_;
+  staged_.fill(UpdateCommand{});
+  staged_n_ = 0;
+}
+
+void UpdateSpacing::issue(const UpdateCommand& uc) {
+  stage(uc);
+  advance();
+}
+
+void UpdateSpacing::clear() {
+  for (Cycle& c : history_) c.fill(UpdateCommand{});
+  staged_.fill(UpdateCommand{});
+  staged_n_ = 0;
+}
+
 UpdateResponse::UpdateResponse() : vld_(false) {}
 
 UpdateResponse::UpdateResponse(prod_id_t prod_id)
@@ -83,10 +130,22 @@ bool operator!=(const UpdateResponse& lhs, const UpdateResponse& rhs) {
   return !operator==(lhs, rhs);
 }
 
-QueryCommand::QueryCommand() : vld_(false) {}
-
-QueryCommand::QueryCommand(prod_id_t prod_id, level_t level)
-    : vld_(true), prod_id_(prod_id), level_(level) {}
+QueryCommand::QueryCommand() : vld_(false), snapshot_(false), cum_(false) {}
+
+QueryCommand::QueryCommand(prod_id_t prod_id, level_t level, bool snapshot,
+                           bool cum)
+    : vld_(true),
+      prod_id_(prod_id),
+      level_(level),
+      snapshot_(snapshot),
+      cum_(cum) {}
+
+QueryCommand QueryCommand::lookup(prod_id_t prod_id, key_t key) {
+  QueryCommand qc{prod_id, 0};
+  qc.is_lookup_ = true;
+  qc.key_ = key;
+  return qc;
+}
 
 bool operator==(const QueryCommand& lhs, const QueryCommand& rhs) {
   if (lhs.vld() != rhs.vld()) return false;
@@ -96,6 +155,10 @@ bool operator==(const QueryCommand& lhs, const QueryCommand& rhs) {
 
   if (lhs.prod_id() != rhs.prod_id()) return false;
   if (lhs.level() != rhs.level()) return false;
+  if (lhs.snapshot() != rhs.snapshot()) return false;
+  if (lhs.cum() != rhs.cum()) return false;
+  if (lhs.is_lookup() != rhs.is_lookup()) return false;
+  if (lhs.is_lookup() && (lhs.key() != rhs.key())) return false;
 
   return true;
 }
@@ -115,6 +178,24 @@ QueryResponse::QueryResponse(key_t key, volume_t volume, bool error,
   listsize_ = listsize;
 }
 
+QueryResponse::QueryResponse(std::vector<QueryLevel> levels, bool error,
+                             listsize_t listsize) {
+  vld_ = true;
+  key_ = 0;
+  volume_ = 0;
+  error_ = error;
+  listsize_ = listsize;
+  snapshot_ = true;
+  levels_ = std::move(levels);
+}
+
+QueryResponse::QueryResponse(key_t key, volume_t volume, cum_t cum, bool error,
+                             listsize_t listsize)
+    : QueryResponse(key, volume, error, listsize) {
+  is_cum_ = true;
+  cum_ = cum;
+}
+
 bool operator==(const QueryResponse& lhs, const QueryResponse& rhs) {
   if (lhs.vld() != rhs.vld()) return false;
   // If invalid, payload is don't care.
@@ -122,12 +203,28 @@ bool operator==(const QueryResponse& lhs, const QueryResponse& rhs) {
 
   if (lhs.error() != rhs.error()) return false;
 
+  if (lhs.snapshot() != rhs.snapshot()) return false;
+  if (lhs.is_cum() != rhs.is_cum()) return false;
+
   // If error, disregard further contents (unreliable).
   if (lhs.error()) return true;
 
+  if (lhs.listsize() != rhs.listsize()) return false;
+  if (lhs.snapshot()) {
+    // The (single) level fields are don't care.
+    const std::vector<QueryLevel>& ll{lhs.levels()};
+    const std::vector<QueryLevel>& rl{rhs.levels()};
+    if (ll.size() != rl.size()) return false;
+    for (std::size_t i = 0; i < ll.size(); i++) {
+      if (ll[i].key != rl[i].key) return false;
+      if (ll[i].volume != rl[i].volume) return false;
+    }
+    return true;
+  }
+
   if (lhs.key() != rhs.key()) return false;
   if (lhs.volume() != rhs.volume()) return false;
-  if (lhs.listsize() != rhs.listsize()) return false;
+  if (lhs.is_cum() && (lhs.cum() != rhs.cum())) return false;
 
   return true;
 }
@@ -136,6 +233,41 @@ bool operator!=(const QueryResponse& lhs, const QueryResponse& rhs) {
   return !operator==(lhs, rhs);
 }
 
+LookupResponse::LookupResponse() : vld_(false) {}
+
+LookupResponse::LookupResponse(bool hit, level_t level, volume_t volume,
+                               listsize_t better, bool error)
+    : vld_(true),
+      hit_(hit),
+      level_(level),
+      volume_(volume),
+      better_(better),
+      error_(error) {}
+
+bool operator==(const LookupResponse& lhs, const LookupResponse& rhs) {
+  if (lhs.vld() != rhs.vld()) return false;
+  // If invalid, payload is don't care.
+  if (!lhs.vld()) return true;
+
+  if (lhs.error() != rhs.error()) return false;
+  // If error, disregard further contents (unreliable).
+  if (lhs.error()) return true;
+
+  if (lhs.hit() != rhs.hit()) return false;
+  if (lhs.better() != rhs.better()) return false;
+  // On a miss, the level and volume are don't care.
+  if (!lhs.hit()) return true;
+
+  if (lhs.level() != rhs.level()) return false;
+  if (lhs.volume() != rhs.volume()) return false;
+
+  return true;
+}
+
+bool operator!=(const LookupResponse& lhs, const LookupResponse& rhs) {
+  return !operator==(lhs, rhs);
+}
+
 NotifyResponse::NotifyResponse() : vld_(false) {}
 
 NotifyResponse::NotifyResponse(prod_id_t prod_id, key_t key, volume_t volume) {
@@ -160,6 +292,20 @@ bool operator!=(const NotifyResponse& lhs, const NotifyResponse& rhs) {
   return !operator==(lhs, rhs);
 }
 
+SubscribeCommand::SubscribeCommand() : vld_(false) {}
+
+SubscribeCommand::SubscribeCommand(prod_id_t prod_id, bool en)
+    : vld_(true), prod_id_(prod_id), en_(en) {}
+
+bool operator==(const NotifyEgress& lhs, const NotifyEgress& rhs) {
+  if (lhs.overflow_n() != rhs.overflow_n()) return false;
+  return (lhs.nr() == rhs.nr());
+}
+
+bool operator!=(const NotifyEgress& lhs, const NotifyEgress& rhs) {
+  return !operator==(lhs, rhs);
+}
+
 void StreamRenderer<Cmd>::write(std::ostream& os, const Cmd& cmd) {
   switch (cmd) {
     case Cmd::Clr: os << "Clr"; break;
@@ -204,7 +350,13 @@ void StreamRenderer<QueryCommand>::write(std::ostream& os,
   rr.add("vld", qc.vld());
   if (qc.vld()) {
     rr.add("prod_id", AsDec{qc.prod_id()});
-    rr.add("level", AsDec{qc.level()});
+    if (qc.is_lookup()) {
+      rr.add("key", AsHex{qc.key()});
+    } else {
+      rr.add("level", AsDec{qc.level()});
+    }
+    if (qc.snapshot()) rr.add("snapshot", qc.snapshot());
+    if (qc.cum()) rr.add("cum", qc.cum());
   } else {
     rr.add("prod_id", "x");
     rr.add("level", "x");
@@ -215,9 +367,18 @@ void StreamRenderer<QueryResponse>::write(std::ostream& os,
                                           const QueryResponse& qr) {
   RecordRenderer rr{os, "qr"};
   rr.add("vld", qr.vld());
-  if (qr.vld()) {
+  if (qr.vld() && qr.snapshot()) {
+    for (std::size_t i = 0; i < qr.levels().size(); i++) {
+      const std::string l{std::to_string(i)};
+      rr.add("key" + l, AsHex{qr.levels()[i].key});
+      rr.add("volume" + l, AsDec{qr.levels()[i].volume});
+    }
+    rr.add("error", AsDec{qr.error()});
+    rr.add("listsize", AsDec{qr.listsize()});
+  } else if (qr.vld()) {
     rr.add("key", AsHex{qr.key()});
     rr.add("volume", AsDec{qr.volume()});
+    if (qr.is_cum()) rr.add("cum", AsDec{qr.cum()});
     rr.add("error", AsDec{qr.error()});
     rr.add("listsize", AsDec{qr.listsize()});
   } else {
@@ -228,6 +389,25 @@ void StreamRenderer<QueryResponse>::write(std::ostream& os,
   }
 }
 
+void StreamRenderer<LookupResponse>::write(std::ostream& os,
+                                           const LookupResponse& lr) {
+  RecordRenderer rr{os, "lr"};
+  rr.add("vld", lr.vld());
+  if (lr.vld()) {
+    rr.add("hit", AsDec{lr.hit()});
+    rr.add("level", AsDec{lr.level()});
+    rr.add("volume", AsDec{lr.volume()});
+    rr.add("better", AsDec{lr.better()});
+    rr.add("error", AsDec{lr.error()});
+  } else {
+    rr.add("hit", "x");
+    rr.add("level", "x");
+    rr.add("volume", "x");
+    rr.add("better", "x");
+    rr.add("error", "x");
+  }
+}
+
 void StreamRenderer<NotifyResponse>::write(std::ostream& os,
                                            const NotifyResponse& nr) {
   RecordRenderer rr{os, "nr"};
@@ -243,50 +423,35 @@ void StreamRenderer<NotifyResponse>::write(std::ostream& os,
   }
 }
 
-struct VSampler {
-  static UpdateCommand uc(Vtb* tb) {
-    if (to_bool(tb->i_upd_vld)) {
-      return UpdateCommand{tb->i_upd_prod_id, to_cmd(tb->i_upd_cmd),
-                           static_cast<key_t>(tb->i_upd_key), tb->i_upd_size};
-    } else {
-      return UpdateCommand{};
-    }
-  }
-
-  static QueryCommand qc(Vtb* tb) {
-    if (to_bool(tb->i_lut_vld)) {
-      return QueryCommand{tb->i_lut_prod_id, tb->i_lut_level};
-    } else {
-      return QueryCommand{};
-    }
-  }
-
-  // Sample Notify Reponse Interface:
-  static NotifyResponse nr(Vtb* tb) {
-    if (to_bool(tb->o_lv0_vld_r)) {
-      return NotifyResponse{tb->o_lv0_prod_id_r,
-                            static_cast<key_t>(tb->o_lv0_key_r),
-                            tb->o_lv0_size_r};
-    } else {
-      return NotifyResponse{};
-    }
+void StreamRenderer<SubscribeCommand>::write(std::ostream& os,
+                                             const SubscribeCommand& sc) {
+  RecordRenderer rr{os, "sc"};
+  rr.add("vld", sc.vld());
+  if (sc.vld()) {
+    rr.add("prod_id", AsDec{sc.prod_id()});
+    rr.add("en", sc.en());
+  } else {
+    rr.add("prod_id", "x");
+    rr.add("en", "x");
   }
+}
 
-  // Sample Query Response Interface:
-  static QueryResponse qr(Vtb* tb) {
-    if (to_bool(tb->o_lut_vld_r)) {
-      return QueryResponse{static_cast<key_t>(tb->o_lut_key), tb->o_lut_size,
-                           to_bool(tb->o_lut_error), tb->o_lut_listsize};
-    } else {
-      return QueryResponse{};
-    }
+void StreamRenderer<NotifyEgress>::write(std::ostream& os,
+                                         const NotifyEgress& ne) {
+  RecordRenderer rr{os, "ne"};
+  const NotifyResponse& nr{ne.nr()};
+  rr.add("vld", nr.vld());
+  if (nr.vld()) {
+    rr.add("prod_id", AsDec{nr.prod_id()});
+    rr.add("key", AsHex{nr.key()});
+    rr.add("volume", AsDec{nr.volume()});
+  } else {
+    rr.add("prod_id", "x");
+    rr.add("key", "x");
+    rr.add("volume", "x");
   }
-
- private:
-  static bool to_bool(vluint8_t v) { return (v != 0); }
-
-  static Cmd to_cmd(vluint8_t c) { return Cmd{c}; }
-};
+  rr.add("overflow_n", AsDec{ne.overflow_n()});
+}
 
 template <typename T, std::size_t N>
 class DelayPipeBase {
@@ -336,9 +501,11 @@ class DelayPipe<UpdateResponse, N> : public DelayPipeBase<UpdateResponse, N> {
   using base_class_type::wr_ptr_;
 
  public:
+  // Consider the current and N prior commands; equivalent to the span of the
+  // Update pipeline (S1 to S5) as seen by a coincident Query.
   bool has_prod_id(prod_id_t prod_id) const {
-    for (std::size_t i = 0; i < N; i++) {
-      const UpdateResponse& ur{p_[(wr_ptr_ - i) % p_.size()]};
+    for (std::size_t i = 0; i < p_.size(); i++) {
+      const UpdateResponse& ur{p_[(wr_ptr_ + p_.size() - i) % p_.size()]};
       if (ur.vld() && (ur.prod_id() == prod_id)) return true;
     }
     return false;
@@ -359,6 +526,66 @@ struct StreamRenderer<Entry> {
   }
 };
 
+// Coalescing Notify queue of a bank (v_notify.sv). A Context occupies at most
+// one slot; the payload emitted is the latest top-of-book of the Context at
+// the point at which it is dequeued.
+class NotifyQueue {
+ public:
+  explicit NotifyQueue() { clear(); }
+
+  // Egress presented on the current cycle.
+  NotifyEgress egress() const { return NotifyEgress{rd_, overflow_n_}; }
+
+  // Advance by one cycle, given the notification 'nr' raised by the Update
+  // pipeline, the egress 'ready' and the subscription 'sc' issued to the bank.
+  void step(const NotifyResponse& nr, bool ready, const SubscribeCommand& sc) {
+    // Dequeue into the egress whenever it is empty or being drained. The
+    // payload read predates any notification on the current cycle.
+    const bool pop = !fifo_.empty() && (!rd_.vld() || ready);
+    if (pop) {
+      const prod_id_t head = fifo_.front();
+      rd_ = payload_[head];
+      pend_[head] = false;
+      fifo_.pop_front();
+    } else if (ready) {
+      rd_ = NotifyResponse{};
+    }
+
+    if (nr.vld() && sub_[nr.prod_id()]) {
+      // The payload is always replaced; a slot is required only where the
+      // Context is not already queued (or has been dequeued above).
+      const prod_id_t id = nr.prod_id();
+      const bool is_new = !pend_[id];
+      payload_[id] = nr;
+      if (is_new && (fifo_.size() < cfg::NOTIFY_QUEUE_N)) {
+        fifo_.push_back(id);
+        pend_[id] = true;
+      } else if (is_new) {
+        ++overflow_n_;
+      }
+    }
+
+    if (sc.vld()) sub_[sc.prod_id()] = sc.en();
+  }
+
+  void clear() {
+    sub_.assign(cfg::CONTEXT_N, true);
+    pend_.assign(cfg::CONTEXT_N, false);
+    payload_.assign(cfg::CONTEXT_N, NotifyResponse{});
+    fifo_.clear();
+    rd_ = NotifyResponse{};
+    overflow_n_ = 0;
+  }
+
+ private:
+  std::vector<bool> sub_;
+  std::vector<bool> pend_;
+  std::vector<NotifyResponse> payload_;
+  std::deque<prod_id_t> fifo_;
+  NotifyResponse rd_;
+  vluint32_t overflow_n_;
+};
+
 bool compare_keys(key_t rhs, key_t lhs) {
   return cfg::is_bid_table ? (rhs > lhs) : (rhs < lhs);
 }
@@ -371,45 +598,161 @@ class Model::Impl {
   friend class ModelValidation;
 
   static constexpr const std::size_t QUERY_PIPE_DELAY = 1;
+  // Key Lookups incur two additional stages (S2 and S3) relative to level
+  // Queries.
+  static constexpr const std::size_t LOOKUP_PIPE_DELAY = 3;
   static constexpr const std::size_t UPDATE_PIPE_DELAY = 5;
 
+  // Where Queries are forwarded (cfg::query_forward), a Query is ordered
+  // after those Updates issued at least QUERY_FORWARD_DISTANCE cycles prior,
+  // and before the remainder.
+  static constexpr const std::size_t QUERY_FORWARD_DISTANCE = 3;
+
  public:
   explicit Impl(Vtb* tb, Scope* logger) : tb_(tb), logger_(logger) {}
 
   void step() {
-    const UpdateCommand uc{VSampler::uc(tb_)};
-    const QueryCommand qc{VSampler::qc(tb_)};
-
-    if (logger_ && (uc.vld() || qc.vld())) {
-      logger_->Info("Issue: ", uc, " | ", qc);
+    const QueryCommand qc{VSampler::qc(tb_, 0)};
+
+    // Steer the Update issued on each port to the bank of its Context.
+    std::array<UpdateCommand, cfg::UPDATE_PORTS_N> ucs;
+    for (std::size_t p = 0; p < cfg::UPDATE_PORTS_N; ++p) {
+      const UpdateCommand uc{VSampler::uc(tb_, p)};
+      if (logger_ && (p == 0) && (uc.vld() || qc.vld())) {
+        logger_->Info("Issue: ", uc, " | ", qc);
+      } else if (logger_ && uc.vld() && (p != 0)) {
+        logger_->Info("Issue (port ", std::to_string(p), "): ", uc);
+      }
+      if (!uc.vld()) continue;
+
+      UpdateCommand& bank_uc{ucs[bank(uc.prod_id())]};
+      if (bank_uc.vld()) {
+        // Stimulus has violated the constraint that at most one Update
+        // may be issued to each bank per cycle.
+        ++tb::Sim::errors;
+        if (logger_) logger_->Error("Update bank conflict: ", uc);
+        continue;
+      }
+      bank_uc = uc;
     }
 
-    handle(uc);
-    handle(qc);
+    for (std::size_t b = 0; b < cfg::UPDATE_PORTS_N; ++b) handle(ucs[b], b);
+    handle(qc, 0);
+    for (std::size_t p = 1; p < cfg::QUERY_PORTS_N; ++p) {
+      // Each Query port observes the same state.
+      const QueryCommand pqc{VSampler::qc(tb_, p)};
+      if (logger_ && pqc.vld()) {
+        logger_->Info("Issue (query port ", std::to_string(p), "): ", pqc);
+      }
+      handle(pqc, p);
+    }
 
-    const NotifyResponse nr{VSampler::nr(tb_)};
-    const QueryResponse qr{VSampler::qr(tb_)};
+    const QueryResponse qr{VSampler::qr(tb_, 0)};
+    for (std::size_t b = 0; b < cfg::UPDATE_PORTS_N; ++b) {
+      const NotifyResponse nr{VSampler::nr(tb_, b)};
+      if (logger_ && (b == 0) && (nr.vld() || qr.vld())) {
+        logger_->Info("Response: ", nr, " | ", qr);
+      } else if (logger_ && nr.vld() && (b != 0)) {
+        logger_->Info("Response (lane ", std::to_string(b), "): ", nr);
+      }
+      handle(nr, b);
+    }
+    handle(qr, 0);
+    for (std::size_t p = 1; p < cfg::QUERY_PORTS_N; ++p) {
+      const QueryResponse pqr{VSampler::qr(tb_, p)};
+      if (logger_ && pqr.vld()) {
+        logger_->Info("Response (query port ", std::to_string(p), "): ", pqr);
+      }
+      handle(pqr, p);
+    }
+    for (std::size_t p = 0; p < cfg::QUERY_PORTS_N; ++p) {
+      const LookupResponse lr{VSampler::lr(tb_, p)};
+      if (logger_ && lr.vld()) {
+        logger_->Info("Lookup (query port ", std::to_string(p), "): ", lr);
+      }
+      handle(lr, p);
+    }
 
-    if (logger_ && (nr.vld() || qr.vld())) {
-      logger_->Info("Response: ", nr, " | ", qr);
+    // Coalesced Notify egress; the subscription is issued to the bank of its
+    // Context.
+    const SubscribeCommand sc{VSampler::sc(tb_)};
+    if (logger_ && sc.vld()) logger_->Info("Subscribe: ", sc);
+    for (std::size_t b = 0; b < cfg::UPDATE_PORTS_N; ++b) {
+      const NotifyEgress ne{VSampler::nfy(tb_, b)};
+      const bool ready = VSampler::nfy_ready(tb_, b);
+      if (logger_ && ne.nr().vld() && ready) {
+        logger_->Info("Egress (lane ", std::to_string(b), "): ", ne);
+      }
+      handle(ne, b);
+      const bool sc_hit = sc.vld() && (bank(sc.prod_id()) == b);
+      nfy_queue_[b].step(nr_pipe_[b].head(), ready,
+                         sc_hit ? sc : SubscribeCommand{});
     }
 
-    handle(nr);
-    handle(qr);
+    stats_.on_cycle(VSampler::pipe(tb_));
 
     // Advance predicted state.
-    ur_pipe_.step();
-    nr_pipe_.step();
-    qr_pipe_.step();
+    for (std::size_t b = 0; b < cfg::UPDATE_PORTS_N; ++b) {
+      ur_pipe_[b].step();
+      nr_pipe_[b].step();
+    }
+    for (auto& qr_pipe : qr_pipe_) qr_pipe.step();
+    for (auto& lr_pipe : lr_pipe_) lr_pipe.step();
+    ++cycle_;
+  }
+
+  void clear() {
+    for (std::vector<Entry>& ctxt : tbl_) ctxt.clear();
+    for (std::size_t b = 0; b < cfg::UPDATE_PORTS_N; ++b) {
+      nr_pipe_[b].clear();
+      ur_pipe_[b].clear();
+      nfy_queue_[b].clear();
+    }
+    for (auto& qr_pipe : qr_pipe_) qr_pipe.clear();
+    for (auto& lr_pipe : lr_pipe_) lr_pipe.clear();
+    for (auto& ps : prior_) {
+      for (Prior& p : ps) p = Prior{};
+    }
+    stats_.clear();
+    cycle_ = 0;
+  }
+
+  void preload(const Snapshot& s) {
+    for (prod_id_t id = 0; id < cfg::CONTEXT_N; ++id) {
+      std::vector<Entry>& ctxt{tbl_[id]};
+      ctxt.clear();
+      for (const Snapshot::Entry& e : s.context(id)) {
+        ctxt.push_back(Entry{e.key, e.volume});
+      }
+      stats_.on_occupancy(cycle_, id, ctxt.size());
+    }
   }
 
+  const Stats& stats() const { return stats_; }
+
  private:
-  void handle(const UpdateCommand& uc) {
+  // Contexts are interleaved across banks, one per Update port.
+  static std::size_t bank(prod_id_t prod_id) {
+    return prod_id % cfg::UPDATE_PORTS_N;
+  }
+
+  void handle(const UpdateCommand& uc, std::size_t b) {
+    if (cfg::query_forward) {
+      // Retain the state of the Context prior to the Update, such that it
+      // remains visible to Queries ordered before it.
+      Prior& p{prior_[cycle_ % prior_.size()][b]};
+      p.vld = uc.vld() && (uc.prod_id() < cfg::CONTEXT_N);
+      if (p.vld) {
+        p.prod_id = uc.prod_id();
+        p.ctxt = tbl_[uc.prod_id()];
+      }
+    }
+
     if (!uc.vld()) {
       // No command is present at the interface on this cycle, we do not
       // therefore expect a notification.
-      nr_pipe_.push_back(NotifyResponse{});
-      ur_pipe_.push_back(UpdateResponse{});
+      nr_pipe_[b].push_back(NotifyResponse{});
+      ur_pipe_[b].push_back(UpdateResponse{});
       return;
     };
 
@@ -439,6 +782,7 @@ class Model::Impl {
           if (logger_)
             logger_->Warning("Context overflow! Rejected entry: ", ctxt.back());
           ctxt.pop_back();
+          stats_.on_overflow(uc.prod_id());
         }
       } break;
       case Cmd::Rep:
@@ -451,16 +795,18 @@ class Model::Impl {
         // command becomes a NOP.
         if (it == ctxt.end()) break;
 
+        if (uc.cmd() == Cmd::Rep) {
+          // Perform final replacement of 'volume'.
+          it->volume = uc.volume();
+        }
+
         if (it == ctxt.begin()) {
-          // Item to be replaced is first, therefore raise notification of
-          // current first item in context.
+          // Item to be replaced/deleted is first, therefore raise notification
+          // of current first item in context (on Replace, the new volume).
           nr = NotifyResponse{uc.prod_id(), it->key, it->volume};
         }
 
-        if (uc.cmd() == Cmd::Rep) {
-          // Perform final replacement of 'volume'.
-          it->volume = uc.volume();
-        } else {
+        if (uc.cmd() == Cmd::Del) {
           // Delete: Remove entry from context.
           ctxt.erase(it);
         }
@@ -473,12 +819,14 @@ class Model::Impl {
     }
 
     // Update predicted notify responses based upon outcome of prior command.
-    ur_pipe_.push_back(ur);
-    nr_pipe_.push_back(nr);
+    ur_pipe_[b].push_back(ur);
+    nr_pipe_[b].push_back(nr);
+    stats_.on_update(cycle_, uc, nr.vld());
+    stats_.on_occupancy(cycle_, uc.prod_id(), ctxt.size());
   }
 
-  void handle(const NotifyResponse& nr) {
-    const NotifyResponse& predicted = nr_pipe_.head();
+  void handle(const NotifyResponse& nr, std::size_t b) {
+    const NotifyResponse& predicted = nr_pipe_[b].head();
     const NotifyResponse& actual = nr;
     const char* fail_message = nullptr;
     if (predicted.vld() == actual.vld()) {
@@ -488,29 +836,115 @@ class Model::Impl {
       fail_message = "Unexpected Notify Response";
     }
     if (fail_message) report_fail(fail_message, predicted, actual);
+    stats_.on_notify(cycle_, actual);
+  }
+
+  void handle(const NotifyEgress& ne, std::size_t b) {
+    const NotifyEgress predicted{nfy_queue_[b].egress()};
+    const NotifyEgress& actual = ne;
+    const char* fail_message = nullptr;
+    if (predicted.nr().vld() != actual.nr().vld()) {
+      fail_message = "Unexpected Notify Egress";
+    } else if (predicted.overflow_n() != actual.overflow_n()) {
+      fail_message = "Overflow count mismatch";
+    } else if (predicted != actual) {
+      fail_message = "Payload mismatch";
+    }
+    if (fail_message) report_fail(fail_message, predicted, actual);
   }
 
-  void handle(const QueryCommand& qc) {
+  void handle(const QueryCommand& qc, std::size_t p) {
     QueryResponse qr;
-    if (qc.vld()) {
+    LookupResponse lr;
+    if (qc.vld() && qc.is_lookup()) {
+      lr = lookup(qc);
+    } else if (qc.vld()) {
       V_ASSERT(logger_, qc.prod_id() < cfg::CONTEXT_N);
-      const std::vector<Entry>& ctxt{tbl_[qc.prod_id()]};
-
-      if ((qc.level() >= ctxt.size()) || ur_pipe_.has_prod_id(qc.prod_id())) {
+      const std::vector<Entry>& ctxt{query_view(qc.prod_id())};
+
+      // An in-flight Update to the Context takes precedence over an invalid
+      // level when the error is classified. A snapshot has no level.
+      Stats::QueryOutcome outcome = Stats::QueryOutcome::Ok;
+      if (!cfg::query_forward &&
+          ur_pipe_[bank(qc.prod_id())].has_prod_id(qc.prod_id())) {
+        outcome = Stats::QueryOutcome::Busy;
+      } else if (!qc.snapshot() && (qc.level() >= ctxt.size())) {
+        outcome = Stats::QueryOutcome::InvalidLevel;
+      }
+      stats_.on_query(outcome);
+
+      const listsize_t listsize = static_cast<listsize_t>(ctxt.size());
+      if (qc.snapshot()) {
+        std::vector<QueryLevel> levels;
+        const std::size_t n = std::min<std::size_t>(ctxt.size(), cfg::SNAPSHOT_K);
+        for (std::size_t i = 0; i < n; i++) {
+          levels.push_back(QueryLevel{ctxt[i].key, ctxt[i].volume});
+        }
+        const bool error = (outcome != Stats::QueryOutcome::Ok);
+        qr = QueryResponse{std::move(levels), error, listsize};
+      } else if (outcome != Stats::QueryOutcome::Ok) {
         // Query is errored, other fields are invalid.
-        qr = QueryResponse{0, 0, true, 0};
+        qr = qc.cum() ? QueryResponse{0, 0, cum_t{0}, true, 0}
+                      : QueryResponse{0, 0, true, 0};
+      } else if (qc.cum()) {
+        // Total volume through the level (inclusive).
+        cum_t cum = 0;
+        for (std::size_t i = 0; i <= qc.level(); i++) cum += ctxt[i].volume;
+        const Entry& e{ctxt[qc.level()]};
+        qr = QueryResponse{e.key, e.volume, cum, false, listsize};
       } else {
         // Query is valid, populate as necessary.
         const Entry& e{ctxt[qc.level()]};
-        const listsize_t listsize = static_cast<listsize_t>(ctxt.size());
         qr = QueryResponse{e.key, e.volume, false, listsize};
       }
     }
-    qr_pipe_.push_back(qr);
+    qr_pipe_[p].push_back(qr);
+    lr_pipe_[p].push_back(lr);
   }
 
-  void handle(const QueryResponse& qr) {
-    const QueryResponse& predicted = qr_pipe_.head();
+  LookupResponse lookup(const QueryCommand& qc) {
+    V_ASSERT(logger_, qc.prod_id() < cfg::CONTEXT_N);
+    const std::vector<Entry>& ctxt{query_view(qc.prod_id())};
+
+    // A Key Lookup errors only on an in-flight Update to the Context; an
+    // absent key is a miss.
+    if (!cfg::query_forward &&
+        ur_pipe_[bank(qc.prod_id())].has_prod_id(qc.prod_id())) {
+      stats_.on_query(Stats::QueryOutcome::Busy);
+      return LookupResponse{false, 0, 0, 0, true};
+    }
+    stats_.on_query(Stats::QueryOutcome::Ok);
+
+    // Entries are sorted, therefore those ordered strictly before the key form
+    // a run from the head; the first matching entry (if any) follows it.
+    auto before_key = [&](const Entry& e) {
+      return compare_keys(e.key, qc.key());
+    };
+    auto it = std::find_if_not(ctxt.begin(), ctxt.end(), before_key);
+    const listsize_t better = static_cast<listsize_t>(it - ctxt.begin());
+    if ((it == ctxt.end()) || (it->key != qc.key())) {
+      return LookupResponse{false, 0, 0, better, false};
+    }
+    return LookupResponse{true, static_cast<level_t>(better), it->volume,
+                          better, false};
+  }
+
+  // The state of a Context as observed by a Query issued on the current
+  // cycle.
+  const std::vector<Entry>& query_view(prod_id_t prod_id) const {
+    if (cfg::query_forward) {
+      // The oldest Update to the Context, ordered after the Query, retains
+      // the state which the Query observes.
+      for (std::size_t i = 1; i <= prior_.size(); ++i) {
+        const Prior& p{prior_[(cycle_ + i) % prior_.size()][bank(prod_id)]};
+        if (p.vld && (p.prod_id == prod_id)) return p.ctxt;
+      }
+    }
+    return tbl_[prod_id];
+  }
+
+  void handle(const QueryResponse& qr, std::size_t p) {
+    const QueryResponse& predicted = qr_pipe_[p].head();
     const QueryResponse& actual = qr;
     const char* fail_message = nullptr;
     if (predicted.vld() == actual.vld()) {
@@ -524,17 +958,60 @@ class Model::Impl {
     }
   }
 
+  void handle(const LookupResponse& lr, std::size_t p) {
+    const LookupResponse& predicted = lr_pipe_[p].head();
+    const LookupResponse& actual = lr;
+    const char* fail_message = nullptr;
+    if (predicted.vld() == actual.vld()) {
+      if (predicted.vld() && (predicted != actual))
+        fail_message = "Payload mismatch";
+    } else {
+      fail_message = "Unexpected Lookup Response";
+    }
+    if (fail_message) report_fail(fail_message, predicted, actual);
+  }
+
+  static const char* interface_name(const NotifyResponse&) { return "Notify"; }
+  static const char* interface_name(const QueryResponse&) { return "Query"; }
+  static const char* interface_name(const NotifyEgress&) { return "Egress"; }
+  static const char* interface_name(const LookupResponse&) { return "Lookup"; }
+
   template <typename T>
   void report_fail(const char* reason, const T& predicted, const T& actual) const {
     ++tb::Sim::errors;
+    if (!tb::Sim::fail_class) {
+      tb::Sim::fail_class =
+          std::string{reason} + " (" + interface_name(actual) + ")";
+    }
     if (logger_)
       logger_->Error(reason, " predicted: ", predicted, " actual:", actual);
   }
 
   std::array<std::vector<Entry>, cfg::CONTEXT_N> tbl_;
-  DelayPipe<NotifyResponse, UPDATE_PIPE_DELAY> nr_pipe_;
-  DelayPipe<UpdateResponse, UPDATE_PIPE_DELAY> ur_pipe_;
-  DelayPipe<QueryResponse, QUERY_PIPE_DELAY> qr_pipe_;
+
+  // Updates issued on the current and prior cycles which are ordered after a
+  // Query issued on the current cycle (per cycle, one per bank).
+  struct Prior {
+    bool vld = false;
+    prod_id_t prod_id = 0;
+    std::vector<Entry> ctxt;
+  };
+  std::array<std::array<Prior, cfg::UPDATE_PORTS_N>, QUERY_FORWARD_DISTANCE>
+      prior_;
+
+  // Each bank retains its own Update pipeline and Notify lane.
+  std::array<DelayPipe<NotifyResponse, UPDATE_PIPE_DELAY>, cfg::UPDATE_PORTS_N>
+      nr_pipe_;
+  std::array<DelayPipe<UpdateResponse, UPDATE_PIPE_DELAY>, cfg::UPDATE_PORTS_N>
+      ur_pipe_;
+  std::array<NotifyQueue, cfg::UPDATE_PORTS_N> nfy_queue_;
+  // Each Query port retains its own pipeline.
+  std::array<DelayPipe<QueryResponse, QUERY_PIPE_DELAY>, cfg::QUERY_PORTS_N>
+      qr_pipe_;
+  std::array<DelayPipe<LookupResponse, LOOKUP_PIPE_DELAY>, cfg::QUERY_PORTS_N>
+      lr_pipe_;
+  Stats stats_;
+  std::uint64_t cycle_ = 0;
 
   Vtb* tb_;
   Scope* logger_{nullptr};
@@ -548,6 +1025,12 @@ Model::~Model() {}
 
 void Model::step() { impl_->step(); }
 
+void Model::clear() { impl_->clear(); }
+
+void Model::preload(const Snapshot& s) { impl_->preload(s); }
+
+const Stats& Model::stats() const { return impl_->stats(); }
+
 const Model::Impl* Model::impl() const { return impl_.get(); }
 
 class ModelValidation::Impl {
@@ -561,6 +1044,22 @@ class ModelValidation::Impl {
     return (id < impl->tbl_.size()) && !impl->tbl_[id].empty();
   }
 
+  std::size_t active_entries_n(prod_id_t id) const {
+    const Model::Impl* impl{Sim::model->impl()};
+    if ((impl == nullptr) || (id >= impl->tbl_.size())) return 0;
+
+    return impl->tbl_[id].size();
+  }
+
+  bool has_key(prod_id_t id, key_t key) const {
+    const Model::Impl* impl{Sim::model->impl()};
+    if ((impl == nullptr) || (id >= impl->tbl_.size())) return false;
+
+    const std::vector<Entry>& es{impl->tbl_[id]};
+    auto find_key = [&](const Entry& e) { return (e.key == key); };
+    return std::find_if(es.begin(), es.end(), find_key) != es.end();
+  }
+
   std::pair<bool, key_t> pick_active_key(prod_id_t id) const {
     const Model::Impl* impl{Sim::model->impl()};
     const std::vector<Entry>& es{impl->tbl_[id]};
@@ -580,6 +1079,14 @@ bool ModelValidation::has_active_entries(prod_id_t id) const {
   return impl_->has_active_entries(id);
 }
 
+std::size_t ModelValidation::active_entries_n(prod_id_t id) const {
+  return impl_->active_entries_n(id);
+}
+
+bool ModelValidation::has_key(prod_id_t id, key_t key) const {
+  return impl_->has_key(id, key);
+}
+
 std::pair<bool, key_t> ModelValidation::pick_active_key(prod_id_t id) const {
   return impl_->pick_active_key(id);
 }
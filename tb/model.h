@@ -28,16 +28,29 @@
 #ifndef V_TB_MDL_H
 #define V_TB_MDL_H
 
+#include <array>
+#include <type_traits>
+#include <vector>
+
 #include "verilated.h"
 
+#include "cfg.h"
 #include "log.h"
 
 class Vtb;
 
 namespace tb {
 class Random;
+class Snapshot;
+class Stats;
+
+// Narrowest integral type able to represent all values in [0, N].
+template <std::uint64_t N>
+using uint_for_t = std::conditional_t<
+    (N <= 0xFF), vluint8_t,
+    std::conditional_t<(N <= 0xFFFF), vluint16_t, vluint32_t>>;
 
-using prod_id_t = vluint8_t;
+using prod_id_t = uint_for_t<cfg::CONTEXT_N>;
 enum class Cmd : vluint8_t {
   Clr = 0,
   Add = 1,
@@ -47,8 +60,9 @@ enum class Cmd : vluint8_t {
 };
 using key_t = vlsint64_t;
 using volume_t = vluint32_t;
-using level_t = vluint8_t;
-using listsize_t = vluint8_t;
+using level_t = uint_for_t<cfg::ENTRIES_N>;
+using listsize_t = uint_for_t<cfg::ENTRIES_N>;
+using cum_t = vluint64_t;
 
 class UpdateCommand {
  public:
@@ -72,6 +86,42 @@ class UpdateCommand {
 bool operator==(const UpdateCommand& lhs, const UpdateCommand& rhs);
 bool operator!=(const UpdateCommand& lhs, const UpdateCommand& rhs);
 
+// Track the spacing of Update commands issued to the same Context. State is
+// forwarded only partially around the Update pipeline (v_pipe_update.sv):
+// commands to the same Context must not be issued on back-to-back cycles. No
+// constraint applies where state is forwarded fully
+// (cfg::update_full_forward). Where multiple Update ports are present
+// (cfg::UPDATE_PORTS_N), at most one command may be issued to each bank
+// (prod_id % UPDATE_PORTS_N) per cycle.
+class UpdateSpacing {
+  static constexpr const std::size_t HISTORY_N = 1;
+
+  using Cycle = std::array<UpdateCommand, cfg::UPDATE_PORTS_N>;
+
+ public:
+  explicit UpdateSpacing() = default;
+
+  // Command to 'prod_id' may be issued on the current cycle (alongside those
+  // commands already staged).
+  bool permits(prod_id_t prod_id) const;
+
+  // Stage 'uc' for issue on the next free port on the current cycle.
+  void stage(const UpdateCommand& uc);
+
+  // Advance by one cycle having issued the staged commands.
+  void advance();
+
+  // Advance by one cycle having issued 'uc' (which may be invalid).
+  void issue(const UpdateCommand& uc);
+
+  void clear();
+
+ private:
+  Cycle staged_;
+  std::size_t staged_n_ = 0;
+  std::array<Cycle, HISTORY_N> history_;
+};
+
 class UpdateResponse {
  public:
   explicit UpdateResponse();
@@ -91,31 +141,63 @@ bool operator!=(const UpdateResponse& lhs, const UpdateResponse& rhs);
 class QueryCommand {
  public:
   explicit QueryCommand();
-  explicit QueryCommand(prod_id_t prod_id, level_t level);
+  // A snapshot Query returns the leading cfg::SNAPSHOT_K levels of the
+  // Context ('level' is then disregarded). A cumulative Query additionally
+  // returns the total volume of levels [0, level].
+  explicit QueryCommand(prod_id_t prod_id, level_t level,
+                        bool snapshot = false, bool cum = false);
+
+  // A Key Lookup locates 'key' within the Context; the response is returned
+  // on the Key Lookup bus (see LookupResponse).
+  static QueryCommand lookup(prod_id_t prod_id, key_t key);
 
   bool vld() const { return vld_; }
   prod_id_t prod_id() const { return prod_id_; }
   level_t level() const { return level_; }
+  bool snapshot() const { return snapshot_; }
+  bool cum() const { return cum_; }
+  bool is_lookup() const { return is_lookup_; }
+  key_t key() const { return key_; }
 
  private:
   bool vld_;
   prod_id_t prod_id_;
   level_t level_;
+  bool snapshot_;
+  bool cum_;
+  bool is_lookup_ = false;
+  key_t key_ = 0;
 };
 
 bool operator==(const QueryCommand& lhs, const QueryCommand& rhs);
 bool operator!=(const QueryCommand& lhs, const QueryCommand& rhs);
 
+// A level of a Context, as returned by a snapshot Query.
+struct QueryLevel {
+  key_t key;
+  volume_t volume;
+};
+
 class QueryResponse {
  public:
   explicit QueryResponse();
   explicit QueryResponse(key_t key, volume_t volume, bool error, listsize_t listsize);
+  // Snapshot response; 'levels' holds the valid levels from the head.
+  explicit QueryResponse(std::vector<QueryLevel> levels, bool error,
+                         listsize_t listsize);
+  // Cumulative response; 'cum' is the total volume through the level.
+  explicit QueryResponse(key_t key, volume_t volume, cum_t cum, bool error,
+                         listsize_t listsize);
 
   bool vld() const { return vld_; }
   key_t key() const { return key_; }
   volume_t volume() const { return volume_; }
   bool error() const { return error_; }
   listsize_t listsize() const { return listsize_; }
+  bool snapshot() const { return snapshot_; }
+  const std::vector<QueryLevel>& levels() const { return levels_; }
+  bool is_cum() const { return is_cum_; }
+  cum_t cum() const { return cum_; }
 
  private:
   bool vld_;
@@ -123,11 +205,43 @@ class QueryResponse {
   volume_t volume_;
   bool error_;
   listsize_t listsize_;
+  bool snapshot_ = false;
+  std::vector<QueryLevel> levels_;
+  bool is_cum_ = false;
+  cum_t cum_ = 0;
 };
 
 bool operator==(const QueryResponse& lhs, const QueryResponse& rhs);
 bool operator!=(const QueryResponse& lhs, const QueryResponse& rhs);
 
+// Key Lookup response: whether the key is present in the Context, its level
+// and volume (where present), and the count of entries ordered strictly before
+// it (those better priced).
+class LookupResponse {
+ public:
+  explicit LookupResponse();
+  explicit LookupResponse(bool hit, level_t level, volume_t volume,
+                          listsize_t better, bool error);
+
+  bool vld() const { return vld_; }
+  bool hit() const { return hit_; }
+  level_t level() const { return level_; }
+  volume_t volume() const { return volume_; }
+  listsize_t better() const { return better_; }
+  bool error() const { return error_; }
+
+ private:
+  bool vld_;
+  bool hit_;
+  level_t level_;
+  volume_t volume_;
+  listsize_t better_;
+  bool error_;
+};
+
+bool operator==(const LookupResponse& lhs, const LookupResponse& rhs);
+bool operator!=(const LookupResponse& lhs, const LookupResponse& rhs);
+
 class NotifyResponse {
  public:
   explicit NotifyResponse();
@@ -148,6 +262,42 @@ class NotifyResponse {
 bool operator==(const NotifyResponse& lhs, const NotifyResponse& rhs);
 bool operator!=(const NotifyResponse& lhs, const NotifyResponse& rhs);
 
+// Enable (or disable) notification of the top-of-book of a Context on the
+// coalesced Notify egress. All Contexts are subscribed following reset.
+class SubscribeCommand {
+ public:
+  explicit SubscribeCommand();
+  explicit SubscribeCommand(prod_id_t prod_id, bool en);
+
+  bool vld() const { return vld_; }
+  prod_id_t prod_id() const { return prod_id_; }
+  bool en() const { return en_; }
+
+ private:
+  bool vld_;
+  prod_id_t prod_id_;
+  bool en_;
+};
+
+// Coalesced Notify egress (of a bank): the notification presented to the
+// consumer, alongside the count of notifications dropped on overflow of the
+// queue.
+class NotifyEgress {
+ public:
+  explicit NotifyEgress(const NotifyResponse& nr, vluint32_t overflow_n)
+      : nr_(nr), overflow_n_(overflow_n) {}
+
+  const NotifyResponse& nr() const { return nr_; }
+  vluint32_t overflow_n() const { return overflow_n_; }
+
+ private:
+  NotifyResponse nr_;
+  vluint32_t overflow_n_;
+};
+
+bool operator==(const NotifyEgress& lhs, const NotifyEgress& rhs);
+bool operator!=(const NotifyEgress& lhs, const NotifyEgress& rhs);
+
 template<>
 struct StreamRenderer<UpdateCommand> {
   static void write(std::ostream& os, const UpdateCommand& uc);
@@ -168,11 +318,26 @@ struct StreamRenderer<QueryResponse> {
   static void write(std::ostream& os, const QueryResponse& qr);
 };
 
+template<>
+struct StreamRenderer<LookupResponse> {
+  static void write(std::ostream& os, const LookupResponse& lr);
+};
+
 template<>
 struct StreamRenderer<NotifyResponse> {
   static void write(std::ostream& os, const NotifyResponse& qr);
 };
 
+template<>
+struct StreamRenderer<SubscribeCommand> {
+  static void write(std::ostream& os, const SubscribeCommand& sc);
+};
+
+template<>
+struct StreamRenderer<NotifyEgress> {
+  static void write(std::ostream& os, const NotifyEgress& ne);
+};
+
 template<>
 struct StreamRenderer<Cmd> {
   static void write(std::ostream& os, const Cmd& cmd);
@@ -190,6 +355,16 @@ class Model {
 
   void step();
 
+  // Discard all predicted state; the UUT is to be reset.
+  void clear();
+
+  // Replace the state of all Contexts by that of 's' (the UUT having been
+  // loaded by backdoor).
+  void preload(const Snapshot& s);
+
+  // Interface statistics accumulated since the last clear.
+  const Stats& stats() const;
+
  private:
   const Impl* impl() const;
 };
@@ -204,6 +379,10 @@ class ModelValidation {
 
   bool has_active_entries(prod_id_t id) const;
 
+  std::size_t active_entries_n(prod_id_t id) const;
+
+  bool has_key(prod_id_t id, key_t key) const;
+
   std::pair<bool, key_t> pick_active_key(prod_id_t id) const;
 };
 
@@ -0,0 +1,205 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "orderflow.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+#include "cfg.h"
+#include "mmap.h"
+
+namespace tb::orderflow {
+
+namespace {
+
+bool is_valid(std::uint8_t type) {
+  switch (static_cast<Type>(type)) {
+    case Type::Add:
+    case Type::Cancel:
+    case Type::Modify:
+    case Type::Clear:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Parse integer field at 'b', advancing past the field and its trailing
+// separator (if present). Returns false on malformed input.
+template <typename T>
+bool parse_field(const char*& b, const char* e, T& t) {
+  const auto [ptr, ec] = std::from_chars(b, e, t);
+  if ((ec != std::errc{}) || ((ptr != e) && (*ptr != ','))) return false;
+  b = (ptr == e) ? e : (ptr + 1);
+  return true;
+}
+
+}  // namespace
+
+Format infer_format(const std::string& fn) {
+  const std::string::size_type i = fn.rfind('.');
+  if ((i != std::string::npos) && (fn.substr(i) == ".csv")) {
+    return Format::Csv;
+  }
+  return Format::Binary;
+}
+
+CsvReader::CsvReader(const std::string& fn) {
+  mf_ = std::make_unique<MappedFile>(fn);
+  mf_->advise_sequential();
+  p_ = mf_->data();
+  end_ = p_ + mf_->size();
+}
+
+CsvReader::~CsvReader() {}
+
+bool CsvReader::next(Message& m) {
+  while (p_ != end_) {
+    const char* eol =
+        static_cast<const char*>(std::memchr(p_, '\n', end_ - p_));
+    if (eol == nullptr) eol = end_;
+    const char* b = p_;
+    const char* e = eol;
+    p_ = (eol == end_) ? end_ : (eol + 1);
+    ++line_;
+
+    if ((e != b) && (e[-1] == '\r')) --e;
+    // Skip blank and comment lines.
+    if ((b == e) || (*b == '#')) continue;
+
+    if (!parse_field(b, e, m.instrument)) fail("malformed instrument");
+
+    if ((b == e) || !is_valid(static_cast<std::uint8_t>(*b))) {
+      fail("unknown message type");
+    }
+    m.type = static_cast<Type>(*b++);
+    m.price = 0;
+    m.quantity = 0;
+    if (b == e) {
+      if (m.type != Type::Clear) fail("missing price");
+      return true;
+    }
+    if (*b++ != ',') fail("malformed message type");
+
+    if (!parse_field(b, e, m.price)) fail("malformed price");
+    if ((b != e) && !parse_field(b, e, m.quantity)) fail("malformed quantity");
+    return true;
+  }
+  return false;
+}
+
+void CsvReader::fail(const char* reason) const {
+  throw std::runtime_error("Invalid order-flow " + mf_->fn() + ":" +
+                           std::to_string(line_) + ": " + reason);
+}
+
+BinaryReader::BinaryReader(const std::string& fn) {
+  mf_ = std::make_unique<MappedFile>(fn);
+  if ((mf_->size() % sizeof(BinaryMessage)) != 0) {
+    throw std::runtime_error("Invalid order-flow " + fn +
+                             ": truncated message");
+  }
+  mf_->advise_sequential();
+  it_ = reinterpret_cast<const BinaryMessage*>(mf_->data());
+  end_ = it_ + (mf_->size() / sizeof(BinaryMessage));
+}
+
+BinaryReader::~BinaryReader() {}
+
+bool BinaryReader::next(Message& m) {
+  if (it_ == end_) return false;
+
+  const BinaryMessage& bm{*it_++};
+  if (!is_valid(bm.type)) {
+    throw std::runtime_error("Invalid order-flow " + mf_->fn() +
+                             ": unknown message type");
+  }
+  m.instrument = bm.instrument;
+  m.price = bm.price;
+  m.quantity = bm.quantity;
+  m.type = static_cast<Type>(bm.type);
+  return true;
+}
+
+std::unique_ptr<Reader> open(const std::string& fn, Format f) {
+  switch (f) {
+    case Format::Csv: return std::make_unique<CsvReader>(fn);
+    default:          return std::make_unique<BinaryReader>(fn);
+  }
+}
+
+std::optional<prod_id_t> InstrumentMap::lookup(std::uint64_t instrument) {
+  if (auto it = ids_.find(instrument); it != ids_.end()) return it->second;
+
+  if (ids_.size() == cfg::CONTEXT_N) return std::nullopt;
+
+  const prod_id_t prod_id = static_cast<prod_id_t>(ids_.size());
+  ids_.emplace(instrument, prod_id);
+  return prod_id;
+}
+
+UpdateCommand to_command(const Message& m, prod_id_t prod_id) {
+  switch (m.type) {
+    case Type::Add:
+      return UpdateCommand{prod_id, Cmd::Add, m.price, m.quantity};
+    case Type::Cancel:
+      return UpdateCommand{prod_id, Cmd::Del, m.price, 0};
+    case Type::Modify:
+      return UpdateCommand{prod_id, Cmd::Rep, m.price, m.quantity};
+    case Type::Clear:
+      return UpdateCommand{prod_id, Cmd::Clr, 0, 0};
+    default:
+      return UpdateCommand{};
+  }
+}
+
+UpdateCommand Scheduler::pop() {
+  UpdateCommand uc{};
+  blocked_.clear();
+  for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+    const prod_id_t prod_id = it->prod_id();
+    // Retain per-Context ordering: once a command to a Context has been
+    // passed over, subsequent commands to it are also blocked.
+    if (std::find(blocked_.begin(), blocked_.end(), prod_id) !=
+        blocked_.end()) {
+      continue;
+    }
+    if (spacing_.permits(prod_id)) {
+      uc = *it;
+      pending_.erase(it);
+      break;
+    }
+    blocked_.push_back(prod_id);
+  }
+  spacing_.issue(uc);
+  return uc;
+}
+
+}  // namespace tb::orderflow
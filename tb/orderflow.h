@@ -0,0 +1,170 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef V_TB_ORDERFLOW_H
+#define V_TB_ORDERFLOW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "model.h"
+
+namespace tb {
+
+class MappedFile;
+
+namespace orderflow {
+
+// Recorded order-flow message types. Enumeration values correspond to the
+// type character present in both the CSV and binary formats.
+enum class Type : std::uint8_t {
+  Add = 'A',
+  Cancel = 'C',
+  Modify = 'M',
+  Clear = 'X'
+};
+
+struct Message {
+  std::uint64_t instrument;
+  key_t price;
+  volume_t quantity;
+  Type type;
+};
+
+// Binary format: a header-less sequence of fixed-size, host-endian records.
+struct BinaryMessage {
+  std::uint64_t instrument;
+  std::int64_t price;
+  std::uint32_t quantity;
+  std::uint8_t type;
+  std::uint8_t reserved[3];
+};
+static_assert(sizeof(BinaryMessage) == 24);
+
+enum class Format { Csv, Binary };
+
+// Infer format from file extension: '.csv' denotes CSV, otherwise binary.
+Format infer_format(const std::string& fn);
+
+// Streaming reader of order-flow messages. Messages are decoded in-place from
+// a read-only mapping of the source file; nothing is copied or buffered.
+class Reader {
+ public:
+  virtual ~Reader() = default;
+
+  // Decode the next message. Returns false once the file is exhausted.
+  virtual bool next(Message& m) = 0;
+};
+
+// CSV format, one message per line:
+//
+//   <instrument>,<type>,<price>,<quantity>
+//
+// where <type> is one of A (Add), C (Cancel), M (Modify) or X (Clear). Blank
+// lines and lines beginning with '#' are ignored. <price> and <quantity> are
+// optional for Clear.
+class CsvReader : public Reader {
+ public:
+  explicit CsvReader(const std::string& fn);
+  ~CsvReader() override;
+
+  bool next(Message& m) override;
+
+ private:
+  [[noreturn]] void fail(const char* reason) const;
+
+  std::unique_ptr<MappedFile> mf_;
+  const char* p_{nullptr};
+  const char* end_{nullptr};
+  std::size_t line_{0};
+};
+
+class BinaryReader : public Reader {
+ public:
+  explicit BinaryReader(const std::string& fn);
+  ~BinaryReader() override;
+
+  bool next(Message& m) override;
+
+ private:
+  std::unique_ptr<MappedFile> mf_;
+  const BinaryMessage* it_{nullptr};
+  const BinaryMessage* end_{nullptr};
+};
+
+std::unique_ptr<Reader> open(const std::string& fn, Format f);
+
+// Assign instruments to Contexts in order of first appearance. Once all
+// Contexts have been assigned, further instruments remain unmapped.
+class InstrumentMap {
+ public:
+  explicit InstrumentMap() = default;
+
+  std::optional<prod_id_t> lookup(std::uint64_t instrument);
+
+  std::size_t size() const { return ids_.size(); }
+
+ private:
+  std::unordered_map<std::uint64_t, prod_id_t> ids_;
+};
+
+UpdateCommand to_command(const Message& m, prod_id_t prod_id);
+
+// Buffer Update commands such that the DUT's same-Context spacing rule is
+// met. On each cycle, the oldest pending command which may legally be issued
+// is selected; commands to the same Context are never reordered.
+class Scheduler {
+ public:
+  explicit Scheduler(std::size_t window_n) : window_n_(window_n) {}
+
+  bool full() const { return pending_.size() >= window_n_; }
+  bool empty() const { return pending_.empty(); }
+
+  void push_back(const UpdateCommand& uc) { pending_.push_back(uc); }
+
+  // Select command to be issued on the current cycle; invalid if no pending
+  // command may be issued.
+  UpdateCommand pop();
+
+ private:
+  std::size_t window_n_;
+  std::deque<UpdateCommand> pending_;
+  std::vector<prod_id_t> blocked_;
+  UpdateSpacing spacing_;
+};
+
+}  // namespace orderflow
+
+}  // namespace tb
+
+#endif
@@ -60,6 +60,20 @@ class Random {
     return d(mt_);
   }
 
+  // Generate 'true' with probability p.
+  bool bernoulli(double p) {
+    std::bernoulli_distribution d(p);
+    return d(mt_);
+  }
+
+  // Generate the number of failures before the first success of a trial with
+  // probability of success p.
+  template <typename T>
+  std::enable_if_t<std::is_integral_v<T>, T> geometric(double p) {
+    std::geometric_distribution<T> d(p);
+    return d(mt_);
+  }
+
  private:
   std::mt19937 mt_;
 };
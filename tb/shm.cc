@@ -0,0 +1,212 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "shm.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#include "model.h"
+
+namespace {
+
+// Bytes occupied by a ring of 'n' records of type T (including its Index),
+// rounded such that the following Index remains cache-line aligned.
+template <typename T>
+std::uint64_t ring_bytes(std::uint32_t n) {
+  const std::uint64_t bytes =
+      sizeof(tb::shm::Index) + static_cast<std::uint64_t>(n) * sizeof(T);
+  return (bytes + 63) & ~std::uint64_t{63};
+}
+
+template <typename T>
+tb::shm::Ring<T> make_ring(void* base, std::uint64_t offset, std::uint32_t n) {
+  char* p = static_cast<char*>(base) + offset;
+  return tb::shm::Ring<T>{reinterpret_cast<tb::shm::Index*>(p),
+                          reinterpret_cast<T*>(p + sizeof(tb::shm::Index)), n};
+}
+
+void validate_capacity(const char* what, std::uint32_t n) {
+  if ((n == 0) || !std::has_single_bit(n)) {
+    throw std::runtime_error(std::string{"Ring capacity ("} + what +
+                             ") must be a non-zero power of two");
+  }
+}
+
+}  // namespace
+
+namespace tb::shm {
+
+QueryResponseRecord encode(std::uint64_t cycle, const QueryResponse& qr) {
+  QueryResponseRecord r;
+  std::memset(std::addressof(r), 0, sizeof(r));
+  r.cycle = cycle;
+  r.key = qr.key();
+  r.volume = qr.volume();
+  r.error = qr.error() ? 1 : 0;
+  r.listsize = qr.listsize();
+  r.cum = qr.cum();
+  return r;
+}
+
+NotifyRecord encode(std::uint64_t cycle, const NotifyResponse& nr) {
+  NotifyRecord r;
+  std::memset(std::addressof(r), 0, sizeof(r));
+  r.cycle = cycle;
+  r.key = nr.key();
+  r.volume = nr.volume();
+  r.prod_id = nr.prod_id();
+  return r;
+}
+
+Region::Region(const std::string& name, const Capacity& c)
+    : name_(name), owner_(true) {
+  validate_capacity("cmd", c.cmd_n);
+  validate_capacity("qr", c.qr_n);
+  validate_capacity("nr", c.nr_n);
+
+  Header h;
+  std::memset(std::addressof(h), 0, sizeof(h));
+  std::copy(std::begin(MAGIC), std::end(MAGIC), h.magic);
+  h.version = VERSION;
+  h.cmd_n = c.cmd_n;
+  h.qr_n = c.qr_n;
+  h.nr_n = c.nr_n;
+  h.cmd_offset = sizeof(Header);
+  h.qr_offset = h.cmd_offset + ring_bytes<CommandRecord>(c.cmd_n);
+  h.nr_offset = h.qr_offset + ring_bytes<QueryResponseRecord>(c.qr_n);
+  const std::uint64_t size = h.nr_offset + ring_bytes<NotifyRecord>(c.nr_n);
+
+  // Discard any stale region of the same name (from a prior, aborted, run).
+  ::shm_unlink(name_.c_str());
+  const int fd = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    throw std::runtime_error("Unable to create shared memory: " + name_);
+  }
+  if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    ::close(fd);
+    ::shm_unlink(name_.c_str());
+    throw std::runtime_error("Unable to size shared memory: " + name_);
+  }
+  map(fd, size);
+
+  // Region is zero-filled on creation; indices are therefore initially zero.
+  std::memcpy(base_, std::addressof(h), sizeof(h));
+  bind();
+}
+
+Region::Region(const std::string& name) : name_(name) {
+  const int fd = ::shm_open(name_.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    throw std::runtime_error("Unable to open shared memory: " + name_);
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw std::runtime_error("Unable to stat shared memory: " + name_);
+  }
+  if (static_cast<std::size_t>(st.st_size) < sizeof(Header)) {
+    ::close(fd);
+    throw std::runtime_error("Invalid shared memory " + name_ +
+                             ": truncated header");
+  }
+  map(fd, static_cast<std::size_t>(st.st_size));
+
+  try {
+    if (!std::equal(std::begin(MAGIC), std::end(MAGIC), header_->magic)) {
+      throw std::runtime_error("Invalid shared memory " + name_ +
+                               ": bad magic");
+    }
+    if (header_->version != VERSION) {
+      throw std::runtime_error("Invalid shared memory " + name_ +
+                               ": unsupported version");
+    }
+    bind();
+  } catch (...) {
+    ::munmap(base_, size_);
+    throw;
+  }
+}
+
+Region::~Region() {
+  if (base_ != nullptr) ::munmap(base_, size_);
+  if (owner_) ::shm_unlink(name_.c_str());
+}
+
+bool Region::has_state(std::uint32_t s) const {
+  return (std::atomic_ref<std::uint32_t>{header_->state}.load(
+              std::memory_order_acquire) &
+          s) != 0;
+}
+
+void Region::set_state(std::uint32_t s) {
+  std::atomic_ref<std::uint32_t>{header_->state}.fetch_or(
+      s, std::memory_order_acq_rel);
+}
+
+std::uint64_t Region::cycle() const {
+  return std::atomic_ref<std::uint64_t>{header_->cycle}.load(
+      std::memory_order_relaxed);
+}
+
+void Region::set_cycle(std::uint64_t cycle) {
+  std::atomic_ref<std::uint64_t>{header_->cycle}.store(
+      cycle, std::memory_order_relaxed);
+}
+
+void Region::map(int fd, std::size_t size) {
+  void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  // The mapping remains valid after the descriptor has been closed.
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    if (owner_) ::shm_unlink(name_.c_str());
+    throw std::runtime_error("Unable to map shared memory: " + name_);
+  }
+  base_ = p;
+  size_ = size;
+  header_ = static_cast<Header*>(p);
+}
+
+void Region::bind() {
+  const Header& h{*header_};
+  if ((h.nr_offset + ring_bytes<NotifyRecord>(h.nr_n)) > size_) {
+    throw std::runtime_error("Invalid shared memory " + name_ +
+                             ": truncated rings");
+  }
+  cmd_ = make_ring<CommandRecord>(base_, h.cmd_offset, h.cmd_n);
+  qr_ = make_ring<QueryResponseRecord>(base_, h.qr_offset, h.qr_n);
+  nr_ = make_ring<NotifyRecord>(base_, h.nr_offset, h.nr_n);
+}
+
+}  // namespace tb::shm
@@ -0,0 +1,235 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef V_TB_SHM_H
+#define V_TB_SHM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "trace.h"
+
+namespace tb {
+
+class NotifyResponse;
+class QueryResponse;
+
+namespace shm {
+
+// POSIX shared-memory interface to the simulated UUT:
+//
+//   +--------+-------+-----+-------+-----+-------+-----+
+//   | Header | Index | Cmd | Index | QR  | Index | NR  |
+//   +--------+-------+-----+-------+-----+-------+-----+
+//
+// Three single-producer/single-consumer rings are present: an inbound ring of
+// commands (one trace::Frame per cycle, holding an Update and a Query slot),
+// and outbound rings of Query Responses and Notify Responses (Key Lookup
+// responses are not presently carried). Records are of fixed size, naturally
+// aligned and in host byte-order; the same layout is used by the DMA path of
+// the FPGA implementation. Ring capacities are powers of two. Indices increase
+// monotonically and are reduced modulo capacity on access. Shared fields are
+// accessed atomically (std::atomic_ref) such that all structures remain
+// trivially copyable.
+
+constexpr const char MAGIC[8] = {'V', 'S', 'H', 'M', '\0', '\0', '\0', '\0'};
+
+constexpr const std::uint32_t VERSION = 4;
+
+// Header::state flags.
+enum : std::uint32_t {
+  // Host has issued its final command.
+  STATE_HOST_CLOSED = 0x1,
+  // Simulator has retired all commands and emitted all responses.
+  STATE_SIM_DONE = 0x2
+};
+
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  // STATE_* flags (atomic).
+  std::uint32_t state;
+  // Capacity (in records) of each ring.
+  std::uint32_t cmd_n;
+  std::uint32_t qr_n;
+  std::uint32_t nr_n;
+  std::uint32_t reserved0;
+  // Offset (in bytes, from the start of the region) of each ring Index; the
+  // records immediately follow.
+  std::uint64_t cmd_offset;
+  std::uint64_t qr_offset;
+  std::uint64_t nr_offset;
+  // Current simulation cycle (atomic).
+  std::uint64_t cycle;
+};
+static_assert(sizeof(Header) == 64);
+
+// Producer and consumer indices reside on separate cache lines.
+struct Index {
+  // Next record to be written (owned by producer).
+  alignas(64) std::uint64_t head;
+  // Next record to be read (owned by consumer).
+  alignas(64) std::uint64_t tail;
+};
+static_assert(sizeof(Index) == 128);
+static_assert(std::atomic_ref<std::uint64_t>::is_always_lock_free);
+
+using CommandRecord = trace::Frame;
+
+struct QueryResponseRecord {
+  // Cycle on which the response was emitted.
+  std::uint64_t cycle;
+  std::int64_t key;
+  std::uint32_t volume;
+  std::uint8_t error;
+  std::uint8_t reserved0;
+  std::uint16_t listsize;
+  // Total volume through the level (cumulative Queries; otherwise, zero).
+  std::uint64_t cum;
+};
+static_assert(sizeof(QueryResponseRecord) == 32);
+
+struct NotifyRecord {
+  // Cycle on which the notification was emitted.
+  std::uint64_t cycle;
+  std::int64_t key;
+  std::uint32_t volume;
+  std::uint32_t prod_id;
+  std::uint8_t reserved[8];
+};
+static_assert(sizeof(NotifyRecord) == 32);
+
+QueryResponseRecord encode(std::uint64_t cycle, const QueryResponse& qr);
+
+NotifyRecord encode(std::uint64_t cycle, const NotifyResponse& nr);
+
+template <typename T>
+class Ring {
+ public:
+  explicit Ring() = default;
+  explicit Ring(Index* index, T* records, std::size_t n)
+      : index_(index), records_(records), mask_(n - 1) {}
+
+  std::size_t capacity() const { return mask_ + 1; }
+
+  std::size_t size() const {
+    return static_cast<std::size_t>(load(index_->head) - load(index_->tail));
+  }
+
+  std::size_t free() const { return capacity() - size(); }
+
+  bool empty() const { return size() == 0; }
+
+  // Producer: append 'r'; false if the ring is full.
+  bool push(const T& r) {
+    const std::uint64_t head = load(index_->head);
+    const std::uint64_t tail = load(index_->tail);
+    if ((head - tail) > mask_) return false;
+
+    records_[head & mask_] = r;
+    store(index_->head, head + 1);
+    return true;
+  }
+
+  // Consumer: remove oldest record into 'r'; false if the ring is empty.
+  bool pop(T& r) {
+    const std::uint64_t tail = load(index_->tail);
+    const std::uint64_t head = load(index_->head);
+    if (head == tail) return false;
+
+    r = records_[tail & mask_];
+    store(index_->tail, tail + 1);
+    return true;
+  }
+
+ private:
+  static std::uint64_t load(std::uint64_t& i) {
+    return std::atomic_ref<std::uint64_t>{i}.load(std::memory_order_acquire);
+  }
+  static void store(std::uint64_t& i, std::uint64_t v) {
+    std::atomic_ref<std::uint64_t>{i}.store(v, std::memory_order_release);
+  }
+
+  Index* index_{nullptr};
+  T* records_{nullptr};
+  std::uint64_t mask_{0};
+};
+
+struct Capacity {
+  std::uint32_t cmd_n = 4096;
+  std::uint32_t qr_n = 4096;
+  std::uint32_t nr_n = 4096;
+};
+
+// Mapping of the shared-memory region. The simulator creates (and on
+// destruction, unlinks) the region; the host attaches to it by name.
+class Region {
+ public:
+  // Create region 'name' (e.g. "/v") with capacities 'c'.
+  explicit Region(const std::string& name, const Capacity& c);
+
+  // Attach to existing region 'name'.
+  explicit Region(const std::string& name);
+
+  ~Region();
+
+  Region(const Region&) = delete;
+  Region& operator=(const Region&) = delete;
+
+  const std::string& name() const { return name_; }
+
+  Ring<CommandRecord>& cmd() { return cmd_; }
+  Ring<QueryResponseRecord>& qr() { return qr_; }
+  Ring<NotifyRecord>& nr() { return nr_; }
+
+  bool has_state(std::uint32_t s) const;
+  void set_state(std::uint32_t s);
+
+  std::uint64_t cycle() const;
+  void set_cycle(std::uint64_t cycle);
+
+ private:
+  void map(int fd, std::size_t size);
+  void bind();
+
+  std::string name_;
+  bool owner_{false};
+  void* base_{nullptr};
+  std::size_t size_{0};
+  Header* header_{nullptr};
+  Ring<CommandRecord> cmd_;
+  Ring<QueryResponseRecord> qr_;
+  Ring<NotifyRecord> nr_;
+};
+
+}  // namespace shm
+
+}  // namespace tb
+
+#endif
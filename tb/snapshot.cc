@@ -0,0 +1,168 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "snapshot.h"
+
+#include <algorithm>
+#include <charconv>
+#include <set>
+#include <stdexcept>
+#include <string_view>
+
+#include "cfg.h"
+#include "mmap.h"
+#include "rnd.h"
+
+namespace {
+
+// Entry bit positions within v_pkg::state_t (packed; least significant
+// field last):
+//
+//   { listsize, vld[ENTRIES_N], key[ENTRIES_N], volume[ENTRIES_N],
+//     cum[ENTRIES_N] }
+//
+using cfg::CUM_BITS;
+using cfg::KEY_BITS;
+using cfg::LISTSIZE_BITS;
+using cfg::STATE_BITS;
+using cfg::VOLUME_BITS;
+
+constexpr const std::size_t CUM_LSB = 0;
+constexpr const std::size_t VOLUME_LSB = CUM_LSB + cfg::ENTRIES_N * CUM_BITS;
+constexpr const std::size_t KEY_LSB = VOLUME_LSB + cfg::ENTRIES_N * VOLUME_BITS;
+constexpr const std::size_t VLD_LSB = KEY_LSB + cfg::ENTRIES_N * KEY_BITS;
+constexpr const std::size_t LISTSIZE_LSB = VLD_LSB + cfg::ENTRIES_N;
+static_assert(LISTSIZE_LSB + LISTSIZE_BITS == STATE_BITS);
+
+void set_bits(std::vector<std::uint32_t>& ws, std::size_t lsb, std::size_t n,
+              std::uint64_t v) {
+  for (std::size_t i = 0; i < n; ++i) {
+    if ((v >> i) & 1) ws[(lsb + i) / 32] |= (1u << ((lsb + i) % 32));
+  }
+}
+
+// Entries are held in table order: the head Entry is the best (largest bid or
+// smallest ask).
+bool precedes(const tb::Snapshot::Entry& lhs, const tb::Snapshot::Entry& rhs) {
+  return cfg::is_bid_table ? (lhs.key > rhs.key) : (lhs.key < rhs.key);
+}
+
+template <typename T>
+bool parse_field(const char*& b, const char* e, T& t) {
+  while ((b != e) && (*b == ' ')) ++b;
+  const auto [ptr, ec] = std::from_chars(b, e, t);
+  if ((ec != std::errc{}) || ((ptr != e) && (*ptr != ','))) return false;
+  b = (ptr == e) ? e : (ptr + 1);
+  return true;
+}
+
+}  // namespace
+
+namespace tb {
+
+Snapshot::Snapshot() : contexts_(cfg::CONTEXT_N) {}
+
+Snapshot Snapshot::load(const std::string& fn) {
+  const MappedFile mf{fn};
+  std::string_view text{mf.data(), mf.size()};
+
+  Snapshot s;
+  std::size_t line_n = 0;
+  while (!text.empty()) {
+    const std::string_view::size_type i = text.find('\n');
+    std::string_view line{text.substr(0, i)};
+    text.remove_prefix((i == std::string_view::npos) ? text.size() : (i + 1));
+    ++line_n;
+
+    if (!line.empty() && (line.back() == '\r')) line.remove_suffix(1);
+    if (line.empty() || (line.front() == '#')) continue;
+
+    const char* b = line.data();
+    const char* e = line.data() + line.size();
+    std::uint64_t id;
+    key_t key;
+    volume_t volume;
+    if (!parse_field(b, e, id) || !parse_field(b, e, key) ||
+        !parse_field(b, e, volume) || (b != e)) {
+      throw std::runtime_error("Invalid snapshot " + fn + ": malformed line " +
+                               std::to_string(line_n));
+    }
+    if (id >= cfg::CONTEXT_N) {
+      throw std::runtime_error("Invalid snapshot " + fn + ": context out of " +
+                               "range on line " + std::to_string(line_n));
+    }
+    s.add(static_cast<prod_id_t>(id), key, volume);
+  }
+  return s;
+}
+
+Snapshot Snapshot::full(Random* r) {
+  Snapshot s;
+  for (prod_id_t id = 0; id < cfg::CONTEXT_N; ++id) {
+    std::set<key_t> keys;
+    while (keys.size() < cfg::ENTRIES_N) {
+      keys.insert(r->uniform<key_t>(0, 1000000));
+    }
+    for (key_t key : keys) s.add(id, key, r->uniform<volume_t>(1, 10000));
+  }
+  return s;
+}
+
+void Snapshot::add(prod_id_t id, key_t key, volume_t volume) {
+  std::vector<Entry>& ctxt{contexts_.at(id)};
+  if (ctxt.size() >= cfg::ENTRIES_N) {
+    throw std::runtime_error("Snapshot context " + std::to_string(id) +
+                             " exceeds ENTRIES_N");
+  }
+  const Entry e{key, volume};
+  // Insert after Entries of equal key, as the UUT would on Add.
+  ctxt.insert(std::upper_bound(ctxt.begin(), ctxt.end(), e, precedes), e);
+}
+
+std::size_t Snapshot::entries_n() const {
+  std::size_t n = 0;
+  for (const std::vector<Entry>& ctxt : contexts_) n += ctxt.size();
+  return n;
+}
+
+std::vector<std::uint32_t> Snapshot::state_words(prod_id_t id) const {
+  const std::vector<Entry>& ctxt{contexts_.at(id)};
+  std::vector<std::uint32_t> ws((STATE_BITS + 31) / 32, 0);
+  std::uint64_t cum = 0;
+  for (std::size_t i = 0; i < ctxt.size(); ++i) {
+    cum += ctxt[i].volume;
+    set_bits(ws, CUM_LSB + i * CUM_BITS, CUM_BITS, cum);
+    set_bits(ws, VOLUME_LSB + i * VOLUME_BITS, VOLUME_BITS, ctxt[i].volume);
+    set_bits(ws, KEY_LSB + i * KEY_BITS, KEY_BITS,
+             static_cast<std::uint64_t>(ctxt[i].key));
+    set_bits(ws, VLD_LSB + i, 1, 1);
+  }
+  set_bits(ws, LISTSIZE_LSB, LISTSIZE_BITS, ctxt.size());
+  return ws;
+}
+
+}  // namespace tb
@@ -0,0 +1,85 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef V_TB_SNAPSHOT_H
+#define V_TB_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "model.h"
+
+namespace tb {
+
+class Random;
+
+// Book snapshot: the Entries held by each Context, in table order. A snapshot
+// is loaded into the UUT state tables by backdoor (bypassing the Update
+// interface) and into the model, such that a test commences from a populated
+// book.
+//
+// File format is CSV, one Entry per line (blank lines and those commencing
+// with '#' are ignored):
+//
+//   context,key,volume
+//
+class Snapshot {
+ public:
+  struct Entry {
+    key_t key;
+    volume_t volume;
+  };
+
+  explicit Snapshot();
+
+  // Load snapshot from file 'fn'.
+  static Snapshot load(const std::string& fn);
+
+  // Every Context populated to ENTRIES_N with distinct random keys.
+  static Snapshot full(Random* r);
+
+  // Append Entry to Context 'id'; throws where the Context is full.
+  void add(prod_id_t id, key_t key, volume_t volume);
+
+  const std::vector<Entry>& context(prod_id_t id) const {
+    return contexts_[id];
+  }
+
+  std::size_t entries_n() const;
+
+  // Image of Context 'id' as packed v_pkg::state_t, in 32b words (least
+  // significant first).
+  std::vector<std::uint32_t> state_words(prod_id_t id) const;
+
+ private:
+  std::vector<std::vector<Entry>> contexts_;
+};
+
+}  // namespace tb
+
+#endif
@@ -0,0 +1,386 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "stats.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+
+#include "cfg.h"
+#include "test.h"
+
+namespace tb {
+
+void Histogram::record(std::uint64_t v, std::uint64_t n) {
+  if (n == 0) return;
+
+  const std::size_t i = index(v);
+  if (i >= counts_.size()) counts_.resize(i + 1, 0);
+  counts_[i] += n;
+  count_ += n;
+  min_ = std::min(min_, v);
+  max_ = std::max(max_, v);
+  sum_ += static_cast<double>(v) * static_cast<double>(n);
+}
+
+void Histogram::merge(const Histogram& h) {
+  if (h.count_ == 0) return;
+
+  if (h.counts_.size() > counts_.size()) counts_.resize(h.counts_.size(), 0);
+  for (std::size_t i = 0; i < h.counts_.size(); ++i) counts_[i] += h.counts_[i];
+  count_ += h.count_;
+  min_ = std::min(min_, h.min_);
+  max_ = std::max(max_, h.max_);
+  sum_ += h.sum_;
+}
+
+void Histogram::clear() {
+  counts_.clear();
+  count_ = 0;
+  min_ = ~0ull;
+  max_ = 0;
+  sum_ = 0.0;
+}
+
+double Histogram::mean() const {
+  return (count_ == 0) ? 0.0 : (sum_ / static_cast<double>(count_));
+}
+
+std::uint64_t Histogram::percentile(double p) const {
+  if (count_ == 0) return 0;
+
+  p = std::clamp(p, 0.0, 100.0);
+  std::uint64_t target = static_cast<std::uint64_t>(
+      std::ceil(p / 100.0 * static_cast<double>(count_)));
+  target = std::max<std::uint64_t>(target, 1);
+
+  std::uint64_t acc = 0;
+  for (std::size_t i = 0; i < counts_.size(); ++i) {
+    acc += counts_[i];
+    if (acc >= target) return std::min(highest(i), max_);
+  }
+  return max_;
+}
+
+JsonDict Histogram::to_json() const {
+  JsonDict d;
+  d.add("count", static_cast<std::int64_t>(count()));
+  d.add("min", static_cast<std::int64_t>(min()));
+  d.add("max", static_cast<std::int64_t>(max()));
+  d.add("mean", JsonDouble{mean()});
+  d.add("p50", static_cast<std::int64_t>(percentile(50.0)));
+  d.add("p90", static_cast<std::int64_t>(percentile(90.0)));
+  d.add("p99", static_cast<std::int64_t>(percentile(99.0)));
+  d.add("p99_9", static_cast<std::int64_t>(percentile(99.9)));
+
+  // Non-empty buckets as [lowest value, count] pairs.
+  JsonArray buckets;
+  for (std::size_t i = 0; i < counts_.size(); ++i) {
+    if (counts_[i] == 0) continue;
+    JsonArray b;
+    b.add(static_cast<std::int64_t>(lowest(i)));
+    b.add(static_cast<std::int64_t>(counts_[i]));
+    buckets.add(b);
+  }
+  d.add("buckets", buckets);
+  return d;
+}
+
+void Histogram::render(std::ostream& os) const {
+  os << "n=" << count();
+  if (count() == 0) return;
+
+  os << " min=" << min() << " mean=" << std::fixed << std::setprecision(2)
+     << mean() << std::defaultfloat << " p50=" << percentile(50.0)
+     << " p90=" << percentile(90.0) << " p99=" << percentile(99.0)
+     << " p99.9=" << percentile(99.9) << " max=" << max();
+}
+
+std::size_t Histogram::index(std::uint64_t v) {
+  if (v < SUB_N) return static_cast<std::size_t>(v);
+
+  const unsigned e = static_cast<unsigned>(std::bit_width(v)) - 1;
+  const std::uint64_t sub = (v >> (e - SUB_BITS)) & (SUB_N - 1);
+  return static_cast<std::size_t>((e - SUB_BITS + 1) * SUB_N + sub);
+}
+
+std::uint64_t Histogram::lowest(std::size_t i) {
+  if (i < SUB_N) return i;
+
+  const std::size_t g = i / SUB_N;
+  const std::uint64_t sub = i % SUB_N;
+  return (SUB_N + sub) << (g - 1);
+}
+
+std::uint64_t Histogram::highest(std::size_t i) {
+  if (i < SUB_N) return i;
+
+  const std::size_t g = i / SUB_N;
+  return lowest(i) + (1ull << (g - 1)) - 1;
+}
+
+void Stats::clear() {
+  in_flight_.clear();
+  notify_latency_.clear();
+  notify_interval_.clear();
+  notify_interval_by_ctxt_.clear();
+  last_notify_.clear();
+  query_n_ = 0;
+  query_busy_n_ = 0;
+  query_level_n_ = 0;
+  cycle_n_ = 0;
+  upd_stage_n_.fill(0);
+  upd_fwd_n_.fill(0);
+  lut_stage_n_.fill(0);
+  occupancy_.clear();
+}
+
+void Stats::on_update(std::uint64_t cycle, const UpdateCommand& uc,
+                      bool notifies) {
+  if (!notifies) return;
+
+  in_flight_.push_back(InFlight{cycle, uc.prod_id()});
+}
+
+void Stats::on_notify(std::uint64_t cycle, const NotifyResponse& nr) {
+  if (!nr.vld()) return;
+
+  // Discard stale entries for which no Notify was observed (the model will
+  // already have reported the mismatch).
+  while (!in_flight_.empty() &&
+         (cycle - in_flight_.front().cycle) > IN_FLIGHT_AGE_MAX) {
+    in_flight_.pop_front();
+  }
+
+  // Notifications are emitted in issue order; match against the oldest
+  // in-flight Update to the same Context.
+  auto it = std::find_if(
+      in_flight_.begin(), in_flight_.end(),
+      [&](const InFlight& f) { return f.prod_id == nr.prod_id(); });
+  if (it != in_flight_.end()) {
+    notify_latency_.record(cycle - it->cycle);
+    in_flight_.erase(it);
+  }
+
+  // Inter-arrival time, in aggregate and per Context.
+  auto [last, first] = last_notify_.try_emplace(nr.prod_id(), cycle);
+  if (!first) {
+    const std::uint64_t interval = cycle - last->second;
+    notify_interval_.record(interval);
+    notify_interval_by_ctxt_[nr.prod_id()].record(interval);
+    last->second = cycle;
+  }
+}
+
+void Stats::on_query(QueryOutcome outcome) {
+  ++query_n_;
+  switch (outcome) {
+    case QueryOutcome::Busy: {
+      ++query_busy_n_;
+    } break;
+    case QueryOutcome::InvalidLevel: {
+      ++query_level_n_;
+    } break;
+    default: {
+    } break;
+  }
+}
+
+void Stats::on_cycle(const PipeSample& ps) {
+  ++cycle_n_;
+  for (std::size_t b = 0; b < cfg::UPDATE_PORTS_N; ++b) {
+    for (std::size_t i = 0; i < UPD_STAGES_N; ++i) {
+      if ((ps.upd_vld[b] >> i) & 1) ++upd_stage_n_[i];
+    }
+    // Forwarding paths are qualified by a valid command in the stage into
+    // which they forward (S2, or S3 for the last UPD_FWD_S3_N).
+    for (std::size_t i = 0; i < UPD_FWD_N; ++i) {
+      const std::size_t stage = (i < (UPD_FWD_N - UPD_FWD_S3_N)) ? 1 : 2;
+      if (((ps.upd_vld[b] >> stage) & 1) && ((ps.upd_fwd[b] >> i) & 1)) {
+        ++upd_fwd_n_[i];
+      }
+    }
+  }
+  for (std::size_t p = 0; p < cfg::QUERY_PORTS_N; ++p) {
+    for (std::size_t i = 0; i < LUT_STAGES_N; ++i) {
+      if ((ps.lut_vld[p] >> i) & 1) ++lut_stage_n_[i];
+    }
+  }
+}
+
+void Stats::on_occupancy(std::uint64_t cycle, prod_id_t prod_id,
+                         std::size_t n) {
+  Occupancy& o{occupancy_[prod_id]};
+  o.h.record(o.n, cycle - o.since);
+  if (o.n >= cfg::ENTRIES_N) o.full_cycles += (cycle - o.since);
+  o.n = n;
+  o.peak_n = std::max(o.peak_n, n);
+  o.since = cycle;
+}
+
+void Stats::on_overflow(prod_id_t prod_id) {
+  ++occupancy_[prod_id].overflow_n;
+}
+
+Histogram Stats::occupancy(const Occupancy& o) const {
+  Histogram h{o.h};
+  if (cycle_n_ > o.since) h.record(o.n, cycle_n_ - o.since);
+  return h;
+}
+
+std::uint64_t Stats::full_cycles(const Occupancy& o) const {
+  std::uint64_t n = o.full_cycles;
+  if ((o.n >= cfg::ENTRIES_N) && (cycle_n_ > o.since))
+    n += (cycle_n_ - o.since);
+  return n;
+}
+
+void Stats::report(std::ostream& os) const {
+  auto ppm = [&](std::uint64_t n) {
+    return (query_n_ == 0) ? 0 : ((n * 1000000) / query_n_);
+  };
+
+  os << "Statistics:\n";
+  os << "  Notify latency (cycles): ";
+  notify_latency_.render(os);
+  os << "\n";
+  os << "  Notify inter-arrival (cycles): ";
+  notify_interval_.render(os);
+  os << "\n";
+  for (const auto& [prod_id, h] : notify_interval_by_ctxt_) {
+    os << "    Context " << static_cast<unsigned>(prod_id) << ": ";
+    h.render(os);
+    os << "\n";
+  }
+  os << "  Queries: " << query_n_ << " (busy errors: " << query_busy_n_
+     << " [" << ppm(query_busy_n_) << " ppm]"
+     << ", invalid level errors: " << query_level_n_
+     << " [" << ppm(query_level_n_) << " ppm])\n";
+
+  auto pct = [](std::uint64_t n, std::uint64_t d) {
+    return (d == 0) ? 0.0 : (100.0 * static_cast<double>(n) /
+                             static_cast<double>(d));
+  };
+
+  os << std::fixed << std::setprecision(2);
+  // Utilization is the mean over all banks (and Query ports).
+  const std::uint64_t upd_cycle_n = cycle_n_ * cfg::UPDATE_PORTS_N;
+  const std::uint64_t lut_cycle_n = cycle_n_ * cfg::QUERY_PORTS_N;
+  os << "  Pipeline utilization (" << cycle_n_ << " cycles, "
+     << cfg::UPDATE_PORTS_N << " bank(s), " << cfg::QUERY_PORTS_N
+     << " query port(s)):\n";
+  os << "    Update:";
+  for (std::size_t i = 0; i < UPD_STAGES_N; ++i) {
+    os << " S" << (i + 1) << "=" << pct(upd_stage_n_[i], upd_cycle_n) << "%";
+  }
+  os << "\n";
+  os << "    Query:";
+  for (std::size_t i = 0; i < LUT_STAGES_N; ++i) {
+    os << " S" << i << "=" << pct(lut_stage_n_[i], lut_cycle_n) << "%";
+  }
+  os << "\n";
+  os << "    S2 forwarding: from EXE=" << upd_fwd_n_[1] << " ("
+     << pct(upd_fwd_n_[1], upd_stage_n_[1]) << "% of S2), from S1 capture="
+     << upd_fwd_n_[0] << " (" << pct(upd_fwd_n_[0], upd_stage_n_[1])
+     << "% of S2), from writeback=" << upd_fwd_n_[2] << " ("
+     << pct(upd_fwd_n_[2], upd_stage_n_[1]) << "% of S2)\n";
+  os << "    S3 forwarding: from EXE=" << upd_fwd_n_[3] << " ("
+     << pct(upd_fwd_n_[3], upd_stage_n_[2]) << "% of S3)\n";
+
+  Histogram all;
+  std::size_t peak_n = 0;
+  std::uint64_t overflow_n = 0;
+  os << "  Occupancy (time-weighted, ENTRIES_N=" << cfg::ENTRIES_N << "):\n";
+  for (const auto& [prod_id, o] : occupancy_) {
+    const Histogram h{occupancy(o)};
+    os << "    Context " << static_cast<unsigned>(prod_id) << ": ";
+    h.render(os);
+    os << std::fixed << std::setprecision(2) << " full="
+       << pct(full_cycles(o), cycle_n_) << "% drops=" << o.overflow_n << "\n";
+    all.merge(h);
+    peak_n = std::max(peak_n, o.peak_n);
+    overflow_n += o.overflow_n;
+  }
+  os << "    All: ";
+  all.render(os);
+  os << "\n";
+
+  // Summary for the selection of CONTEXT_N and ENTRIES_N.
+  os << "  Sizing: active contexts=" << occupancy_.size() << "/"
+     << cfg::CONTEXT_N << ", peak occupancy=" << peak_n << "/"
+     << cfg::ENTRIES_N << ", overflow drops=" << overflow_n << "\n";
+  os << std::defaultfloat;
+}
+
+JsonDict Stats::to_json() const {
+  JsonDict d;
+  d.add("notify_latency", notify_latency_.to_json());
+  d.add("notify_interval", notify_interval_.to_json());
+
+  JsonDict by_ctxt;
+  for (const auto& [prod_id, h] : notify_interval_by_ctxt_) {
+    by_ctxt.add(std::to_string(prod_id), h.to_json());
+  }
+  d.add("notify_interval_by_context", by_ctxt);
+
+  JsonDict q;
+  q.add("n", static_cast<std::int64_t>(query_n_));
+  q.add("busy_n", static_cast<std::int64_t>(query_busy_n_));
+  q.add("invalid_level_n", static_cast<std::int64_t>(query_level_n_));
+  d.add("query", q);
+
+  JsonDict p;
+  p.add("cycles", static_cast<std::int64_t>(cycle_n_));
+  p.add("update_banks_n", static_cast<std::int64_t>(cfg::UPDATE_PORTS_N));
+  p.add("query_ports_n", static_cast<std::int64_t>(cfg::QUERY_PORTS_N));
+  auto to_array = [](const auto& ns) {
+    JsonArray a;
+    for (std::uint64_t n : ns) a.add(static_cast<std::int64_t>(n));
+    return a;
+  };
+  p.add("update_stage_n", to_array(upd_stage_n_));
+  p.add("update_forward_n", to_array(upd_fwd_n_));
+  p.add("query_stage_n", to_array(lut_stage_n_));
+  d.add("pipeline", p);
+
+  JsonDict occ;
+  for (const auto& [prod_id, o] : occupancy_) {
+    JsonDict c{occupancy(o).to_json()};
+    c.add("peak_n", static_cast<std::int64_t>(o.peak_n));
+    c.add("full_cycles", static_cast<std::int64_t>(full_cycles(o)));
+    c.add("overflow_n", static_cast<std::int64_t>(o.overflow_n));
+    occ.add(std::to_string(prod_id), c);
+  }
+  d.add("occupancy", occ);
+  d.add("context_n", static_cast<std::int64_t>(cfg::CONTEXT_N));
+  d.add("entries_n", static_cast<std::int64_t>(cfg::ENTRIES_N));
+  return d;
+}
+
+}  // namespace tb
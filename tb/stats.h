@@ -0,0 +1,181 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef V_TB_STATS_H
+#define V_TB_STATS_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "model.h"
+
+namespace tb {
+
+class JsonDict;
+
+// Histogram of unsigned integral values, bucketed log-linearly (after
+// HdrHistogram): values below 2^SUB_BITS are recorded exactly; above, each
+// power-of-two range is split into 2^SUB_BITS buckets, bounding the relative
+// error of any reported value to 2^-SUB_BITS. Recording is O(1) and
+// allocation-free once the range of recorded values has been seen.
+class Histogram {
+  static constexpr const unsigned SUB_BITS = 4;
+  static constexpr const std::uint64_t SUB_N = (1ull << SUB_BITS);
+
+ public:
+  explicit Histogram() = default;
+
+  void record(std::uint64_t v, std::uint64_t n = 1);
+
+  // Accumulate the values recorded in 'h'.
+  void merge(const Histogram& h);
+
+  void clear();
+
+  std::uint64_t count() const { return count_; }
+  std::uint64_t min() const { return (count_ == 0) ? 0 : min_; }
+  std::uint64_t max() const { return max_; }
+  double mean() const;
+
+  // Value at or below which 'p' percent of recorded values lie.
+  std::uint64_t percentile(double p) const;
+
+  JsonDict to_json() const;
+
+  // Render single-line summary.
+  void render(std::ostream& os) const;
+
+ private:
+  static std::size_t index(std::uint64_t v);
+  static std::uint64_t lowest(std::size_t i);
+  static std::uint64_t highest(std::size_t i);
+
+  std::vector<std::uint64_t> counts_;
+  std::uint64_t count_ = 0;
+  std::uint64_t min_ = ~0ull;
+  std::uint64_t max_ = 0;
+  double sum_ = 0.0;
+};
+
+// Occupancy of the UUT pipeline stages on a given cycle.
+struct PipeSample {
+  // Per bank, bit 'i' set where Update stage S(i + 1) is valid (S5 being
+  // writeback).
+  std::array<std::uint8_t, cfg::UPDATE_PORTS_N> upd_vld{};
+  // Per bank, bit 'i' set where forwarding path 'i' hits: [0] S1 capture,
+  // [1] EXE and [2] registered writeback into S2; [3] EXE into S3.
+  std::array<std::uint8_t, cfg::UPDATE_PORTS_N> upd_fwd{};
+  // Per Query port, bit 'i' set where Query stage S(i) is valid.
+  std::array<std::uint8_t, cfg::QUERY_PORTS_N> lut_vld{};
+};
+
+// Latency, error-rate, occupancy and utilization statistics, as observed at
+// the interfaces of the UUT by the model.
+class Stats {
+  // In-flight Updates awaiting notification beyond this age (in cycles) are
+  // discarded.
+  static constexpr const std::uint64_t IN_FLIGHT_AGE_MAX = 1024;
+
+  static constexpr const std::size_t UPD_STAGES_N = 5;
+  static constexpr const std::size_t UPD_FWD_N = 4;
+  // Forwarding paths into S3 (the remainder being into S2).
+  static constexpr const std::size_t UPD_FWD_S3_N = 1;
+  static constexpr const std::size_t LUT_STAGES_N = 2;
+
+ public:
+  enum class QueryOutcome { Ok, Busy, InvalidLevel };
+
+  explicit Stats() = default;
+
+  void clear();
+
+  // Update issued on 'cycle'; 'notifies' where a Notify Response is
+  // predicted.
+  void on_update(std::uint64_t cycle, const UpdateCommand& uc, bool notifies);
+
+  // Notify Response sampled on 'cycle'.
+  void on_notify(std::uint64_t cycle, const NotifyResponse& nr);
+
+  void on_query(QueryOutcome outcome);
+
+  // Pipeline occupancy sampled once per cycle; stage counts are accumulated
+  // over all banks (and Query ports).
+  void on_cycle(const PipeSample& ps);
+
+  // Context 'prod_id' holds 'n' Entries from 'cycle' onwards.
+  void on_occupancy(std::uint64_t cycle, prod_id_t prod_id, std::size_t n);
+
+  // Entry spilled from Context 'prod_id' on Add.
+  void on_overflow(prod_id_t prod_id);
+
+  void report(std::ostream& os) const;
+
+  JsonDict to_json() const;
+
+ private:
+  struct InFlight {
+    std::uint64_t cycle;
+    prod_id_t prod_id;
+  };
+
+  struct Occupancy {
+    // Time-weighted Entry count, up to 'since'.
+    Histogram h;
+    std::size_t n = 0;
+    std::size_t peak_n = 0;
+    std::uint64_t since = 0;
+    std::uint64_t full_cycles = 0;
+    std::uint64_t overflow_n = 0;
+  };
+
+  // Occupancy histogram extended to the current cycle.
+  Histogram occupancy(const Occupancy& o) const;
+  std::uint64_t full_cycles(const Occupancy& o) const;
+
+  std::deque<InFlight> in_flight_;
+  Histogram notify_latency_;
+  Histogram notify_interval_;
+  std::map<prod_id_t, Histogram> notify_interval_by_ctxt_;
+  std::map<prod_id_t, std::uint64_t> last_notify_;
+  std::uint64_t query_n_ = 0;
+  std::uint64_t query_busy_n_ = 0;
+  std::uint64_t query_level_n_ = 0;
+  std::uint64_t cycle_n_ = 0;
+  std::array<std::uint64_t, UPD_STAGES_N> upd_stage_n_{};
+  std::array<std::uint64_t, UPD_FWD_N> upd_fwd_n_{};
+  std::array<std::uint64_t, LUT_STAGES_N> lut_stage_n_{};
+  std::map<prod_id_t, Occupancy> occupancy_;
+};
+
+}  // namespace tb
+
+#endif
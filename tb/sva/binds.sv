@@ -34,6 +34,8 @@ bind mux mux_sva #(.N) b_mux_sva (.i_sel);
 bind dffen dffen_sva b_dffen_sva (.en);
 
 bind v v_sva b_v_sva (.i_upd_vld, .i_upd_prod_id, .i_upd_cmd, .i_upd_key,
-  .i_upd_size, .i_lut_vld, .i_lut_prod_id, .i_lut_level, .clk, .arst_n);
+  .i_upd_size, .i_lut_vld, .i_lut_prod_id, .i_lut_level, .i_lut_snap,
+  .i_lut_cum, .i_lut_rev, .i_lut_key, .i_sub_vld, .i_sub_prod_id, .i_sub_en,
+  .clk, .arst_n);
 
 endmodule : binds
@@ -31,4 +31,9 @@
 `define assert_not_x_when(__if, __not_x) \
    assert property (@(posedge clk) disable iff (~arst_n) __if -> !$isunknown(__not_x))
 
+`define assert_not_same_when(__if, __x, __i, __j, __n) \
+   assert property (@(posedge clk) disable iff (~arst_n) \
+     (__if [__i] & $past(__if [__j], __n)) -> \
+       (__x [__i] != $past(__x [__j], __n)))
+
 `endif
@@ -28,6 +28,7 @@
 `ifdef V_TB_SVA_UNSVA_VH
 
 `undef assert_not_x_when
+`undef assert_not_same_when
 `undef V_TB_SVA_UNSVA_VH
 
 `endif
@@ -31,18 +31,40 @@
 module v_sva (
 
 // -------------------------------------------------------------------------- //
-// List Update Bus
-  input wire logic                                i_upd_vld
-, input wire v_pkg::id_t                          i_upd_prod_id
-, input wire v_pkg::cmd_t                         i_upd_cmd
-, input wire v_pkg::key_t                         i_upd_key
-, input wire v_pkg::size_t                        i_upd_size
+// List Update Bus (per port)
+  input wire logic [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_vld
+, input wire v_pkg::id_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_prod_id
+, input wire v_pkg::cmd_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_cmd
+, input wire v_pkg::key_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_key
+, input wire v_pkg::size_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_size
 
 // -------------------------------------------------------------------------- //
-// List Query Bus
-, input wire logic                                i_lut_vld
-, input wire v_pkg::id_t                          i_lut_prod_id
-, input wire v_pkg::level_t                       i_lut_level
+// List Query Bus (per port)
+, input wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_vld
+, input wire v_pkg::id_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_prod_id
+, input wire v_pkg::level_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_level
+, input wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_snap
+, input wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_cum
+, input wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_rev
+, input wire v_pkg::key_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_key
+
+// -------------------------------------------------------------------------- //
+// Notify Subscription
+, input wire logic                                i_sub_vld
+, input wire v_pkg::id_t                          i_sub_prod_id
+, input wire logic                                i_sub_en
 
 // -------------------------------------------------------------------------- //
 // Clk/Reset
@@ -50,13 +72,63 @@ module v_sva (
 , input wire logic                                arst_n
 );
 
-`assert_not_x_when(i_upd_vld, i_upd_prod_id);
-`assert_not_x_when(i_upd_vld, i_upd_cmd);
-`assert_not_x_when(i_upd_vld, i_upd_key);
-`assert_not_x_when(i_upd_vld, i_upd_size);
+for (genvar p = 0; p < cfg_pkg::UPDATE_PORTS_N; p++) begin : port_GEN
+
+`assert_not_x_when(i_upd_vld [p], i_upd_prod_id [p]);
+`assert_not_x_when(i_upd_vld [p], i_upd_cmd [p]);
+`assert_not_x_when(i_upd_vld [p], i_upd_key [p]);
+`assert_not_x_when(i_upd_vld [p], i_upd_size [p]);
+
+end // block: port_GEN
+
+for (genvar q = 0; q < cfg_pkg::QUERY_PORTS_N; q++) begin : query_GEN
+
+`assert_not_x_when(i_lut_vld [q], i_lut_prod_id [q]);
+`assert_not_x_when(i_lut_vld [q], i_lut_level [q]);
+`assert_not_x_when(i_lut_vld [q], i_lut_snap [q]);
+`assert_not_x_when(i_lut_vld [q], i_lut_cum [q]);
+`assert_not_x_when(i_lut_vld [q], i_lut_rev [q]);
+`assert_not_x_when(i_lut_vld [q] & i_lut_rev [q], i_lut_key [q]);
+
+end // block: query_GEN
+
+`assert_not_x_when(i_sub_vld, i_sub_prod_id);
+`assert_not_x_when(i_sub_vld, i_sub_en);
+
+// -------------------------------------------------------------------------- //
+// Updates issued on the same cycle must address distinct banks (the bank
+// conflict rule).
+//
+for (genvar p = 0; p < cfg_pkg::UPDATE_PORTS_N; p++) begin : conflict_GEN
+
+  for (genvar q = p + 1; q < cfg_pkg::UPDATE_PORTS_N; q++) begin : q_GEN
+
+assert property (@(posedge clk) disable iff (~arst_n)
+  (i_upd_vld [p] & i_upd_vld [q]) ->
+    (v_pkg::bank_dec(i_upd_prod_id [p]) != v_pkg::bank_dec(i_upd_prod_id [q])));
+
+  end // block: q_GEN
+
+end // block: conflict_GEN
+
+// -------------------------------------------------------------------------- //
+// Without full forwarding in the Update pipeline, Updates to the same Context
+// must not be issued on consecutive cycles. A Context resides in a single
+// bank, therefore Updates on any port are considered.
+//
+if (!cfg_pkg::UPDATE_FULL_FORWARD) begin : spacing_GEN
+
+  for (genvar p = 0; p < cfg_pkg::UPDATE_PORTS_N; p++) begin : p_GEN
+
+    for (genvar q = 0; q < cfg_pkg::UPDATE_PORTS_N; q++) begin : q_GEN
+
+`assert_not_same_when(i_upd_vld, i_upd_prod_id, p, q, 1);
+
+    end // block: q_GEN
+
+  end // block: p_GEN
 
-`assert_not_x_when(i_lut_vld, i_lut_prod_id);
-`assert_not_x_when(i_lut_vld, i_lut_level);
+end // block: spacing_GEN
 
 endmodule : v_sva
 
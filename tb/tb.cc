@@ -27,15 +27,33 @@
 
 #include "tb.h"
 
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
 #include "Vobj/Vtb.h"
+#include "Vobj/Vtb__Dpi.h"
 #include "cfg.h"
 #include "log.h"
 #include "model.h"
 #include "test.h"
 #include "rnd.h"
+#include "snapshot.h"
+#include "stats.h"
+#include "trace.h"
+#include "tests/bench.h"
+#include "tests/market.h"
+#include "tests/minimise.h"
+#include "tests/orderflow.h"
 #include "tests/regress.h"
+#include "tests/replay.h"
 #include "tests/reset.h"
+#include "tests/shm.h"
 #include "tests/smoke_cmds.h"
+#include "tests/smoke_coro.h"
 #ifdef ENABLE_VCD
 #include "verilated_vcd_c.h"
 #endif
@@ -44,6 +62,85 @@ namespace {
 
 void set_bool(vluint8_t* v, bool b) { *v = b ? 1 : 0; }
 
+bool to_bool(vluint8_t v) { return (v != 0); }
+
+tb::Cmd to_cmd(vluint8_t c) { return tb::Cmd{c}; }
+
+// Update and Notify interfaces are packed arrays, one lane per port (or
+// bank), of fields of the following widths. Verilator presents packed vectors
+// of up to 64b as integers, and wider vectors as arrays of 32b words.
+constexpr const std::size_t ID_BITS = std::bit_width(cfg::CONTEXT_N - 1);
+constexpr const std::size_t CMD_BITS = 2;
+constexpr const std::size_t KEY_BITS = cfg::KEY_BITS;
+constexpr const std::size_t SIZE_BITS = cfg::VOLUME_BITS;
+constexpr const std::size_t LEVEL_BITS = cfg::LEVEL_BITS;
+constexpr const std::size_t LISTSIZE_BITS = cfg::LISTSIZE_BITS;
+constexpr const std::size_t CUM_BITS = cfg::CUM_BITS;
+
+// State table columns (see v_state_table), as bit ranges of the packed state.
+struct StateColumn {
+  const char* name;
+  std::size_t lsb;
+  std::size_t w;
+};
+
+constexpr const StateColumn STATE_COLUMNS[] = {
+    {"u_sram1r1w_cum", 0, cfg::ENTRIES_N * CUM_BITS},
+    {"u_sram1r1w_volume", cfg::ENTRIES_N * CUM_BITS,
+     cfg::ENTRIES_N * SIZE_BITS},
+    {"u_sram1r1w_key", cfg::ENTRIES_N * (CUM_BITS + SIZE_BITS),
+     cfg::ENTRIES_N * KEY_BITS},
+    {"u_sram1r1w_meta", cfg::ENTRIES_N * (CUM_BITS + SIZE_BITS + KEY_BITS),
+     cfg::ENTRIES_N + LISTSIZE_BITS}};
+
+// Extract the 32b words of column 'c' from the packed state words 'ws'.
+std::vector<std::uint32_t> column_words(const std::vector<std::uint32_t>& ws,
+                                        const StateColumn& c) {
+  std::vector<std::uint32_t> cws((c.w + 31) / 32, 0);
+  for (std::size_t i = 0; i < c.w; i++) {
+    const std::size_t b = c.lsb + i;
+    if ((ws[b / 32] >> (b % 32)) & 1) cws[i / 32] |= (1U << (i % 32));
+  }
+  return cws;
+}
+
+template <typename T>
+void put_lane(T& v, std::size_t lane, std::size_t w, std::uint64_t x) {
+  const std::size_t lsb = lane * w;
+  if constexpr (std::is_integral_v<T>) {
+    const std::uint64_t m = (w < 64) ? ((std::uint64_t{1} << w) - 1) : ~0ULL;
+    std::uint64_t r = static_cast<std::uint64_t>(v);
+    r = (r & ~(m << lsb)) | ((x & m) << lsb);
+    v = static_cast<T>(r);
+  } else {
+    for (std::size_t i = 0; i < w; i++) {
+      const std::size_t b = lsb + i;
+      const EData bit = EData{1} << (b % 32);
+      if ((x >> i) & 1) {
+        v[b / 32] |= bit;
+      } else {
+        v[b / 32] &= ~bit;
+      }
+    }
+  }
+}
+
+template <typename T>
+std::uint64_t get_lane(const T& v, std::size_t lane, std::size_t w) {
+  const std::size_t lsb = lane * w;
+  if constexpr (std::is_integral_v<T>) {
+    const std::uint64_t m = (w < 64) ? ((std::uint64_t{1} << w) - 1) : ~0ULL;
+    return (static_cast<std::uint64_t>(v) >> lsb) & m;
+  } else {
+    std::uint64_t x = 0;
+    for (std::size_t i = 0; i < w; i++) {
+      const std::size_t b = lsb + i;
+      x |= static_cast<std::uint64_t>((v[b / 32] >> (b % 32)) & 1) << i;
+    }
+    return x;
+  }
+}
+
 struct VPorts {
   static bool clk(Vtb* tb) { return (tb->clk != 0); }
   static void clk(Vtb* tb, bool v) { set_bool(&tb->clk, v); }
@@ -60,8 +157,15 @@ namespace tb {
 
 void register_tests(TestRegistry& tr) {
   tests::reset::init(tr);
+  tests::bench::init(tr);
+  tests::market::init(tr);
+  tests::minimise::init(tr);
+  tests::orderflow::init(tr);
   tests::regress::init(tr);
+  tests::replay::init(tr);
+  tests::shm::init(tr);
   tests::smoke_cmds::init(tr);
+  tests::smoke_coro::init(tr);
 }
 
 Kernel::Kernel() : tb_time_(0) {
@@ -81,6 +185,13 @@ Kernel::Kernel() : tb_time_(0) {
     mdl_logger_scope = logger_->create_child("mdl");
   }
   tb::Sim::model = std::make_unique<Model>(vtb_.get(), mdl_logger_scope);
+  if (Sim::record_fn) {
+    if ((cfg::UPDATE_PORTS_N != 1) || (cfg::QUERY_PORTS_N != 1)) {
+      throw std::runtime_error(
+          "Trace recording requires a single Update and Query port.");
+    }
+    recorder_ = std::make_unique<trace::Writer>(*Sim::record_fn);
+  }
 }
 
 Kernel::~Kernel() {}
@@ -88,15 +199,28 @@ Kernel::~Kernel() {}
 bool Kernel::run(KernelCallbacks* cb) {
   if (!cb) return false;
 
-  tb_time_ = 0;
-
   Vtb* vtb = vtb_.get();
 
+  // The UUT is reset at the start of each run; discard any state predicted by
+  // a prior run on this Kernel.
+  Sim::model->clear();
+  preload_pending_ = (Sim::snapshot != nullptr);
+  model_time_ = std::chrono::nanoseconds{0};
+  preload_saw_busy_ = false;
+
   // Drive all interfaces to a quiescent state.
   VPorts::clk(vtb, false);
   VPorts::arst_n(vtb, false);
-  VDriver::issue(vtb, UpdateCommand{});
-  VDriver::issue(vtb, QueryCommand{});
+  for (std::size_t p = 0; p < cfg::UPDATE_PORTS_N; ++p) {
+    VDriver::issue(vtb, UpdateCommand{}, p);
+  }
+  for (std::size_t p = 0; p < cfg::QUERY_PORTS_N; ++p) {
+    VDriver::issue(vtb, QueryCommand{}, p);
+  }
+  VDriver::issue(vtb, SubscribeCommand{});
+  for (std::size_t b = 0; b < cfg::UPDATE_PORTS_N; ++b) {
+    VDriver::nfy_ready(vtb, true, b);
+  }
 
   int rundown_n = 5;
   bool do_stepping = true;
@@ -123,22 +247,59 @@ bool Kernel::run(KernelCallbacks* cb) {
     if (vcd_) vcd_->dump(tb_time_);
 #endif
   }
-  end();
   return failed;
 }
 
 bool Kernel::eval_clock_edge(KernelCallbacks* cb, bool edge) {
   bool do_stepping;
   if (edge) {
+    if (preload_pending_) preload();
     do_stepping = cb->on_negedge_clk(vtb_.get());
-    Sim::model->step();
+    if (recorder_) record();
+    if (profile_) {
+      const auto start = std::chrono::steady_clock::now();
+      Sim::model->step();
+      model_time_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start);
+    } else {
+      Sim::model->step();
+    }
   } else {
     do_stepping = cb->on_posedge_clk(vtb_.get());
   }
   return do_stepping;
 }
 
+void Kernel::preload() {
+  // The snapshot is applied on the first cycle after initialization of the
+  // state tables (following reset) has completed, and before any command can
+  // have been issued.
+  Vtb* vtb = vtb_.get();
+  if (VDriver::is_busy(vtb)) {
+    preload_saw_busy_ = true;
+    return;
+  }
+  if (!preload_saw_busy_) return;
+
+  VDriver::preload(vtb, *Sim::snapshot);
+  Sim::model->preload(*Sim::snapshot);
+  preload_pending_ = false;
+  V_LOG_IF(logger_, true, Info, "Preloaded snapshot: ",
+           std::to_string(Sim::snapshot->entries_n()), " entries");
+}
+
+void Kernel::record() {
+  Vtb* vtb = vtb_.get();
+  // Commence recording once the UUT has emerged from reset and completed
+  // initialization; thereafter, every cycle is recorded.
+  if (!VPorts::arst_n(vtb) || VDriver::is_busy(vtb)) {
+    if (recorder_->frames_n() == 0) return;
+  }
+  recorder_->write(VSampler::uc(vtb), VSampler::qc(vtb));
+}
+
 void Kernel::end() {
+  if (recorder_) recorder_->close();
   vtb_->final();
 #ifdef ENABLE_VCD
   if (vcd_) {
@@ -151,27 +312,232 @@ void Kernel::end() {
 std::uint64_t Kernel::tb_cycle() const { return VPorts::tb_cycle(vtb_.get()); }
 
 // Drive Update Command Interface
-void VDriver::issue(Vtb* tb, const UpdateCommand& up) {
-  tb->i_upd_vld = up.vld();
+void VDriver::issue(Vtb* tb, const UpdateCommand& up, std::size_t port) {
+  put_lane(tb->i_upd_vld, port, 1, up.vld());
   if (up.vld()) {
-    tb->i_upd_prod_id = up.prod_id();
-    tb->i_upd_cmd = static_cast<std::underlying_type_t<Cmd>>(up.cmd());
-    tb->i_upd_key = up.key();
-    tb->i_upd_size = up.volume();
+    put_lane(tb->i_upd_prod_id, port, ID_BITS, up.prod_id());
+    put_lane(tb->i_upd_cmd, port, CMD_BITS,
+             static_cast<std::underlying_type_t<Cmd>>(up.cmd()));
+    put_lane(tb->i_upd_key, port, KEY_BITS, up.key());
+    put_lane(tb->i_upd_size, port, SIZE_BITS, up.volume());
   }
 }
 
 // Drive Query Command Interface
-void VDriver::issue(Vtb* tb, const QueryCommand& qc) {
-  tb->i_lut_vld = qc.vld();
+void VDriver::issue(Vtb* tb, const QueryCommand& qc, std::size_t port) {
+  put_lane(tb->i_lut_vld, port, 1, qc.vld());
   if (qc.vld()) {
-    tb->i_lut_prod_id = qc.prod_id();
-    tb->i_lut_level = qc.level();
+    put_lane(tb->i_lut_prod_id, port, ID_BITS, qc.prod_id());
+    put_lane(tb->i_lut_level, port, LEVEL_BITS, qc.level());
+    put_lane(tb->i_lut_snap, port, 1, qc.snapshot());
+    put_lane(tb->i_lut_cum, port, 1, qc.cum());
+    put_lane(tb->i_lut_rev, port, 1, qc.is_lookup());
+    put_lane(tb->i_lut_key, port, KEY_BITS, qc.key());
   }
 }
 
+// Drive Subscription Interface
+void VDriver::issue(Vtb* tb, const SubscribeCommand& sc) {
+  set_bool(&tb->i_sub_vld, sc.vld());
+  if (sc.vld()) {
+    put_lane(tb->i_sub_prod_id, 0, ID_BITS, sc.prod_id());
+    set_bool(&tb->i_sub_en, sc.en());
+  }
+}
+
+void VDriver::nfy_ready(Vtb* tb, bool ready, std::size_t lane) {
+  put_lane(tb->i_nfy_ready, lane, 1, ready);
+}
+
 bool VDriver::is_busy(Vtb* tb) { return (tb->o_busy_r != 0); }
 
 void VDriver::reset(Vtb* tb, bool r) { tb->arst_n = r ? 1 : 0; }
 
+void VDriver::preload(Vtb* tb, const Snapshot& s) {
+  // Context 'id' resides in bank (id % UPDATE_PORTS_N) at address
+  // (id / UPDATE_PORTS_N). All tables (Update, and each Query replica) of a
+  // bank hold identical state, each retained across a number of memory
+  // columns and a live tag. Depending upon the Verilator version, generate
+  // block scopes are named either verbatim or with escaped brackets.
+  auto idx = [](std::size_t i, bool escaped) {
+    const std::string is{std::to_string(i)};
+    return escaped ? ("__BRA__" + is + "__KET__") : ("[" + is + "]");
+  };
+  for (std::size_t b = 0; b < cfg::UPDATE_PORTS_N; ++b) {
+    for (std::size_t t = 0; t < (1 + cfg::QUERY_PORTS_N); ++t) {
+      auto table = [&](bool escaped) {
+        return (t == 0) ? std::string{"u_state_update"}
+                        : "replica_GEN" + idx(t - 1, escaped) +
+                              ".u_state_query";
+      };
+      auto set_scope = [&](const std::string& instance) {
+        const std::string names[] = {
+            "TOP.tb.u_v.bank_GEN" + idx(b, false) + "." + table(false) + "." +
+                instance,
+            "TOP.tb.u_v.bank_GEN" + idx(b, true) + "." + table(true) + "." +
+                instance};
+        svScope scope = nullptr;
+        for (const std::string& name : names) {
+          if ((scope = svGetScopeFromName(name.c_str())) != nullptr) break;
+        }
+        if (scope == nullptr) {
+          throw std::runtime_error("Backdoor scope not found: " + names[0]);
+        }
+        svSetScope(scope);
+      };
+      for (const StateColumn& c : STATE_COLUMNS) {
+        set_scope(c.name);
+        for (std::size_t id = b; id < cfg::CONTEXT_N;
+             id += cfg::UPDATE_PORTS_N) {
+          const std::vector<std::uint32_t> ws{column_words(
+              s.state_words(static_cast<prod_id_t>(id)), c)};
+          for (std::size_t i = 0; i < ws.size(); ++i) {
+            sram1r1w_backdoor_write(
+                static_cast<int>(id / cfg::UPDATE_PORTS_N),
+                static_cast<int>(i), ws[i]);
+          }
+        }
+      }
+      set_scope("u_tag1r1w");
+      for (std::size_t id = b; id < cfg::CONTEXT_N;
+           id += cfg::UPDATE_PORTS_N) {
+        const bool live = !s.context(static_cast<prod_id_t>(id)).empty();
+        tag1r1w_backdoor_write(static_cast<int>(id / cfg::UPDATE_PORTS_N),
+                               live ? 1 : 0);
+      }
+    }
+  }
+}
+
+UpdateCommand VSampler::uc(Vtb* tb, std::size_t port) {
+  if (get_lane(tb->i_upd_vld, port, 1)) {
+    return UpdateCommand{
+        static_cast<prod_id_t>(get_lane(tb->i_upd_prod_id, port, ID_BITS)),
+        to_cmd(static_cast<vluint8_t>(get_lane(tb->i_upd_cmd, port, CMD_BITS))),
+        static_cast<key_t>(get_lane(tb->i_upd_key, port, KEY_BITS)),
+        static_cast<volume_t>(get_lane(tb->i_upd_size, port, SIZE_BITS))};
+  } else {
+    return UpdateCommand{};
+  }
+}
+
+QueryCommand VSampler::qc(Vtb* tb, std::size_t port) {
+  if (get_lane(tb->i_lut_vld, port, 1) && get_lane(tb->i_lut_rev, port, 1)) {
+    return QueryCommand::lookup(
+        static_cast<prod_id_t>(get_lane(tb->i_lut_prod_id, port, ID_BITS)),
+        static_cast<key_t>(get_lane(tb->i_lut_key, port, KEY_BITS)));
+  } else if (get_lane(tb->i_lut_vld, port, 1)) {
+    return QueryCommand{
+        static_cast<prod_id_t>(get_lane(tb->i_lut_prod_id, port, ID_BITS)),
+        static_cast<level_t>(get_lane(tb->i_lut_level, port, LEVEL_BITS)),
+        get_lane(tb->i_lut_snap, port, 1) != 0,
+        get_lane(tb->i_lut_cum, port, 1) != 0};
+  } else {
+    return QueryCommand{};
+  }
+}
+
+NotifyResponse VSampler::nr(Vtb* tb, std::size_t lane) {
+  if (get_lane(tb->o_lv0_vld_r, lane, 1)) {
+    return NotifyResponse{
+        static_cast<prod_id_t>(get_lane(tb->o_lv0_prod_id_r, lane, ID_BITS)),
+        static_cast<key_t>(get_lane(tb->o_lv0_key_r, lane, KEY_BITS)),
+        static_cast<volume_t>(get_lane(tb->o_lv0_size_r, lane, SIZE_BITS))};
+  } else {
+    return NotifyResponse{};
+  }
+}
+
+QueryResponse VSampler::qr(Vtb* tb, std::size_t port) {
+  if (get_lane(tb->o_lut_vld_r, port, 1) &&
+      get_lane(tb->o_lut_snap_r, port, 1)) {
+    // Snapshot: retain the valid levels, lanes of the snapshot bus are indexed
+    // by (port, level).
+    std::vector<QueryLevel> levels;
+    for (std::size_t k = 0; k < cfg::SNAPSHOT_K; k++) {
+      const std::size_t lane = port * cfg::SNAPSHOT_K + k;
+      if (!get_lane(tb->o_lut_snap_vld, lane, 1)) continue;
+      levels.push_back(QueryLevel{
+          static_cast<key_t>(get_lane(tb->o_lut_snap_key, lane, KEY_BITS)),
+          static_cast<volume_t>(
+              get_lane(tb->o_lut_snap_size, lane, SIZE_BITS))});
+    }
+    return QueryResponse{
+        std::move(levels), get_lane(tb->o_lut_error, port, 1) != 0,
+        static_cast<listsize_t>(
+            get_lane(tb->o_lut_listsize, port, LISTSIZE_BITS))};
+  } else if (get_lane(tb->o_lut_vld_r, port, 1) &&
+             get_lane(tb->o_lut_cum_r, port, 1)) {
+    return QueryResponse{
+        static_cast<key_t>(get_lane(tb->o_lut_key, port, KEY_BITS)),
+        static_cast<volume_t>(get_lane(tb->o_lut_size, port, SIZE_BITS)),
+        static_cast<cum_t>(get_lane(tb->o_lut_cum, port, CUM_BITS)),
+        get_lane(tb->o_lut_error, port, 1) != 0,
+        static_cast<listsize_t>(
+            get_lane(tb->o_lut_listsize, port, LISTSIZE_BITS))};
+  } else if (get_lane(tb->o_lut_vld_r, port, 1)) {
+    return QueryResponse{
+        static_cast<key_t>(get_lane(tb->o_lut_key, port, KEY_BITS)),
+        static_cast<volume_t>(get_lane(tb->o_lut_size, port, SIZE_BITS)),
+        get_lane(tb->o_lut_error, port, 1) != 0,
+        static_cast<listsize_t>(
+            get_lane(tb->o_lut_listsize, port, LISTSIZE_BITS))};
+  } else {
+    return QueryResponse{};
+  }
+}
+
+LookupResponse VSampler::lr(Vtb* tb, std::size_t port) {
+  if (get_lane(tb->o_lut_rev_vld_r, port, 1)) {
+    return LookupResponse{
+        get_lane(tb->o_lut_rev_hit, port, 1) != 0,
+        static_cast<level_t>(get_lane(tb->o_lut_rev_level, port, LEVEL_BITS)),
+        static_cast<volume_t>(get_lane(tb->o_lut_rev_size, port, SIZE_BITS)),
+        static_cast<listsize_t>(
+            get_lane(tb->o_lut_rev_better, port, LISTSIZE_BITS)),
+        get_lane(tb->o_lut_rev_error, port, 1) != 0};
+  } else {
+    return LookupResponse{};
+  }
+}
+
+SubscribeCommand VSampler::sc(Vtb* tb) {
+  if (to_bool(tb->i_sub_vld)) {
+    return SubscribeCommand{
+        static_cast<prod_id_t>(get_lane(tb->i_sub_prod_id, 0, ID_BITS)),
+        to_bool(tb->i_sub_en)};
+  } else {
+    return SubscribeCommand{};
+  }
+}
+
+NotifyEgress VSampler::nfy(Vtb* tb, std::size_t lane) {
+  NotifyResponse nr{};
+  if (get_lane(tb->o_nfy_vld_r, lane, 1)) {
+    nr = NotifyResponse{
+        static_cast<prod_id_t>(get_lane(tb->o_nfy_prod_id_r, lane, ID_BITS)),
+        static_cast<key_t>(get_lane(tb->o_nfy_key, lane, KEY_BITS)),
+        static_cast<volume_t>(get_lane(tb->o_nfy_size, lane, SIZE_BITS))};
+  }
+  return NotifyEgress{
+      nr, static_cast<vluint32_t>(get_lane(tb->o_nfy_overflow_r, lane, 32))};
+}
+
+bool VSampler::nfy_ready(Vtb* tb, std::size_t lane) {
+  return get_lane(tb->i_nfy_ready, lane, 1) != 0;
+}
+
+PipeSample VSampler::pipe(Vtb* tb) {
+  PipeSample ps;
+  for (std::size_t b = 0; b < cfg::UPDATE_PORTS_N; ++b) {
+    ps.upd_vld[b] = get_lane(tb->o_tb_upd_vld_r, b, 5);
+    ps.upd_fwd[b] = get_lane(tb->o_tb_upd_state_fwd, b, 4);
+  }
+  for (std::size_t p = 0; p < cfg::QUERY_PORTS_N; ++p) {
+    ps.lut_vld[p] = (get_lane(tb->i_lut_vld, p, 1) ? 0b01 : 0) |
+                    (get_lane(tb->o_tb_lut_vld_r, p, 1) ? 0b10 : 0);
+  }
+  return ps;
+}
+
 }  // namespace tb
@@ -28,6 +28,7 @@
 #ifndef V_TB_TB_H
 #define V_TB_TB_H
 
+#include <chrono>
 #include <exception>
 #include <memory>
 #include <string>
@@ -51,13 +52,25 @@ class QueryCommand;
 class Kernel;
 class Logger;
 class Scope;
+class NotifyResponse;
+class NotifyEgress;
+class SubscribeCommand;
+class QueryResponse;
+class LookupResponse;
+class Snapshot;
+struct PipeSample;
+
+namespace trace {
+class Writer;
+}  // namespace trace
 
 void register_tests(TestRegistry& tr);
 
 struct Sim {
   static void initialize();
 
-  inline static std::optional<std::string> test_name;
+  //! Tests to be run, in order, on a single Kernel instance.
+  inline static std::vector<std::string> test_names;
 
   inline static std::vector<std::string> test_args;
 
@@ -67,6 +80,9 @@ struct Sim {
   inline static std::string vcd_fn = "v.vcd";
 #endif
 
+  //! Stimulus trace file name (recording enabled when set).
+  inline static std::optional<std::string> record_fn;
+
   //! Global logger
   inline static std::unique_ptr<Logger> logger;
 
@@ -79,6 +95,9 @@ struct Sim {
   //! Global validation model.
   inline static std::unique_ptr<Model> model;
 
+  //! Book snapshot preloaded, by backdoor, following initialization.
+  inline static std::shared_ptr<const Snapshot> snapshot;
+
   //! Pass indication status (final traced line)
   inline static std::string_view pass_note = "PASS!\n";
 
@@ -91,6 +110,9 @@ struct Sim {
 
   //! Total number of errors encountered before the simulations is terminated.
   inline static int error_max = 1;
+
+  //! Class of the first mismatch reported by the model (reason and interface).
+  inline static std::optional<std::string> fail_class;
 };
 
 struct KernelCallbacks {
@@ -121,29 +143,79 @@ class Kernel {
   std::uint64_t tb_time() const { return tb_time_; }
   std::uint64_t tb_cycle() const;
 
+  // Accumulate time spent evaluating the model (for benchmarking).
+  void set_profile(bool en) { profile_ = en; }
+  std::chrono::nanoseconds model_time() const { return model_time_; }
+
  private:
   bool eval_clock_edge(KernelCallbacks* cb, bool edge);
+  void preload();
+  void record();
 #ifdef ENABLE_VCD
   std::unique_ptr<VerilatedVcdC> vcd_;
 #endif
   std::unique_ptr<VerilatedContext> vctxt_;
   std::unique_ptr<Vtb> vtb_;
+  std::unique_ptr<trace::Writer> recorder_;
   std::uint64_t tb_time_;
+  // Snapshot awaits completion of initialization.
+  bool preload_pending_{false};
+  bool preload_saw_busy_{false};
+  bool profile_{false};
+  std::chrono::nanoseconds model_time_{0};
   Scope* logger_{nullptr};
 };
 
 struct VDriver {
-  //
-  static void issue(Vtb* tb, const UpdateCommand& uc);
+  // Drive 'uc' onto Update 'port' (one of cfg::UPDATE_PORTS_N).
+  static void issue(Vtb* tb, const UpdateCommand& uc, std::size_t port = 0);
 
-  //
-  static void issue(Vtb* tb, const QueryCommand& qc);
+  // Drive 'qc' onto Query 'port' (one of cfg::QUERY_PORTS_N).
+  static void issue(Vtb* tb, const QueryCommand& qc, std::size_t port = 0);
+
+  // Drive 'sc' onto the Subscription Interface.
+  static void issue(Vtb* tb, const SubscribeCommand& sc);
+
+  // Drive ready of the coalesced Notify egress of 'lane' (one per bank).
+  static void nfy_ready(Vtb* tb, bool ready, std::size_t lane = 0);
 
   //
   static bool is_busy(Vtb* tb);
 
   //
   static void reset(Vtb* tb, bool r);
+
+  // Backdoor write of the Context state tables (all banks and replicas).
+  static void preload(Vtb* tb, const Snapshot& s);
+};
+
+struct VSampler {
+  // Sample Update Command Interface (of 'port'):
+  static UpdateCommand uc(Vtb* tb, std::size_t port = 0);
+
+  // Sample Query Command Interface (of 'port'):
+  static QueryCommand qc(Vtb* tb, std::size_t port = 0);
+
+  // Sample Notify Reponse Interface (of 'lane', one per bank):
+  static NotifyResponse nr(Vtb* tb, std::size_t lane = 0);
+
+  // Sample Query Response Interface (of 'port'):
+  static QueryResponse qr(Vtb* tb, std::size_t port = 0);
+
+  // Sample Key Lookup Response Interface (of 'port'):
+  static LookupResponse lr(Vtb* tb, std::size_t port = 0);
+
+  // Sample Subscription Interface:
+  static SubscribeCommand sc(Vtb* tb);
+
+  // Sample coalesced Notify egress (of 'lane', one per bank):
+  static NotifyEgress nfy(Vtb* tb, std::size_t lane = 0);
+
+  // Sample ready of the coalesced Notify egress (of 'lane'):
+  static bool nfy_ready(Vtb* tb, std::size_t lane = 0);
+
+  // Sample pipeline stage occupancy:
+  static PipeSample pipe(Vtb* tb);
 };
 
 }  // namespace tb
@@ -32,32 +32,106 @@
 module tb (
 
 // -------------------------------------------------------------------------- //
-// List Update Bus
-  input wire logic                                i_upd_vld
-, input wire v_pkg::id_t                          i_upd_prod_id
-, input wire v_pkg::cmd_t                         i_upd_cmd
-, input wire v_pkg::key_t                         i_upd_key
-, input wire v_pkg::size_t                        i_upd_size
+// List Update Bus (per port)
+  input wire logic [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_vld
+, input wire v_pkg::id_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_prod_id
+, input wire v_pkg::cmd_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_cmd
+, input wire v_pkg::key_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_key
+, input wire v_pkg::size_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_upd_size
 
 // -------------------------------------------------------------------------- //
-// List Query Bus
-, input wire logic                                i_lut_vld
-, input wire v_pkg::id_t                          i_lut_prod_id
-, input wire v_pkg::level_t                       i_lut_level
+// List Query Bus (per port)
+, input wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_vld
+, input wire v_pkg::id_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_prod_id
+, input wire v_pkg::level_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_level
+, input wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_snap
+, input wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_cum
+, input wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_rev
+, input wire v_pkg::key_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  i_lut_key
 //
-, output wire logic                               o_lut_vld_r
-, output wire v_pkg::key_t                        o_lut_key
-, output wire v_pkg::size_t                       o_lut_size
-, output wire logic                               o_lut_error
-, output wire v_pkg::listsize_t                   o_lut_listsize
+, output wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_vld_r
+, output wire v_pkg::key_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_key
+, output wire v_pkg::size_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_size
+, output wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_error
+, output wire v_pkg::listsize_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_listsize
+//
+, output wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_snap_r
+, output wire v_pkg::snap_vld_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_snap_vld
+, output wire v_pkg::snap_key_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_snap_key
+, output wire v_pkg::snap_volume_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_snap_size
+//
+, output wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_cum_r
+, output wire v_pkg::cum_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_cum
+//
+, output wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_rev_vld_r
+, output wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_rev_hit
+, output wire v_pkg::level_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_rev_level
+, output wire v_pkg::size_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_rev_size
+, output wire v_pkg::listsize_t [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_rev_better
+, output wire logic [cfg_pkg::QUERY_PORTS_N - 1:0]
+                                                  o_lut_rev_error
 
 // -------------------------------------------------------------------------- //
-// Notify Bus
+// Notify Bus (per bank)
 
-, output wire logic                               o_lv0_vld_r
-, output wire v_pkg::id_t                         o_lv0_prod_id_r
-, output wire v_pkg::key_t                        o_lv0_key_r
-, output wire v_pkg::size_t                       o_lv0_size_r
+, output wire logic [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_lv0_vld_r
+, output wire v_pkg::id_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_lv0_prod_id_r
+, output wire v_pkg::key_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_lv0_key_r
+, output wire v_pkg::size_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_lv0_size_r
+
+// -------------------------------------------------------------------------- //
+// Notify Subscription
+, input wire logic                                i_sub_vld
+, input wire v_pkg::id_t                          i_sub_prod_id
+, input wire logic                                i_sub_en
+
+// -------------------------------------------------------------------------- //
+// Coalesced Notify Egress (per bank)
+, output wire logic [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_nfy_vld_r
+, output wire v_pkg::id_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_nfy_prod_id_r
+, output wire v_pkg::key_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_nfy_key
+, output wire v_pkg::size_t [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  o_nfy_size
+, input wire logic [cfg_pkg::UPDATE_PORTS_N - 1:0]
+                                                  i_nfy_ready
+//
+, output wire logic [cfg_pkg::UPDATE_PORTS_N - 1:0][31:0]
+                                                  o_nfy_overflow_r
 
 // -------------------------------------------------------------------------- //
 // Status
@@ -70,6 +144,12 @@ module tb (
 , output wire logic                               o_tb_wrbk_vld_r
 , output wire v_pkg::id_t                         o_tb_wrbk_prod_id_r
 , output wire v_pkg::state_t                      o_tb_wrbk_state_r
+//
+, output wire logic [cfg_pkg::UPDATE_PORTS_N - 1:0][4:0]
+                                                  o_tb_upd_vld_r
+, output wire logic [cfg_pkg::UPDATE_PORTS_N - 1:0][3:0]
+                                                  o_tb_upd_state_fwd
+, output wire logic [cfg_pkg::QUERY_PORTS_N - 1:0] o_tb_lut_vld_r
 
 // -------------------------------------------------------------------------- //
 // Clk/Reset
@@ -102,17 +182,44 @@ v u_v (
   , .i_lut_vld                          (i_lut_vld)
   , .i_lut_prod_id                      (i_lut_prod_id)
   , .i_lut_level                        (i_lut_level)
+  , .i_lut_snap                         (i_lut_snap)
+  , .i_lut_cum                          (i_lut_cum)
+  , .i_lut_rev                          (i_lut_rev)
+  , .i_lut_key                          (i_lut_key)
   , .o_lut_vld_r                        (o_lut_vld_r)
   , .o_lut_key                          (o_lut_key)
   , .o_lut_size                         (o_lut_size)
   , .o_lut_error                        (o_lut_error)
   , .o_lut_listsize                     (o_lut_listsize)
+  , .o_lut_snap_r                       (o_lut_snap_r)
+  , .o_lut_snap_vld                     (o_lut_snap_vld)
+  , .o_lut_snap_key                     (o_lut_snap_key)
+  , .o_lut_snap_size                    (o_lut_snap_size)
+  , .o_lut_cum_r                        (o_lut_cum_r)
+  , .o_lut_cum                          (o_lut_cum)
+  , .o_lut_rev_vld_r                    (o_lut_rev_vld_r)
+  , .o_lut_rev_hit                      (o_lut_rev_hit)
+  , .o_lut_rev_level                    (o_lut_rev_level)
+  , .o_lut_rev_size                     (o_lut_rev_size)
+  , .o_lut_rev_better                   (o_lut_rev_better)
+  , .o_lut_rev_error                    (o_lut_rev_error)
   //
   , .o_lv0_vld_r                        (o_lv0_vld_r)
   , .o_lv0_prod_id_r                    (o_lv0_prod_id_r)
   , .o_lv0_key_r                        (o_lv0_key_r)
   , .o_lv0_size_r                       (o_lv0_size_r)
   //
+  , .i_sub_vld                          (i_sub_vld)
+  , .i_sub_prod_id                      (i_sub_prod_id)
+  , .i_sub_en                           (i_sub_en)
+  //
+  , .o_nfy_vld_r                        (o_nfy_vld_r)
+  , .o_nfy_prod_id_r                    (o_nfy_prod_id_r)
+  , .o_nfy_key                          (o_nfy_key)
+  , .o_nfy_size                         (o_nfy_size)
+  , .i_nfy_ready                        (i_nfy_ready)
+  , .o_nfy_overflow_r                   (o_nfy_overflow_r)
+  //
   , .o_busy_r                           (o_busy_r)
   //
   , .clk                                (clk)
@@ -140,9 +247,38 @@ always_ff @(posedge clk)
 
 assign o_tb_cycle = tb_cycle;
 
-// Expose updates to the state table.
-assign o_tb_wrbk_vld_r = u_v.u_v_pipe_update.wrbk_vld_r;
-assign o_tb_wrbk_prod_id_r = u_v.u_v_pipe_update.wrbk_prod_id_r;
-assign o_tb_wrbk_state_r = u_v.u_v_pipe_update.wrbk_state_r;
+// Expose updates to the state table (of bank 0).
+assign o_tb_wrbk_vld_r = u_v.bank_GEN[0].u_v_pipe_update.wrbk_vld_r;
+assign o_tb_wrbk_prod_id_r = u_v.bank_GEN[0].u_v_pipe_update.wrbk_prod_id_r;
+assign o_tb_wrbk_state_r = u_v.bank_GEN[0].u_v_pipe_update.wrbk_state_r;
+
+// Expose pipeline stage occupancy (for utilization statistics) of each bank.
+for (genvar b = 0; b < cfg_pkg::UPDATE_PORTS_N; b++) begin : tb_bank_GEN
+
+  assign o_tb_upd_vld_r [b] = {
+      u_v.bank_GEN[b].u_v_pipe_update.wrbk_vld_r
+    , u_v.bank_GEN[b].u_v_pipe_update.s4_upd_vld_r
+    , u_v.bank_GEN[b].u_v_pipe_update.s3_upd_vld_r
+    , u_v.bank_GEN[b].u_v_pipe_update.s2_upd_vld_r
+    , u_v.bank_GEN[b].u_v_pipe_update.s1_upd_vld_r
+  };
+
+  // Forwarding into S2: [1] from the writeback computed in S4 (EXE), [0] from
+  // the prior writeback captured in S1 and [2] from the registered writeback.
+  // Forwarding into S3: [3] from EXE (full forwarding).
+  assign o_tb_upd_state_fwd [b] = {
+      u_v.bank_GEN[b].u_v_pipe_update.s3_upd_state_fwd_exe
+    , u_v.bank_GEN[b].u_v_pipe_update.s2_upd_state_fwd_wrbk
+    , u_v.bank_GEN[b].u_v_pipe_update.s2_upd_state_fwd
+  };
+
+end // block: tb_bank_GEN
+
+// Query pipeline occupancy of each port.
+for (genvar p = 0; p < cfg_pkg::QUERY_PORTS_N; p++) begin : tb_query_GEN
+
+  assign o_tb_lut_vld_r [p] = u_v.query_GEN[p].u_v_pipe_query.s1_lut_vld_r;
+
+end // block: tb_query_GEN
 
 endmodule // v
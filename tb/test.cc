@@ -66,6 +66,7 @@ void JsonDict::add(const std::string& k, const __type& t) { \
 }
 DECLARE_ADD(JsonString)
 DECLARE_ADD(JsonInteger)
+DECLARE_ADD(JsonDouble)
 DECLARE_ADD(JsonArray)
 DECLARE_ADD(JsonDict)
 #undef DECLARE_ADD
@@ -93,6 +94,7 @@ void JsonArray::add(const __type& t) { \
 }
 DECLARE_ADD(JsonString)
 DECLARE_ADD(JsonInteger)
+DECLARE_ADD(JsonDouble)
 DECLARE_ADD(JsonArray)
 DECLARE_ADD(JsonDict)
 #undef DECLARE_ADD
@@ -113,6 +115,14 @@ void JsonInteger::serialize(std::ostream& os, std::size_t offset) const {
   os << i_;
 }
 
+JsonObject* JsonDouble::clone() const {
+  return new JsonDouble(d_);
+}
+
+void JsonDouble::serialize(std::ostream& os, std::size_t offset) const {
+  os << d_;
+}
+
 void TestBuilder::build(Test* t, Scope* logger) const {
   t->logger_ = logger;
 }
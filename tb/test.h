@@ -28,6 +28,7 @@
 #ifndef V_VERIF_TEST_H
 #define V_VERIF_TEST_H
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -68,6 +69,7 @@ class Scope;
       d.add("name", name());                              \
       return d;                                           \
     }                                                     \
+    bool has_args() const override { return true; }       \
     std::unique_ptr<::tb::Test> construct(                \
         ::tb::Scope* logger) const override {             \
       auto t = std::make_unique<__name>();                \
@@ -77,12 +79,13 @@ class Scope;
   }
 
 class JsonArray;
+class JsonDouble;
 class JsonInteger;
 class JsonString;
 
 class JsonObject {
 protected:
-  enum class Type { Object, String, Integer, Array, Dict };
+  enum class Type { Object, String, Integer, Double, Array, Dict };
   virtual Type type() const { return Type::Object; }
 public:
   explicit JsonObject() = default;
@@ -105,6 +108,7 @@ public:
 
   void add(const std::string& k, const JsonString& s);
   void add(const std::string& k, const JsonInteger& i);
+  void add(const std::string& k, const JsonDouble& d);
   void add(const std::string& k, const JsonArray& a);
   void add(const std::string& k, const JsonDict& d);
 
@@ -122,6 +126,7 @@ public:
 
   void add(const JsonString& s);
   void add(const JsonInteger& i);
+  void add(const JsonDouble& d);
   void add(const JsonArray& a);
   void add(const JsonDict& d);
 
@@ -144,12 +149,23 @@ private:
 class JsonInteger : public JsonObject {
   Type type() const override { return Type::Integer; }
 public:
-  /* no explicit */ JsonInteger(int i) : i_(i) {}
+  /* no explicit */ JsonInteger(std::int64_t i) : i_(i) {}
 
   JsonObject* clone() const override;
   void serialize(std::ostream& os, std::size_t offset = 0) const override;
 private:
-  int i_;
+  std::int64_t i_;
+};
+
+class JsonDouble : public JsonObject {
+  Type type() const override { return Type::Double; }
+public:
+  explicit JsonDouble(double d) : d_(d) {}
+
+  JsonObject* clone() const override;
+  void serialize(std::ostream& os, std::size_t offset = 0) const override;
+private:
+  double d_;
 };
 
 class Test {
@@ -176,6 +192,10 @@ class TestBuilder {
   virtual std::unique_ptr<Test> construct(::tb::Scope*) const = 0;
   virtual JsonDict args() const = 0;
 
+  // Test is parameterized by arguments (and therefore excluded from
+  // --run-all).
+  virtual bool has_args() const { return false; }
+
  protected:
   void build(Test* t, Scope* logger) const;
 };
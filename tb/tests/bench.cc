@@ -0,0 +1,404 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "bench.h"
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include "../log.h"
+#include "../model.h"
+#include "../rnd.h"
+#include "../tb.h"
+#include "../test.h"
+#include "Vobj/Vtb.h"
+#include "cfg.h"
+#include "reset.h"
+
+namespace {
+
+enum class Workload { Update, Query, Mixed, Overflow, Clear };
+
+const char* to_string(Workload w) {
+  switch (w) {
+    case Workload::Update:   return "update";
+    case Workload::Query:    return "query";
+    case Workload::Mixed:    return "mixed";
+    case Workload::Overflow: return "overflow";
+    case Workload::Clear:    return "clear";
+  }
+  return "invalid";
+}
+
+struct Options {
+  static Options construct_from_sim();
+
+  Workload workload = Workload::Mixed;
+
+  // Number of cycles in the measured window.
+  int n = 100000;
+
+  // File to which results are written (JSON); stdout otherwise.
+  std::string out;
+
+  // Additionally measure the time spent evaluating the model.
+  bool profile = false;
+};
+
+Options Options::construct_from_sim() {
+  Options opts;
+  for (const std::string& arg : tb::Sim::test_args) {
+    const std::string::size_type i = arg.find('=');
+    const std::string key{arg.substr(0, i)};
+    const std::string value{(i == std::string::npos) ? "" : arg.substr(i + 1)};
+    if (key == "workload") {
+      for (Workload w : {Workload::Update, Workload::Query, Workload::Mixed,
+                         Workload::Overflow, Workload::Clear}) {
+        if (value == to_string(w)) opts.workload = w;
+      }
+    } else if (key == "n") {
+      opts.n = std::stoi(value);
+    } else if (key == "out") {
+      opts.out = value;
+    } else if (key == "profile") {
+      opts.profile = (std::stoi(value) != 0);
+    } else {
+      // Unknown argument
+    }
+  }
+  return opts;
+}
+
+enum class State { Prefill, Measure, WindDown };
+
+// Width of the state of a single Context.
+constexpr const std::int64_t STATE_BITS = cfg::STATE_BITS;
+
+// Words per state table; each bank retains one Update table and one replica
+// per Query port.
+constexpr const std::int64_t BANK_CONTEXT_N =
+    cfg::CONTEXT_N / cfg::UPDATE_PORTS_N;
+constexpr const std::int64_t STATE_TABLES_N =
+    cfg::UPDATE_PORTS_N * (1 + cfg::QUERY_PORTS_N);
+
+struct Metrics {
+  // Cycles for which the machine is busy initializing after reset.
+  std::size_t init_cycles = 0;
+  std::size_t cycles = 0;
+  std::size_t update_n = 0;
+  std::size_t query_n = 0;
+  std::size_t notify_n = 0;
+  std::size_t query_error_n = 0;
+  std::size_t query_response_n = 0;
+  std::chrono::duration<double> elapsed{0};
+  // Time spent evaluating the model (where profiled).
+  std::optional<std::chrono::nanoseconds> model_elapsed;
+
+  tb::JsonDict to_json(Workload w) const;
+};
+
+tb::JsonDict Metrics::to_json(Workload w) const {
+  auto ppm = [](std::size_t n, std::size_t d) {
+    return (d == 0) ? 0 : static_cast<int>((n * 1000000) / d);
+  };
+  const double s = elapsed.count();
+  const std::size_t command_n = update_n + query_n;
+
+  tb::JsonDict d;
+  d.add("workload", to_string(w));
+  d.add("context_n", static_cast<int>(cfg::CONTEXT_N));
+  d.add("entries_n", static_cast<int>(cfg::ENTRIES_N));
+  d.add("entries_block_n", static_cast<int>(cfg::ENTRIES_BLOCK_N));
+  d.add("update_ports_n", static_cast<int>(cfg::UPDATE_PORTS_N));
+  d.add("query_ports_n", static_cast<int>(cfg::QUERY_PORTS_N));
+  // State footprint (in bits) and initialization time.
+  d.add("state_bits", STATE_BITS);
+  d.add("memory_bits", STATE_TABLES_N * BANK_CONTEXT_N * STATE_BITS);
+  d.add("init_cycles", static_cast<int>(init_cycles));
+  d.add("cycles", static_cast<int>(cycles));
+  d.add("commands", static_cast<int>(command_n));
+  // Host-level metrics.
+  d.add("cycles_per_s", static_cast<int>((s > 0) ? (cycles / s) : 0));
+  d.add("ns_per_command",
+        static_cast<int>((command_n == 0) ? 0 : (s * 1.0e9 / command_n)));
+  // UUT-level metrics, as parts-per-million.
+  d.add("notify_ppm", ppm(notify_n, update_n));
+  d.add("query_error_ppm", ppm(query_error_n, query_response_n));
+  if (model_elapsed) {
+    const auto ns = model_elapsed->count();
+    d.add("model_ns_per_cycle",
+          static_cast<int>((cycles == 0) ? 0 : (ns / cycles)));
+  }
+  return d;
+}
+
+class BenchCB : public tb::KernelCallbacks {
+  using clock = std::chrono::steady_clock;
+
+  // Idle cycles following the measured window, such that in-flight responses
+  // are retired and checked.
+  static constexpr const int WIND_DOWN_N = 10;
+
+  // Probability with which an Update is issued on each port per cycle, in
+  // those workloads which also issue Queries. A Query errors where an Update
+  // to its Context is in flight; at the full Update rate, every Context of a
+  // small configuration is perpetually busy and every Query would error.
+  static constexpr const double MIXED_UPDATE_P = 0.5;
+
+ public:
+  BenchCB(tb::Test* parent, const Options& opts)
+      : parent_(parent), opts_(opts), rstt_(parent->logger(), true) {
+    // Prefill each Context to half capacity before the Query-only and Mixed
+    // workloads, such that queries are not trivially errored. The
+    // Overflow workload fills each Context completely.
+    switch (opts_.workload) {
+      case Workload::Query:
+      case Workload::Mixed:
+        prefill_n_ = cfg::CONTEXT_N * (cfg::ENTRIES_N / 2);
+        break;
+      case Workload::Overflow:
+        prefill_n_ = cfg::CONTEXT_N * cfg::ENTRIES_N;
+        break;
+      default:
+        prefill_n_ = 0;
+        break;
+    }
+  }
+
+  bool on_negedge_clk(Vtb* tb) override {
+    // Issue reset process.
+    if (!rstt_.is_done()) {
+      if (tb::VDriver::is_busy(tb)) ++m_.init_cycles;
+      rstt_.check_reset(tb);
+      return !rstt_.is_failed();
+    }
+
+    // One command per Update port.
+    std::array<tb::UpdateCommand, cfg::UPDATE_PORTS_N> ucs;
+    // One command per Query port.
+    std::array<tb::QueryCommand, cfg::QUERY_PORTS_N> qcs;
+    bool ret = true;
+    switch (st_) {
+      case State::Prefill: {
+        if (prefill_n_ > 0) {
+          for (tb::UpdateCommand& uc : ucs) {
+            if ((prefill_n_ > 0) && generate_add(uc)) --prefill_n_;
+          }
+        } else {
+          st_ = State::Measure;
+          start_ = clock::now();
+          model_start_ = tb::Sim::kernel->model_time();
+        }
+      } break;
+      case State::Measure: {
+        sample(tb);
+        generate(ucs, qcs);
+        for (const tb::UpdateCommand& uc : ucs) {
+          if (uc.vld()) ++m_.update_n;
+        }
+        for (const tb::QueryCommand& qc : qcs) {
+          if (qc.vld()) ++m_.query_n;
+        }
+        if (++m_.cycles == static_cast<std::size_t>(opts_.n)) {
+          m_.elapsed = clock::now() - start_;
+          if (opts_.profile) {
+            m_.model_elapsed = tb::Sim::kernel->model_time() - model_start_;
+          }
+          st_ = State::WindDown;
+        }
+      } break;
+      case State::WindDown: {
+        sample(tb);
+        ret = (++wind_down_n_ < WIND_DOWN_N);
+      } break;
+    }
+    spacing_.advance();
+    for (std::size_t p = 0; p < cfg::UPDATE_PORTS_N; p++) {
+      tb::VDriver::issue(tb, ucs[p], p);
+    }
+    for (std::size_t p = 0; p < cfg::QUERY_PORTS_N; p++) {
+      tb::VDriver::issue(tb, qcs[p], p);
+    }
+    return ret;
+  }
+
+  const Metrics& metrics() const { return m_; }
+
+ private:
+  void sample(Vtb* tb) {
+    for (std::size_t b = 0; b < cfg::UPDATE_PORTS_N; b++) {
+      if (tb::VSampler::nr(tb, b).vld()) ++m_.notify_n;
+    }
+    for (std::size_t p = 0; p < cfg::QUERY_PORTS_N; p++) {
+      if (const tb::QueryResponse qr{tb::VSampler::qr(tb, p)}; qr.vld()) {
+        ++m_.query_response_n;
+        if (qr.error()) ++m_.query_error_n;
+      }
+    }
+  }
+
+  void generate(std::array<tb::UpdateCommand, cfg::UPDATE_PORTS_N>& ucs,
+                std::array<tb::QueryCommand, cfg::QUERY_PORTS_N>& qcs) {
+    tb::Random* r{tb::Sim::random.get()};
+    for (tb::UpdateCommand& uc : ucs) {
+      if ((opts_.workload != Workload::Update) &&
+          !r->bernoulli(MIXED_UPDATE_P)) {
+        continue;
+      }
+      switch (opts_.workload) {
+        case Workload::Update: {
+          generate_update(uc, r->bernoulli(0.5) ? tb::Cmd::Add : tb::Cmd::Del);
+        } break;
+        case Workload::Query: {
+        } break;
+        case Workload::Mixed: {
+          const tb::Cmd cmd = tb::Cmd(r->uniform<int>(3, 1));
+          generate_update(uc, cmd);
+        } break;
+        case Workload::Overflow: {
+          generate_add(uc);
+        } break;
+        case Workload::Clear: {
+          generate_update(uc,
+                          r->bernoulli(0.25) ? tb::Cmd::Clr : tb::Cmd::Add);
+        } break;
+      }
+    }
+    if (opts_.workload != Workload::Update) {
+      for (tb::QueryCommand& qc : qcs) generate_query(qc);
+    }
+  }
+
+  // Select the next Context, in round-robin order, that the spacing rules
+  // permit (given those commands already staged on the current cycle).
+  // Returns false if none are permitted on the current cycle.
+  bool next_context(tb::prod_id_t& prod_id) {
+    for (std::size_t i = 0; i < cfg::CONTEXT_N; i++) {
+      prod_id_ = (prod_id_ + 1) % cfg::CONTEXT_N;
+      if (spacing_.permits(prod_id_)) {
+        prod_id = prod_id_;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool generate_add(tb::UpdateCommand& uc) {
+    return generate_update(uc, tb::Cmd::Add);
+  }
+
+  bool generate_update(tb::UpdateCommand& uc, tb::Cmd cmd) {
+    tb::prod_id_t prod_id;
+    if (!next_context(prod_id)) return false;
+
+    tb::Random* r{tb::Sim::random.get()};
+    switch (cmd) {
+      case tb::Cmd::Add: {
+        uc = tb::UpdateCommand{prod_id, cmd, r->uniform<tb::key_t>(),
+                               r->uniform<tb::volume_t>()};
+      } break;
+      case tb::Cmd::Del:
+      case tb::Cmd::Rep: {
+        const auto [success, key] = val_.pick_active_key(prod_id);
+        uc = tb::UpdateCommand{prod_id, cmd, key, r->uniform<tb::volume_t>()};
+      } break;
+      default: {
+        uc = tb::UpdateCommand{prod_id, cmd, 0, 0};
+      } break;
+    }
+    spacing_.stage(uc);
+    return true;
+  }
+
+  void generate_query(tb::QueryCommand& qc) {
+    tb::Random* r{tb::Sim::random.get()};
+    const tb::prod_id_t prod_id = r->uniform<int>(cfg::CONTEXT_N - 1, 0);
+    const tb::level_t level = r->uniform<int>(cfg::ENTRIES_N - 1, 0);
+    qc = tb::QueryCommand{prod_id, level};
+  }
+
+  tb::Test* parent_;
+  Options opts_;
+  tb::ResetTracker rstt_;
+  State st_ = State::Prefill;
+  std::size_t prefill_n_;
+  int wind_down_n_ = 0;
+  tb::prod_id_t prod_id_ = 0;
+  tb::UpdateSpacing spacing_;
+  tb::ModelValidation val_;
+  clock::time_point start_;
+  std::chrono::nanoseconds model_start_{0};
+  Metrics m_;
+};
+
+struct Bench : public tb::Test {
+  CREATE_TEST_BUILDER_WITH_ARGS(Bench, args);
+
+  bool run() override {
+    const Options opts{Options::construct_from_sim()};
+    BenchCB cb{this, opts};
+    tb::Sim::kernel->set_profile(opts.profile);
+    const bool ret = tb::Sim::kernel->run(std::addressof(cb));
+    tb::Sim::kernel->set_profile(false);
+
+    const tb::JsonDict d{cb.metrics().to_json(opts.workload)};
+    if (opts.out.empty()) {
+      d.serialize(std::cout);
+      std::cout << "\n";
+    } else {
+      std::ofstream ofs{opts.out};
+      d.serialize(ofs);
+      ofs << "\n";
+    }
+    return ret;
+  }
+
+  static tb::JsonDict args() {
+    tb::JsonArray args;
+    for (const char* name : {"workload", "n", "out", "profile"}) {
+      tb::JsonDict arg;
+      arg.add("name", name);
+      args.add(arg);
+    }
+
+    tb::JsonDict d;
+    d.add("arguments", args);
+    return d;
+  }
+};
+
+}  // namespace
+
+namespace tb::tests::bench {
+
+void init(tb::TestRegistry& r) { Bench::Builder::init(r); }
+
+}  // namespace tb::tests::bench
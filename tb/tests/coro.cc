@@ -0,0 +1,157 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "coro.h"
+
+#include "../log.h"
+#include "../tb.h"
+#include "reset.h"
+
+namespace tb::tests {
+
+class Coroutine::Impl : public KernelCallbacks {
+  // Idle cycles following completion of the program, such that in-flight
+  // responses are retired and checked.
+  static constexpr const int WIND_DOWN_N = 10;
+
+ public:
+  explicit Impl(Coroutine* parent)
+      : parent_(parent), rstt_(parent->logger(), true) {}
+
+  bool run() {
+    Task task{parent_->program()};
+    task_ = std::addressof(task);
+    // Program commences on the first cycle after initialization.
+    wait(WaitOn::Cycles, 1, 0);
+    return Sim::kernel->run(this);
+  }
+
+  bool on_negedge_clk(Vtb* tb) override {
+    // Issue reset process.
+    if (!rstt_.is_done()) {
+      rstt_.check_reset(tb);
+      return !rstt_.is_failed();
+    }
+
+    tb_ = tb;
+    VDriver::issue(tb, UpdateCommand{});
+    VDriver::issue(tb, QueryCommand{});
+    nr_ = VSampler::nr(tb);
+    qr_ = VSampler::qr(tb);
+
+    if (task_->done()) return (--wind_down_n_ > 0);
+
+    if (is_ready()) task_->resume();
+    return true;
+  }
+
+  void wait(WaitOn on, std::size_t n, prod_id_t prod_id) {
+    on_ = on;
+    n_ = n;
+    prod_id_ = prod_id;
+    notify_ = NotifyResponse{};
+  }
+
+  void issue(const UpdateCommand& uc) { VDriver::issue(tb_, uc); }
+  void issue(const QueryCommand& qc) { VDriver::issue(tb_, qc); }
+
+  const NotifyResponse& nr() const { return nr_; }
+  const QueryResponse& qr() const { return qr_; }
+  const NotifyResponse& notify() const { return notify_; }
+
+ private:
+  bool is_ready() {
+    switch (on_) {
+      case WaitOn::Cycles: {
+        return (--n_ == 0);
+      } break;
+      case WaitOn::NotBusy: {
+        return !VDriver::is_busy(tb_);
+      } break;
+      case WaitOn::Notify: {
+        if (nr_.vld() && (nr_.prod_id() == prod_id_)) {
+          notify_ = nr_;
+          return true;
+        }
+        if (--n_ == 0) {
+          V_LOG_IF(parent_->logger(), true, Error,
+                   "Timeout awaiting Notify Response for prod_id ",
+                   AsDec{prod_id_});
+          return true;
+        }
+      } break;
+    }
+    return false;
+  }
+
+  Coroutine* parent_;
+  ResetTracker rstt_;
+  Task* task_{nullptr};
+  Vtb* tb_{nullptr};
+  WaitOn on_{WaitOn::Cycles};
+  std::size_t n_{0};
+  prod_id_t prod_id_{0};
+  NotifyResponse nr_;
+  QueryResponse qr_;
+  NotifyResponse notify_;
+  int wind_down_n_{WIND_DOWN_N};
+};
+
+void Coroutine::Task::resume() {
+  h_.resume();
+  if (std::exception_ptr ex = h_.promise().ex) std::rethrow_exception(ex);
+}
+
+void Coroutine::Awaiter::await_suspend(std::coroutine_handle<>) noexcept {
+  parent->wait(on, n, prod_id);
+}
+
+NotifyResponse Coroutine::Awaiter::await_resume() const noexcept {
+  return parent->notify();
+}
+
+Coroutine::Coroutine() { impl_ = std::make_unique<Impl>(this); }
+
+Coroutine::~Coroutine() {}
+
+bool Coroutine::run() { return impl_->run(); }
+
+void Coroutine::issue(const UpdateCommand& uc) { impl_->issue(uc); }
+
+void Coroutine::issue(const QueryCommand& qc) { impl_->issue(qc); }
+
+const NotifyResponse& Coroutine::nr() const { return impl_->nr(); }
+
+const QueryResponse& Coroutine::qr() const { return impl_->qr(); }
+
+void Coroutine::wait(WaitOn on, std::size_t n, prod_id_t prod_id) {
+  impl_->wait(on, n, prod_id);
+}
+
+const NotifyResponse& Coroutine::notify() const { return impl_->notify(); }
+
+}  // namespace tb::tests
@@ -0,0 +1,145 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef V_TB_TESTS_CORO_H
+#define V_TB_TESTS_CORO_H
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <utility>
+
+#include "../model.h"
+#include "../test.h"
+
+class Vtb;
+
+namespace tb::tests {
+
+// Directed test authored as a C++20 coroutine. The coroutine is resumed
+// directly from the negative clock edge callback; stimulus is therefore
+// generated lazily, and may depend upon responses sampled on the current
+// cycle. Commands issued between two suspension points are driven for one
+// cycle; interfaces are otherwise idle.
+//
+//   Task program() override {
+//     issue(UpdateCommand{0, Cmd::Add, 1, 1});
+//     const NotifyResponse nr = co_await notify_for(0);
+//     issue(QueryCommand{0, 0});
+//     co_await cycles(1);
+//   }
+//
+class Coroutine : public Test {
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+
+ public:
+  class Task {
+   public:
+    struct promise_type {
+      Task get_return_object() {
+        return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+      }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      std::suspend_always final_suspend() noexcept { return {}; }
+      void return_void() {}
+      void unhandled_exception() { ex = std::current_exception(); }
+
+      std::exception_ptr ex;
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> h) : h_(h) {}
+    Task(Task&& t) : h_(std::exchange(t.h_, nullptr)) {}
+    Task(const Task&) = delete;
+    ~Task() {
+      if (h_) h_.destroy();
+    }
+
+    bool done() const { return !h_ || h_.done(); }
+
+    // Resume coroutine until its next suspension point.
+    void resume();
+
+   private:
+    std::coroutine_handle<promise_type> h_;
+  };
+
+  enum class WaitOn { Cycles, NotBusy, Notify };
+
+  struct Awaiter {
+    bool await_ready() const noexcept {
+      return (on == WaitOn::Cycles) && (n == 0);
+    }
+    void await_suspend(std::coroutine_handle<>) noexcept;
+    NotifyResponse await_resume() const noexcept;
+
+    Coroutine* parent;
+    WaitOn on;
+    std::size_t n;
+    prod_id_t prod_id;
+  };
+
+  explicit Coroutine();
+  ~Coroutine();
+
+  bool run() override;
+
+  virtual Task program() = 0;
+
+ protected:
+  // Resume after 'n' cycles.
+  Awaiter cycles(std::size_t n = 1) {
+    return Awaiter{this, WaitOn::Cycles, n, 0};
+  }
+
+  // Resume once the UUT is no longer busy (initialization has completed).
+  Awaiter not_busy() { return Awaiter{this, WaitOn::NotBusy, 0, 0}; }
+
+  // Resume upon the cycle on which a Notify Response for 'prod_id' is
+  // sampled. The response is returned. An error is raised, and an invalid
+  // response returned, should none be sampled within 'timeout_n' cycles.
+  Awaiter notify_for(prod_id_t prod_id, std::size_t timeout_n = 1000) {
+    return Awaiter{this, WaitOn::Notify, timeout_n, prod_id};
+  }
+
+  // Issue command on the current cycle.
+  void issue(const UpdateCommand& uc);
+  void issue(const QueryCommand& qc);
+
+  // Responses sampled on the current cycle.
+  const NotifyResponse& nr() const;
+  const QueryResponse& qr() const;
+
+ private:
+  void wait(WaitOn on, std::size_t n, prod_id_t prod_id);
+  const NotifyResponse& notify() const;
+};
+
+}  // namespace tb::tests
+
+#endif
@@ -38,6 +38,8 @@ enum class Opcode {
   WaitUntilNotBusy,
   WaitCycles,
   Emit,
+  Subscribe,
+  NotifyReady,
   EndSimulation,
   LogMessage
 };
@@ -45,6 +47,9 @@ enum class Opcode {
 struct Instruction {
   static std::unique_ptr<Instruction> make_emit(const tb::UpdateCommand& uc,
                                                 const tb::QueryCommand& qc);
+  static std::unique_ptr<Instruction> make_subscribe(
+      const tb::SubscribeCommand& sc);
+  static std::unique_ptr<Instruction> make_notify_ready(bool ready);
   static std::unique_ptr<Instruction> make_wait(std::size_t n);
   static std::unique_ptr<Instruction> make_wait_until_not_busy();
   static std::unique_ptr<Instruction> make_apply_reset();
@@ -55,6 +60,8 @@ struct Instruction {
   std::size_t n;
   tb::UpdateCommand uc;
   tb::QueryCommand qc;
+  tb::SubscribeCommand sc;
+  bool ready;
   std::string msg;
 };
 
@@ -67,6 +74,21 @@ std::unique_ptr<Instruction> Instruction::make_emit(
   return i;
 }
 
+std::unique_ptr<Instruction> Instruction::make_subscribe(
+    const tb::SubscribeCommand& sc) {
+  std::unique_ptr<Instruction> i = std::make_unique<Instruction>();
+  i->op = Opcode::Subscribe;
+  i->sc = sc;
+  return i;
+}
+
+std::unique_ptr<Instruction> Instruction::make_notify_ready(bool ready) {
+  std::unique_ptr<Instruction> i = std::make_unique<Instruction>();
+  i->op = Opcode::NotifyReady;
+  i->ready = ready;
+  return i;
+}
+
 std::unique_ptr<Instruction> Instruction::make_wait(std::size_t n) {
   std::unique_ptr<Instruction> i = std::make_unique<Instruction>();
   i->op = Opcode::WaitCycles;
@@ -111,9 +133,7 @@ class tb::tests::Directed::Impl : public tb::KernelCallbacks {
     parent_->epilogue();
     program_epilogue();
 
-    Sim::kernel->run(this);
-    Sim::kernel->end();
-    return true;
+    return Sim::kernel->run(this);
   }
 
   void push_back(std::unique_ptr<Instruction>&& i) {
@@ -128,6 +148,9 @@ class tb::tests::Directed::Impl : public tb::KernelCallbacks {
   void program_epilogue() { push_back(Instruction::make_end_simulation()); }
 
   bool on_negedge_clk(Vtb* tb) {
+    // A subscription is presented for a single cycle.
+    VDriver::issue(tb, SubscribeCommand{});
+
     // Process further stimulus:
     bool do_next_command;
     do {
@@ -167,6 +190,18 @@ class tb::tests::Directed::Impl : public tb::KernelCallbacks {
           VDriver::issue(tb, i->uc);
           VDriver::issue(tb, i->qc);
         } break;
+        case Opcode::Subscribe: {
+          VDriver::issue(tb, UpdateCommand{});
+          VDriver::issue(tb, QueryCommand{});
+          VDriver::issue(tb, i->sc);
+        } break;
+        case Opcode::NotifyReady: {
+          // Ready is retained until subsequently changed.
+          for (std::size_t b = 0; b < cfg::UPDATE_PORTS_N; ++b) {
+            VDriver::nfy_ready(tb, i->ready, b);
+          }
+          do_next_command = true;
+        } break;
         case Opcode::EndSimulation: {
           V_LOG(parent_->logger(), Info, "Simulation complete!");
           return false;
@@ -215,6 +250,14 @@ void Directed::push_back(const UpdateCommand& uc, const QueryCommand& qc) {
   impl_->push_back(Instruction::make_emit(uc, qc));
 }
 
+void Directed::push_back(const SubscribeCommand& sc) {
+  impl_->push_back(Instruction::make_subscribe(sc));
+}
+
+void Directed::notify_ready(bool ready) {
+  impl_->push_back(Instruction::make_notify_ready(ready));
+}
+
 void Directed::wait_cycles(std::size_t n) {
   impl_->push_back(Instruction::make_wait(n));
 }
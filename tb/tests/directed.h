@@ -75,6 +75,12 @@ class Directed : public Test {
     push_back(uc, qc);
   }
 
+  void push_back(const SubscribeCommand& sc);
+
+  // Drive ready of the coalesced Notify egress (all lanes) for the remainder
+  // of the test (or until changed).
+  void notify_ready(bool ready);
+
   void wait_cycles(std::size_t n = 1);
 
 private:
@@ -0,0 +1,421 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "market.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../log.h"
+#include "../model.h"
+#include "../rnd.h"
+#include "../tb.h"
+#include "../test.h"
+#include "Vobj/Vtb.h"
+#include "cfg.h"
+#include "reset.h"
+
+namespace {
+
+struct Options {
+  static Options construct_from_sim();
+
+  // Number of Update commands to issue.
+  int n = 100000;
+
+  // Exponent of the Zipf distribution from which Contexts are drawn; a
+  // small number of Contexts receive the majority of the traffic.
+  double zipf_s = 1.1;
+
+  // Relative weights of Add, Delete (cancel) and Replace (modify) commands,
+  // and of the comparatively rare Clear.
+  float add_weight = 4.0f;
+  float del_weight = 3.0f;
+  float rep_weight = 3.0f;
+  float clr_weight = 0.001f;
+
+  // Probability that a Query is issued on any given cycle.
+  double query_rate = 0.5;
+
+  // Mean length (in cycles) of burst and quiet periods, and the probability
+  // that an Update is issued on a cycle within a quiet period.
+  double burst_on = 64.0;
+  double burst_off = 256.0;
+  double quiet_rate = 0.05;
+
+  // Probability that the mid-price of a Context moves by one tick on an Add.
+  double drift = 0.05;
+
+  // Parameter of the geometric distribution of Add distance (in ticks) from
+  // the mid-price; larger values cluster entries more tightly.
+  double depth_decay = 0.3;
+
+  // Target occupancy of each Context as a fraction of ENTRIES_N; values
+  // greater than 1.0 force entries to spill from the tail of the table.
+  double overflow = 0.8;
+};
+
+Options Options::construct_from_sim() {
+  Options opts;
+  for (const std::string& arg : tb::Sim::test_args) {
+    const std::string::size_type i = arg.find('=');
+    const std::string key{arg.substr(0, i)};
+    const std::string value{(i == std::string::npos) ? "" : arg.substr(i + 1)};
+    if (key == "n") {
+      opts.n = std::stoi(value);
+    } else if (key == "zipf_s") {
+      opts.zipf_s = std::stod(value);
+    } else if (key == "add_weight") {
+      opts.add_weight = std::stof(value);
+    } else if (key == "del_weight") {
+      opts.del_weight = std::stof(value);
+    } else if (key == "rep_weight") {
+      opts.rep_weight = std::stof(value);
+    } else if (key == "clr_weight") {
+      opts.clr_weight = std::stof(value);
+    } else if (key == "query_rate") {
+      opts.query_rate = std::stod(value);
+    } else if (key == "burst_on") {
+      opts.burst_on = std::stod(value);
+    } else if (key == "burst_off") {
+      opts.burst_off = std::stod(value);
+    } else if (key == "quiet_rate") {
+      opts.quiet_rate = std::stod(value);
+    } else if (key == "drift") {
+      opts.drift = std::stod(value);
+    } else if (key == "depth_decay") {
+      opts.depth_decay = std::stod(value);
+    } else if (key == "overflow") {
+      opts.overflow = std::stod(value);
+    } else {
+      // Unknown argument
+    }
+  }
+  return opts;
+}
+
+// Draw Context IDs from a Zipf distribution over [0, CONTEXT_N); Context 0
+// is the most active.
+class ZipfPicker {
+ public:
+  explicit ZipfPicker(double s) {
+    double sum = 0.0;
+    for (std::size_t k = 0; k < cfg::CONTEXT_N; k++) {
+      sum += 1.0 / std::pow(static_cast<double>(k + 1), s);
+      cdf_.push_back(sum);
+    }
+    for (double& c : cdf_) c /= sum;
+  }
+
+  tb::prod_id_t pick(tb::Random* r) const {
+    const double sel = r->uniform(1.0, 0.0);
+    auto it = std::lower_bound(cdf_.begin(), cdf_.end(), sel);
+    if (it == cdf_.end()) --it;
+    return static_cast<tb::prod_id_t>(std::distance(cdf_.begin(), it));
+  }
+
+ private:
+  std::vector<double> cdf_;
+};
+
+struct Summary {
+  std::size_t cycles = 0;
+  std::size_t add_n = 0;
+  std::size_t del_n = 0;
+  std::size_t rep_n = 0;
+  std::size_t clr_n = 0;
+  std::size_t query_n = 0;
+  // Adds issued to a Context at capacity; one entry is always spilled.
+  std::size_t overflow_n = 0;
+  // Adds at an occupied price, issued instead as Replace.
+  std::size_t merged_n = 0;
+  // Cycles on which an Update was due but spacing rules forced a bubble.
+  std::size_t stall_n = 0;
+  std::size_t burst_n = 0;
+  std::size_t hot_n = 0;
+
+  void report(std::ostream& os) const;
+};
+
+void Summary::report(std::ostream& os) const {
+  const std::size_t update_n = add_n + del_n + rep_n + clr_n;
+  auto pct = [](std::size_t n, std::size_t d) {
+    return (d == 0) ? 0.0 : (100.0 * n / d);
+  };
+  os << "Market workload summary:\n"
+     << "  cycles:        " << cycles << "\n"
+     << "  updates:       " << update_n << " (Add " << add_n << ", Del "
+     << del_n << ", Rep " << rep_n << ", Clr " << clr_n << ")\n"
+     << "  queries:       " << query_n << "\n"
+     << "  bursts:        " << burst_n << "\n"
+     << std::fixed << std::setprecision(2)
+     << "  hot context:   " << pct(hot_n, update_n) << "% of updates\n"
+     << "  overflow:      " << overflow_n << " Add(s) at capacity ("
+     << pct(overflow_n, add_n) << "%)\n"
+     << "  merged:        " << merged_n << " Add(s) at occupied price\n"
+     << "  stalls:        " << stall_n << " cycle(s) deferred by spacing\n";
+}
+
+enum class State { Market, FinalCheck, WindDown };
+
+class Stimulus {
+  // Attempts to redraw a Context blocked by spacing before a bubble is
+  // inserted.
+  static constexpr const int REDRAW_N = 4;
+
+  // Initial mid-price of all Contexts.
+  static constexpr const tb::key_t MID_INIT = 1000000;
+
+ public:
+  explicit Stimulus(const Options& opts)
+      : opts_(opts), zipf_(opts.zipf_s), mid_(cfg::CONTEXT_N, MID_INIT) {
+    bag_.push_back(tb::Cmd::Add, opts_.add_weight);
+    bag_.push_back(tb::Cmd::Del, opts_.del_weight);
+    bag_.push_back(tb::Cmd::Rep, opts_.rep_weight);
+    bag_.push_back(tb::Cmd::Clr, opts_.clr_weight);
+    n_ = opts_.n;
+  }
+
+  bool get(tb::UpdateCommand& uc, tb::QueryCommand& qc) {
+    bool ret = true;
+    switch (st_) {
+      case State::Market: {
+        get_market(uc, qc);
+      } break;
+      case State::FinalCheck: {
+        get_final_check(qc);
+      } break;
+      case State::WindDown: {
+        ret = (--n_ > 0);
+      } break;
+    }
+    spacing_.issue(uc);
+    ++summary_.cycles;
+    return ret;
+  }
+
+  const Summary& summary() const { return summary_; }
+
+ private:
+  void get_market(tb::UpdateCommand& uc, tb::QueryCommand& qc) {
+    if (n_ <= 0) {
+      n_ = cfg::ENTRIES_N * cfg::CONTEXT_N - 1;
+      st_ = State::FinalCheck;
+      return;
+    }
+
+    tb::Random* r{tb::Sim::random.get()};
+    // Two-state (burst/quiet) arrival process.
+    if (r->bernoulli(1.0 / (burst_ ? opts_.burst_on : opts_.burst_off))) {
+      burst_ = !burst_;
+      if (burst_) ++summary_.burst_n;
+    }
+    if (burst_ || r->bernoulli(opts_.quiet_rate)) {
+      if (generate(uc)) --n_;
+    }
+    if (r->bernoulli(opts_.query_rate)) generate(qc);
+  }
+
+  void get_final_check(tb::QueryCommand& qc) {
+    const tb::prod_id_t id = (n_ / cfg::ENTRIES_N);
+    const tb::level_t level = (n_ % cfg::ENTRIES_N);
+    qc = tb::QueryCommand{id, level};
+    if (--n_ < 0) {
+      n_ = 10;
+      st_ = State::WindDown;
+    }
+  }
+
+  bool generate(tb::UpdateCommand& uc) {
+    tb::Random* r{tb::Sim::random.get()};
+    int redraw_n = REDRAW_N;
+    tb::prod_id_t prod_id;
+    do {
+      prod_id = zipf_.pick(r);
+    } while (!spacing_.permits(prod_id) && (--redraw_n > 0));
+    if (!spacing_.permits(prod_id)) {
+      ++summary_.stall_n;
+      return false;
+    }
+
+    const std::size_t size = val_.active_entries_n(prod_id);
+    tb::Cmd cmd = bag_.pick(r);
+    if ((cmd == tb::Cmd::Del) && (size < target_size()) &&
+        !r->bernoulli(size / target_size())) {
+      // Throttle cancellations below the target occupancy such that the
+      // table converges upon it.
+      cmd = tb::Cmd::Add;
+    }
+    if ((cmd != tb::Cmd::Add) && (size == 0)) cmd = tb::Cmd::Add;
+
+    switch (cmd) {
+      case tb::Cmd::Add: {
+        const tb::key_t key = pick_price(prod_id);
+        const tb::volume_t volume = pick_volume();
+        if (val_.has_key(prod_id, key)) {
+          // Price level is already occupied; a new order at the level
+          // modifies its aggregate volume.
+          uc = tb::UpdateCommand{prod_id, tb::Cmd::Rep, key, volume};
+          ++summary_.merged_n;
+          ++summary_.rep_n;
+        } else {
+          uc = tb::UpdateCommand{prod_id, tb::Cmd::Add, key, volume};
+          if (size == cfg::ENTRIES_N) ++summary_.overflow_n;
+          ++summary_.add_n;
+        }
+      } break;
+      case tb::Cmd::Del: {
+        const auto [success, key] = val_.pick_active_key(prod_id);
+        uc = tb::UpdateCommand{prod_id, tb::Cmd::Del, key, 0};
+        ++summary_.del_n;
+      } break;
+      case tb::Cmd::Rep: {
+        const auto [success, key] = val_.pick_active_key(prod_id);
+        uc = tb::UpdateCommand{prod_id, tb::Cmd::Rep, key, pick_volume()};
+        ++summary_.rep_n;
+      } break;
+      case tb::Cmd::Clr: {
+        uc = tb::UpdateCommand{prod_id, tb::Cmd::Clr, 0, 0};
+        ++summary_.clr_n;
+      } break;
+      default: {
+        return false;
+      }
+    }
+    if (prod_id == 0) ++summary_.hot_n;
+    return true;
+  }
+
+  void generate(tb::QueryCommand& qc) {
+    tb::Random* r{tb::Sim::random.get()};
+    const tb::prod_id_t prod_id = zipf_.pick(r);
+    // Queries concentrate about the head of the table.
+    const tb::level_t level = static_cast<tb::level_t>(std::min<std::size_t>(
+        r->geometric<std::size_t>(opts_.depth_decay), cfg::ENTRIES_N - 1));
+    qc = tb::QueryCommand{prod_id, level};
+    ++summary_.query_n;
+  }
+
+  tb::key_t pick_price(tb::prod_id_t prod_id) {
+    tb::Random* r{tb::Sim::random.get()};
+    tb::key_t& mid{mid_[prod_id]};
+    if (r->bernoulli(opts_.drift)) mid += r->bernoulli(0.5) ? 1 : -1;
+
+    // Offset from mid-price on the passive side of the book: below the mid
+    // for a Bid table, above it for an Ask table.
+    const tb::key_t offset = 1 + r->geometric<tb::key_t>(opts_.depth_decay);
+    return cfg::is_bid_table ? (mid - offset) : (mid + offset);
+  }
+
+  tb::volume_t pick_volume() {
+    return tb::Sim::random->uniform<tb::volume_t>(1000, 1);
+  }
+
+  double target_size() const {
+    return std::max(1.0, opts_.overflow * cfg::ENTRIES_N);
+  }
+
+  Options opts_;
+  ZipfPicker zipf_;
+  std::vector<tb::key_t> mid_;
+  tb::Bag<tb::Cmd> bag_;
+  tb::UpdateSpacing spacing_;
+  tb::ModelValidation val_;
+  Summary summary_;
+  State st_ = State::Market;
+  bool burst_ = true;
+  int n_;
+};
+
+struct MarketCB : public tb::KernelCallbacks {
+  MarketCB(tb::Test* parent, Stimulus* s)
+      : parent_(parent), s_(s), rstt_(parent->logger(), true) {}
+
+  bool on_negedge_clk(Vtb* tb) override {
+    // Issue reset process.
+    if (!rstt_.is_done()) {
+      rstt_.check_reset(tb);
+      return !rstt_.is_failed();
+    }
+
+    tb::UpdateCommand uc{};
+    tb::QueryCommand qc{};
+    if (!s_->get(uc, qc)) {
+      // No further stimulus.
+      return false;
+    }
+
+    tb::VDriver::issue(tb, uc);
+    tb::VDriver::issue(tb, qc);
+    return true;
+  }
+
+ private:
+  tb::Test* parent_;
+  Stimulus* s_;
+  tb::ResetTracker rstt_;
+};
+
+struct Market : public tb::Test {
+  CREATE_TEST_BUILDER_WITH_ARGS(Market, args);
+
+  bool run() override {
+    Stimulus s{Options::construct_from_sim()};
+    MarketCB cb{this, std::addressof(s)};
+    const bool ret = tb::Sim::kernel->run(std::addressof(cb));
+    s.summary().report(std::cout);
+    return ret;
+  }
+
+  static tb::JsonDict args() {
+    tb::JsonArray args;
+    for (const char* name :
+         {"n", "zipf_s", "add_weight", "del_weight", "rep_weight",
+          "clr_weight", "query_rate", "burst_on", "burst_off", "quiet_rate",
+          "drift", "depth_decay", "overflow"}) {
+      tb::JsonDict arg;
+      arg.add("name", name);
+      args.add(arg);
+    }
+
+    tb::JsonDict d;
+    d.add("arguments", args);
+    return d;
+  }
+};
+
+}  // namespace
+
+namespace tb::tests::market {
+
+void init(tb::TestRegistry& r) { Market::Builder::init(r); }
+
+}  // namespace tb::tests::market
@@ -0,0 +1,495 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "minimise.h"
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../log.h"
+#include "../model.h"
+#include "../tb.h"
+#include "../test.h"
+#include "../trace.h"
+#include "cfg.h"
+#include "replay.h"
+
+namespace {
+
+struct Options {
+  static Options construct_from_sim();
+
+  // Failing trace to be minimised.
+  std::string fn;
+
+  // Minimised trace; '<fn>.min' by default.
+  std::string out;
+
+  // Number of concurrent simulations.
+  int jobs = std::max(1u, std::thread::hardware_concurrency());
+
+  // Idle cycles following the final frame of each trial.
+  int wind_down_n = 10;
+};
+
+Options Options::construct_from_sim() {
+  Options opts;
+  for (const std::string& arg : tb::Sim::test_args) {
+    const std::string::size_type i = arg.find('=');
+    const std::string key{arg.substr(0, i)};
+    const std::string value{(i == std::string::npos) ? "" : arg.substr(i + 1)};
+    if (key == "file") {
+      opts.fn = value;
+    } else if (key == "out") {
+      opts.out = value;
+    } else if (key == "jobs") {
+      opts.jobs = std::max(1, std::stoi(value));
+    } else if (key == "wind_down_n") {
+      opts.wind_down_n = std::stoi(value);
+    } else {
+      // Unknown argument
+    }
+  }
+  if (opts.out.empty()) opts.out = opts.fn + ".min";
+  return opts;
+}
+
+struct Cycle {
+  tb::UpdateCommand uc;
+  tb::QueryCommand qc;
+};
+
+using Stream = std::vector<Cycle>;
+
+std::size_t command_n(const Stream& s) {
+  std::size_t n = 0;
+  for (const Cycle& c : s) {
+    if (c.uc.vld()) ++n;
+    if (c.qc.vld()) ++n;
+  }
+  return n;
+}
+
+// Reductions which remove idle cycles may bring Update commands to the same
+// Context closer together than the UUT permits; such candidates are
+// discarded without simulation.
+bool is_legal(const Stream& s) {
+  tb::UpdateSpacing spacing;
+  for (const Cycle& c : s) {
+    if (c.uc.vld() && !spacing.permits(c.uc.prod_id())) return false;
+    spacing.issue(c.uc);
+  }
+  return true;
+}
+
+// Re-simulate candidate streams, each within a forked child process such that
+// every trial commences from pristine simulator state. The child reports the
+// class of the first mismatch encountered back to the parent over a pipe.
+class Evaluator {
+ public:
+  explicit Evaluator(tb::Test* parent, const Options& opts)
+      : parent_(parent), opts_(opts) {}
+
+  // Mismatch class of a single stream ("" on pass).
+  std::string evaluate(const Stream& s) {
+    std::vector<Child> cs;
+    cs.push_back(spawn(s));
+    return join(cs.back());
+  }
+
+  // Evaluate candidates [0, n), constructed on demand, in batches of 'jobs'.
+  // Returns the lowest-indexed candidate reproducing the 'target' class.
+  std::optional<std::size_t> first_interesting(
+      std::size_t n, const std::function<Stream(std::size_t)>& make,
+      const std::string& target) {
+    for (std::size_t base = 0; base < n; base += opts_.jobs) {
+      const std::size_t end = std::min(n, base + opts_.jobs);
+      std::vector<Child> cs;
+      for (std::size_t i = base; i < end; i++) cs.push_back(spawn(make(i)));
+
+      std::optional<std::size_t> found;
+      for (std::size_t i = base; i < end; i++) {
+        // All children are joined, irrespective of outcome.
+        if ((join(cs[i - base]) == target) && !found) found = i;
+      }
+      if (found) return found;
+    }
+    return std::nullopt;
+  }
+
+  std::size_t trials() const { return trials_; }
+
+  std::size_t jobs() const { return opts_.jobs; }
+
+ private:
+  struct Child {
+    pid_t pid;
+    int fd;
+  };
+
+  Child spawn(const Stream& s) {
+    if (!is_legal(s)) return Child{-1, -1};
+
+    ++trials_;
+    int fds[2];
+    if (::pipe(fds) != 0) throw std::runtime_error("Unable to create pipe");
+
+    std::cout.flush();
+    const pid_t pid = ::fork();
+    if (pid < 0) throw std::runtime_error("Unable to fork");
+    if (pid == 0) {
+      ::close(fds[0]);
+      simulate(s, fds[1]);
+      ::_exit(0);
+    }
+    ::close(fds[1]);
+    return Child{pid, fds[0]};
+  }
+
+  std::string join(const Child& c) {
+    std::string fc;
+    if (c.pid < 0) return fc;
+
+    char buf[256];
+    ssize_t n;
+    while ((n = ::read(c.fd, buf, sizeof(buf))) > 0) fc.append(buf, n);
+    ::close(c.fd);
+    int status;
+    ::waitpid(c.pid, &status, 0);
+    return fc;
+  }
+
+  // Executed within the child process.
+  void simulate(const Stream& s, int fd) {
+    const int null_fd = ::open("/dev/null", O_WRONLY);
+    ::dup2(null_fd, STDOUT_FILENO);
+    ::dup2(null_fd, STDERR_FILENO);
+
+    std::vector<tb::trace::Frame> fs;
+    fs.reserve(s.size());
+    for (const Cycle& c : s) fs.push_back(tb::trace::encode(c.uc, c.qc));
+
+    tb::Sim::errors = 0;
+    tb::Sim::warnings = 0;
+    tb::Sim::fail_class.reset();
+    // Terminate upon the first mismatch.
+    tb::Sim::error_max = 1;
+    try {
+      tb::tests::replay::run(parent_, fs.data(), fs.data() + fs.size(),
+                             opts_.wind_down_n);
+    } catch (...) {
+    }
+    const std::string fc{tb::Sim::fail_class.value_or("")};
+    (void)::write(fd, fc.data(), fc.size());
+    ::close(fd);
+  }
+
+  tb::Test* parent_;
+  Options opts_;
+  std::size_t trials_ = 0;
+};
+
+// Reduce a failing stream to a (locally) minimal stream reproducing the same
+// mismatch class:
+//
+//  1. Truncate after the failing cycle.
+//  2. Remove all commands to each Context in turn.
+//  3. Delta-debug the remaining commands (commands are nullified in-place,
+//     retaining the timing of the remainder).
+//  4. Simplify keys and volumes (rank-compressed, preserving order).
+//  5. Delta-debug the idle cycles which remain.
+//  6. Truncate once more.
+//
+class Minimiser {
+  using Build = std::function<Stream(const std::vector<std::size_t>&)>;
+
+ public:
+  explicit Minimiser(Evaluator* ev, const std::string& target)
+      : ev_(ev), target_(target) {}
+
+  Stream run(Stream s) {
+    s = truncate(s);
+    s = drop_contexts(s);
+    s = drop_commands(s);
+    s = simplify_keys(s);
+    s = simplify_volumes(s);
+    s = drop_idle(s);
+    s = truncate(s);
+    return s;
+  }
+
+ private:
+  bool accept(const Stream& s) { return ev_->evaluate(s) == target_; }
+
+  Stream truncate(const Stream& s) {
+    // Search for the shortest failing prefix; lengths are evaluated
+    // concurrently at evenly spaced points across the current interval.
+    std::size_t lo = 0, hi = s.size();
+    while ((hi - lo) > 1) {
+      std::vector<std::size_t> ps;
+      const std::size_t k = std::min<std::size_t>(ev_->jobs(), hi - lo - 1);
+      for (std::size_t i = 1; i <= k; i++) {
+        ps.push_back(lo + ((hi - lo) * i) / (k + 1));
+      }
+      auto make = [&](std::size_t i) {
+        return Stream(s.begin(), s.begin() + ps[i]);
+      };
+      if (auto i = ev_->first_interesting(ps.size(), make, target_)) {
+        hi = ps[*i];
+        lo = (*i == 0) ? lo : ps[*i - 1];
+      } else {
+        lo = ps.back();
+      }
+    }
+    return Stream(s.begin(), s.begin() + hi);
+  }
+
+  Stream drop_contexts(Stream s) {
+    for (;;) {
+      std::set<tb::prod_id_t> ids;
+      for (const Cycle& c : s) {
+        if (c.uc.vld()) ids.insert(c.uc.prod_id());
+        if (c.qc.vld()) ids.insert(c.qc.prod_id());
+      }
+      if (ids.size() <= 1) break;
+
+      const std::vector<tb::prod_id_t> vs(ids.begin(), ids.end());
+      auto make = [&](std::size_t i) {
+        Stream t{s};
+        for (Cycle& c : t) {
+          if (c.uc.vld() && (c.uc.prod_id() == vs[i])) {
+            c.uc = tb::UpdateCommand{};
+          }
+          if (c.qc.vld() && (c.qc.prod_id() == vs[i])) {
+            c.qc = tb::QueryCommand{};
+          }
+        }
+        return t;
+      };
+      const std::optional<std::size_t> i =
+          ev_->first_interesting(vs.size(), make, target_);
+      if (!i) break;
+      s = make(*i);
+    }
+    return s;
+  }
+
+  Stream drop_commands(const Stream& s) {
+    // Items enumerate command slots: (cycle << 1) | is_query.
+    std::vector<std::size_t> items;
+    for (std::size_t i = 0; i < s.size(); i++) {
+      if (s[i].uc.vld()) items.push_back(i << 1);
+      if (s[i].qc.vld()) items.push_back((i << 1) | 1);
+    }
+    Build build = [&](const std::vector<std::size_t>& kept) {
+      Stream t(s.size());
+      for (std::size_t item : kept) {
+        const std::size_t i = (item >> 1);
+        if (item & 1) {
+          t[i].qc = s[i].qc;
+        } else {
+          t[i].uc = s[i].uc;
+        }
+      }
+      return t;
+    };
+    return build(ddmin(items, build));
+  }
+
+  Stream drop_idle(const Stream& s) {
+    // Items enumerate idle cycles; non-idle cycles are always retained.
+    std::vector<std::size_t> items;
+    for (std::size_t i = 0; i < s.size(); i++) {
+      if (!s[i].uc.vld() && !s[i].qc.vld()) items.push_back(i);
+    }
+    Build build = [&](const std::vector<std::size_t>& kept) {
+      std::vector<bool> keep(s.size(), true);
+      for (std::size_t i : items) keep[i] = false;
+      for (std::size_t i : kept) keep[i] = true;
+      Stream t;
+      for (std::size_t i = 0; i < s.size(); i++) {
+        if (keep[i]) t.push_back(s[i]);
+      }
+      return t;
+    };
+    return build(ddmin(items, build));
+  }
+
+  Stream simplify_keys(const Stream& s) {
+    std::set<tb::key_t> keys;
+    for (const Cycle& c : s) {
+      if (c.uc.vld()) keys.insert(c.uc.key());
+    }
+    const std::vector<tb::key_t> ks(keys.begin(), keys.end());
+    Stream t{s};
+    for (Cycle& c : t) {
+      if (!c.uc.vld()) continue;
+      const tb::key_t key = std::distance(
+          ks.begin(), std::lower_bound(ks.begin(), ks.end(), c.uc.key()));
+      c.uc = tb::UpdateCommand{c.uc.prod_id(), c.uc.cmd(), key + 1,
+                               c.uc.volume()};
+    }
+    return accept(t) ? t : s;
+  }
+
+  Stream simplify_volumes(const Stream& s) {
+    std::set<tb::volume_t> volumes;
+    for (const Cycle& c : s) {
+      if (c.uc.vld()) volumes.insert(c.uc.volume());
+    }
+    const std::vector<tb::volume_t> vs(volumes.begin(), volumes.end());
+    Stream t{s};
+    for (Cycle& c : t) {
+      if (!c.uc.vld()) continue;
+      const tb::volume_t volume = std::distance(
+          vs.begin(), std::lower_bound(vs.begin(), vs.end(), c.uc.volume()));
+      c.uc = tb::UpdateCommand{c.uc.prod_id(), c.uc.cmd(), c.uc.key(),
+                               volume + 1};
+    }
+    return accept(t) ? t : s;
+  }
+
+  // Delta debugging (Zeller's ddmin): retain a 1-minimal subset of 'items'
+  // for which build(items) reproduces the target mismatch.
+  std::vector<std::size_t> ddmin(std::vector<std::size_t> items,
+                                 const Build& build) {
+    std::size_t n = 2;
+    while (items.size() >= 2) {
+      n = std::min(n, items.size());
+      std::vector<std::vector<std::size_t>> chunks(n);
+      for (std::size_t i = 0; i < items.size(); i++) {
+        chunks[(i * n) / items.size()].push_back(items[i]);
+      }
+      auto complement = [&](std::size_t j) {
+        std::vector<std::size_t> c;
+        for (std::size_t i = 0; i < n; i++) {
+          if (i != j) c.insert(c.end(), chunks[i].begin(), chunks[i].end());
+        }
+        return c;
+      };
+      // Subsets are considered before complements; for n == 2 the two are
+      // equivalent.
+      auto make = [&](std::size_t i) {
+        return build((i < n) ? chunks[i] : complement(i - n));
+      };
+      const std::size_t cand_n = (n == 2) ? 2 : (2 * n);
+      if (auto i = ev_->first_interesting(cand_n, make, target_)) {
+        if (*i < n) {
+          items = chunks[*i];
+          n = 2;
+        } else {
+          items = complement(*i - n);
+          n = std::max<std::size_t>(n - 1, 2);
+        }
+      } else if (n == items.size()) {
+        break;
+      } else {
+        n = std::min(2 * n, items.size());
+      }
+    }
+    return items;
+  }
+
+  Evaluator* ev_;
+  std::string target_;
+};
+
+struct Minimise : public tb::Test {
+  CREATE_TEST_BUILDER_WITH_ARGS(Minimise, args);
+
+  bool run() override {
+    const Options opts{Options::construct_from_sim()};
+    if (opts.fn.empty()) {
+      V_LOG(logger(), Error, "No trace file provided (-a file=<trace>).");
+      return true;
+    }
+
+    Stream s;
+    {
+      const tb::trace::Reader r{opts.fn};
+      s.reserve(r.size());
+      for (const tb::trace::Frame& f : r) {
+        s.push_back(Cycle{tb::trace::decode(f.uc), tb::trace::decode(f.qc)});
+      }
+    }
+
+    Evaluator ev{this, opts};
+    const std::string target{ev.evaluate(s)};
+    if (target.empty()) {
+      V_LOG(logger(), Error, "Trace does not fail; nothing to minimise.");
+      return true;
+    }
+    std::cout << "Minimising: " << opts.fn << " (" << target << ")\n"
+              << "  original:  " << s.size() << " cycle(s), " << command_n(s)
+              << " command(s)\n";
+
+    Minimiser m{std::addressof(ev), target};
+    const Stream t{m.run(s)};
+
+    tb::trace::Writer w{opts.out};
+    for (const Cycle& c : t) w.write(c.uc, c.qc);
+    w.close();
+
+    std::cout << "  minimised: " << t.size() << " cycle(s), " << command_n(t)
+              << " command(s)\n"
+              << "  trials:    " << ev.trials() << "\n"
+              << "  written:   " << opts.out << "\n";
+    return false;
+  }
+
+  static tb::JsonDict args() {
+    tb::JsonArray args;
+    for (const char* name : {"file", "out", "jobs", "wind_down_n"}) {
+      tb::JsonDict arg;
+      arg.add("name", name);
+      args.add(arg);
+    }
+
+    tb::JsonDict d;
+    d.add("arguments", args);
+    return d;
+  }
+};
+
+}  // namespace
+
+namespace tb::tests::minimise {
+
+void init(tb::TestRegistry& r) { Minimise::Builder::init(r); }
+
+}  // namespace tb::tests::minimise
@@ -0,0 +1,290 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "orderflow.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "../log.h"
+#include "../model.h"
+#include "../orderflow.h"
+#include "../rnd.h"
+#include "../tb.h"
+#include "../test.h"
+#include "Vobj/Vtb.h"
+#include "cfg.h"
+#include "reset.h"
+
+namespace {
+
+struct Options {
+  static Options construct_from_sim();
+
+  // Order-flow file to be ingested.
+  std::string fn;
+
+  // File format; inferred from the file extension when not specified.
+  std::optional<tb::orderflow::Format> format;
+
+  // Probability that a Query is issued on any given cycle.
+  double query_rate = 0.25;
+
+  // Depth of the buffer from which Update commands are scheduled.
+  std::size_t window_n = 16;
+
+  // Idle cycles following the final message, such that in-flight responses
+  // are retired and checked.
+  int wind_down_n = 10;
+
+  // Decode the file without simulation; reports ingestion throughput.
+  bool parse_only = false;
+};
+
+Options Options::construct_from_sim() {
+  Options opts;
+  for (const std::string& arg : tb::Sim::test_args) {
+    const std::string::size_type i = arg.find('=');
+    const std::string key{arg.substr(0, i)};
+    const std::string value{(i == std::string::npos) ? "" : arg.substr(i + 1)};
+    if (key == "file") {
+      opts.fn = value;
+    } else if (key == "format") {
+      opts.format = (value == "csv") ? tb::orderflow::Format::Csv
+                                     : tb::orderflow::Format::Binary;
+    } else if (key == "query_rate") {
+      opts.query_rate = std::stod(value);
+    } else if (key == "window_n") {
+      opts.window_n = std::max(1, std::stoi(value));
+    } else if (key == "wind_down_n") {
+      opts.wind_down_n = std::stoi(value);
+    } else if (key == "parse_only") {
+      opts.parse_only = (std::stoi(value) != 0);
+    } else {
+      // Unknown argument
+    }
+  }
+  return opts;
+}
+
+struct Summary {
+  std::size_t message_n = 0;
+  std::size_t add_n = 0;
+  std::size_t cancel_n = 0;
+  std::size_t modify_n = 0;
+  std::size_t clear_n = 0;
+  // Messages for instruments beyond the available Contexts.
+  std::size_t unmapped_n = 0;
+  std::size_t instrument_n = 0;
+  std::size_t query_n = 0;
+  // Cycles on which commands were pending but none could be issued.
+  std::size_t stall_n = 0;
+
+  void count(const tb::orderflow::Message& m);
+
+  void report(std::ostream& os) const;
+};
+
+void Summary::count(const tb::orderflow::Message& m) {
+  ++message_n;
+  switch (m.type) {
+    case tb::orderflow::Type::Add:    ++add_n; break;
+    case tb::orderflow::Type::Cancel: ++cancel_n; break;
+    case tb::orderflow::Type::Modify: ++modify_n; break;
+    case tb::orderflow::Type::Clear:  ++clear_n; break;
+  }
+}
+
+void Summary::report(std::ostream& os) const {
+  os << "Order-flow summary:\n"
+     << "  messages:      " << message_n << " (Add " << add_n << ", Cancel "
+     << cancel_n << ", Modify " << modify_n << ", Clear " << clear_n << ")\n"
+     << "  instruments:   " << instrument_n << " mapped, " << unmapped_n
+     << " message(s) unmapped\n"
+     << "  queries:       " << query_n << "\n"
+     << "  stalls:        " << stall_n << " cycle(s) deferred by spacing\n";
+}
+
+class Stimulus {
+ public:
+  explicit Stimulus(const Options& opts)
+      : opts_(opts),
+        r_(tb::orderflow::open(
+            opts.fn, opts.format.value_or(tb::orderflow::infer_format(opts.fn)))),
+        sched_(opts.window_n),
+        wind_down_n_(opts.wind_down_n) {}
+
+  bool get(tb::UpdateCommand& uc, tb::QueryCommand& qc) {
+    refill();
+    if (!sched_.empty()) {
+      uc = sched_.pop();
+      if (!uc.vld()) ++summary_.stall_n;
+    } else if (exhausted_) {
+      return (--wind_down_n_ > 0);
+    }
+
+    if ((ids_.size() != 0) && tb::Sim::random->bernoulli(opts_.query_rate)) {
+      const tb::prod_id_t prod_id = static_cast<tb::prod_id_t>(
+          tb::Sim::random->uniform<std::size_t>(ids_.size() - 1, 0));
+      const tb::level_t level =
+          tb::Sim::random->uniform<int>(cfg::ENTRIES_N - 1, 0);
+      qc = tb::QueryCommand{prod_id, level};
+      ++summary_.query_n;
+    }
+    return true;
+  }
+
+  const Summary& summary() {
+    summary_.instrument_n = ids_.size();
+    return summary_;
+  }
+
+ private:
+  void refill() {
+    tb::orderflow::Message m;
+    while (!exhausted_ && !sched_.full()) {
+      if (!r_->next(m)) {
+        exhausted_ = true;
+        break;
+      }
+      summary_.count(m);
+      if (const std::optional<tb::prod_id_t> prod_id = ids_.lookup(m.instrument)) {
+        sched_.push_back(tb::orderflow::to_command(m, *prod_id));
+      } else {
+        ++summary_.unmapped_n;
+      }
+    }
+  }
+
+  Options opts_;
+  std::unique_ptr<tb::orderflow::Reader> r_;
+  tb::orderflow::InstrumentMap ids_;
+  tb::orderflow::Scheduler sched_;
+  Summary summary_;
+  bool exhausted_ = false;
+  int wind_down_n_;
+};
+
+struct OrderFlowCB : public tb::KernelCallbacks {
+  OrderFlowCB(tb::Test* parent, Stimulus* s)
+      : parent_(parent), s_(s), rstt_(parent->logger(), true) {}
+
+  bool on_negedge_clk(Vtb* tb) override {
+    // Issue reset process.
+    if (!rstt_.is_done()) {
+      rstt_.check_reset(tb);
+      return !rstt_.is_failed();
+    }
+
+    tb::UpdateCommand uc{};
+    tb::QueryCommand qc{};
+    if (!s_->get(uc, qc)) {
+      // No further stimulus.
+      return false;
+    }
+
+    tb::VDriver::issue(tb, uc);
+    tb::VDriver::issue(tb, qc);
+    return true;
+  }
+
+ private:
+  tb::Test* parent_;
+  Stimulus* s_;
+  tb::ResetTracker rstt_;
+};
+
+struct OrderFlow : public tb::Test {
+  CREATE_TEST_BUILDER_WITH_ARGS(OrderFlow, args);
+
+  bool run() override {
+    const Options opts{Options::construct_from_sim()};
+    if (opts.fn.empty()) {
+      V_LOG(logger(), Error, "No order-flow file provided (-a file=<fn>).");
+      return true;
+    }
+    if (opts.parse_only) {
+      parse(opts);
+      return true;
+    }
+    V_LOG_IF(logger(), true, Info, "Ingesting order-flow: ", opts.fn);
+    Stimulus s{opts};
+    OrderFlowCB cb{this, std::addressof(s)};
+    const bool ret = tb::Sim::kernel->run(std::addressof(cb));
+    s.summary().report(std::cout);
+    return ret;
+  }
+
+  static void parse(const Options& opts) {
+    using clock = std::chrono::steady_clock;
+
+    const clock::time_point start = clock::now();
+    std::unique_ptr<tb::orderflow::Reader> r{tb::orderflow::open(
+        opts.fn, opts.format.value_or(tb::orderflow::infer_format(opts.fn)))};
+    tb::orderflow::InstrumentMap ids;
+    Summary summary;
+    tb::orderflow::Message m;
+    while (r->next(m)) {
+      summary.count(m);
+      if (!ids.lookup(m.instrument)) ++summary.unmapped_n;
+    }
+    const std::chrono::duration<double> elapsed = clock::now() - start;
+    summary.instrument_n = ids.size();
+    summary.report(std::cout);
+    std::cout << std::fixed << std::setprecision(2)
+              << "  throughput:    "
+              << (summary.message_n / elapsed.count() / 1.0e6)
+              << "M message(s)/s\n";
+  }
+
+  static tb::JsonDict args() {
+    tb::JsonArray args;
+    for (const char* name : {"file", "format", "query_rate", "window_n",
+                             "wind_down_n", "parse_only"}) {
+      tb::JsonDict arg;
+      arg.add("name", name);
+      args.add(arg);
+    }
+
+    tb::JsonDict d;
+    d.add("arguments", args);
+    return d;
+  }
+};
+
+}  // namespace
+
+namespace tb::tests::orderflow {
+
+void init(tb::TestRegistry& r) { OrderFlow::Builder::init(r); }
+
+}  // namespace tb::tests::orderflow
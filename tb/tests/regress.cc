@@ -25,6 +25,7 @@
 // POSSIBILITY OF SUCH DAMAGE.
 //========================================================================== //
 
+#include <array>
 #include <string_view>
 #include <vector>
 
@@ -72,6 +73,9 @@ struct Options {
   float rep_weight = 1.0f;
   float inv_weight = 1.0f;
 
+  // Probability that the coalesced Notify egress is stalled on each cycle.
+  float notify_stall = 0.0f;
+
   int context_n = cfg::CONTEXT_N;
 
   int n = 100000;
@@ -96,6 +100,8 @@ Options Options::construct_from_sim() {
         opts.rep_weight = std::stof(value, &pos); 
       } else if (key == "inv_weight") {
         opts.inv_weight = std::stof(value, &pos); 
+      } else if (key == "notify_stall") {
+        opts.notify_stall = std::stof(value, &pos);
       } else {
         // Unknown argument
       }
@@ -128,14 +134,17 @@ class Stimulus {
     state(State::Random);
   }
 
-  bool get(tb::UpdateCommand& uc, tb::QueryCommand& qc) {
+  // One Query command per Query port.
+  using QueryCommands = std::array<tb::QueryCommand, cfg::QUERY_PORTS_N>;
+
+  bool get(tb::UpdateCommand& uc, QueryCommands& qcs) {
     bool ret = false;
     switch (st_) {
       case State::Random: {
-        ret = get_random(uc, qc);
+        ret = get_random(uc, qcs);
       } break;
       case State::FinalCheck: {
-        ret = get_final_check(uc, qc);
+        ret = get_final_check(uc, qcs);
       } break;
       case State::WindDown: {
         ret = (--opts_.n > 0);
@@ -145,11 +154,13 @@ class Stimulus {
   }
 
  private:
-  bool get_random(tb::UpdateCommand& uc, tb::QueryCommand& qc) {
+  bool get_random(tb::UpdateCommand& uc, QueryCommands& qcs) {
     if (opts_.n > 0) {
       int issue_count = handle(uc);
-      if (opts_.n > 0) {
-        issue_count += handle(qc);
+      for (tb::QueryCommand& qc : qcs) {
+        if (opts_.n > issue_count) {
+          issue_count += handle(qc);
+        }
       }
       opts_.n -= issue_count;
     } else {
@@ -159,13 +170,17 @@ class Stimulus {
     return true;
   }
 
-  bool get_final_check(tb::UpdateCommand& uc, tb::QueryCommand& qc) {
-    const tb::prod_id_t id = (opts_.n / cfg::ENTRIES_N);
-    const tb::level_t level = (opts_.n % cfg::ENTRIES_N);
-    qc = tb::QueryCommand{id, level};
-    if (--opts_.n < 0) {
-      opts_.n = 10;
-      state(State::WindDown);
+  bool get_final_check(tb::UpdateCommand& uc, QueryCommands& qcs) {
+    // Sweep all Contexts and levels, distributed across the Query ports.
+    for (tb::QueryCommand& qc : qcs) {
+      const tb::prod_id_t id = (opts_.n / cfg::ENTRIES_N);
+      const tb::level_t level = (opts_.n % cfg::ENTRIES_N);
+      qc = tb::QueryCommand{id, level};
+      if (--opts_.n < 0) {
+        opts_.n = 10;
+        state(State::WindDown);
+        break;
+      }
     }
     return true;
   }
@@ -217,8 +232,20 @@ class Stimulus {
 
   void generate(tb::QueryCommand& qc) {
     const tb::prod_id_t prod_id = tb::Sim::random->uniform(opts_.context_n - 1, 0);
+    if (tb::Sim::random->bernoulli(0.25)) {
+      // Key Lookups target an active key where present (a hit), otherwise a
+      // random key (almost certainly a miss).
+      auto [success, key] = val_.pick_active_key(prod_id);
+      if (!success || tb::Sim::random->bernoulli(0.25)) {
+        key = tb::Sim::random->uniform<tb::key_t>();
+      }
+      qc = tb::QueryCommand::lookup(prod_id, key);
+      return;
+    }
     const tb::level_t level = tb::Sim::random->uniform(cfg::ENTRIES_N - 1);
-    qc = tb::QueryCommand{prod_id, level};
+    // Cumulative Queries validate the incrementally maintained prefix sums.
+    const bool cum = tb::Sim::random->bernoulli(0.5);
+    qc = tb::QueryCommand{prod_id, level, false, cum};
   }
 
   void state(State st) { st_ = st; }
@@ -231,8 +258,11 @@ class Stimulus {
 };
 
 struct RegressCB : public tb::KernelCallbacks {
-  RegressCB(tb::Test* parent, Stimulus* s)
-      : parent_(parent), s_(s), rstt_(parent->logger(), true) {}
+  RegressCB(tb::Test* parent, Stimulus* s, float notify_stall)
+      : parent_(parent),
+        s_(s),
+        rstt_(parent->logger(), true),
+        notify_stall_(notify_stall) {}
 
   bool on_negedge_clk(Vtb* tb) {
     // Issue reset process.
@@ -242,15 +272,25 @@ struct RegressCB : public tb::KernelCallbacks {
     }
 
     tb::UpdateCommand uc{};
-    tb::QueryCommand qc{};
-    if (!s_->get(uc, qc)) {
+    Stimulus::QueryCommands qcs;
+    if (!s_->get(uc, qcs)) {
       // No further stimulus.
       return false;
     }
 
     // Issue commands to UUT
     tb::VDriver::issue(tb, uc);
-    tb::VDriver::issue(tb, qc);
+    for (std::size_t p = 0; p < cfg::QUERY_PORTS_N; p++) {
+      tb::VDriver::issue(tb, qcs[p], p);
+    }
+
+    // Apply backpressure to the coalesced Notify egress.
+    if (notify_stall_ > 0.0f) {
+      for (std::size_t b = 0; b < cfg::UPDATE_PORTS_N; b++) {
+        tb::VDriver::nfy_ready(tb, !tb::Sim::random->bernoulli(notify_stall_),
+                               b);
+      }
+    }
 
     return true;
   }
@@ -259,14 +299,16 @@ struct RegressCB : public tb::KernelCallbacks {
   Stimulus* s_;
   tb::Test* parent_;
   tb::ResetTracker rstt_;
+  float notify_stall_;
 };
 
 struct Regress : public tb::Test {
   CREATE_TEST_BUILDER_WITH_ARGS(Regress, args);
 
   bool run() override {
-    Stimulus s{Options::construct_from_sim()};
-    RegressCB cb{this, std::addressof(s)};
+    const Options opts{Options::construct_from_sim()};
+    Stimulus s{opts};
+    RegressCB cb{this, std::addressof(s), opts.notify_stall};
     return tb::Sim::kernel->run(std::addressof(cb));
   }
 
@@ -297,6 +339,10 @@ struct Regress : public tb::Test {
     inv.add("name", "inv_weight");
     args.add(inv);
 
+    tb::JsonDict notify_stall;
+    notify_stall.add("name", "notify_stall");
+    args.add(notify_stall);
+
     tb::JsonDict d;
     d.add("arguments", args);
     return d;
@@ -0,0 +1,150 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "replay.h"
+
+#include <string>
+
+#include "../log.h"
+#include "../model.h"
+#include "../tb.h"
+#include "../test.h"
+#include "../trace.h"
+#include "reset.h"
+
+namespace {
+
+struct Options {
+  static Options construct_from_sim();
+
+  // Trace file to be replayed.
+  std::string fn;
+
+  // Idle cycles following the final frame, such that in-flight responses are
+  // retired and checked.
+  int wind_down_n = 10;
+};
+
+Options Options::construct_from_sim() {
+  Options opts;
+  for (const std::string& arg : tb::Sim::test_args) {
+    const std::string::size_type i = arg.find('=');
+    const std::string key{arg.substr(0, i)};
+    const std::string value{(i == std::string::npos) ? "" : arg.substr(i + 1)};
+    if (key == "file") {
+      opts.fn = value;
+    } else if (key == "wind_down_n") {
+      opts.wind_down_n = std::stoi(value);
+    } else {
+      // Unknown argument
+    }
+  }
+  return opts;
+}
+
+struct ReplayCB : public tb::KernelCallbacks {
+  ReplayCB(tb::Test* parent, const tb::trace::Frame* begin,
+           const tb::trace::Frame* end, int wind_down_n)
+      : parent_(parent),
+        rstt_(parent->logger(), true),
+        it_(begin),
+        end_(end),
+        wind_down_n_(wind_down_n) {}
+
+  bool on_negedge_clk(Vtb* tb) override {
+    // Issue reset process.
+    if (!rstt_.is_done()) {
+      rstt_.check_reset(tb);
+      return !rstt_.is_failed();
+    }
+
+    if (it_ == end_) {
+      // Trace exhausted; drive interfaces idle until wind-down completes.
+      tb::VDriver::issue(tb, tb::UpdateCommand{});
+      tb::VDriver::issue(tb, tb::QueryCommand{});
+      return (--wind_down_n_ > 0);
+    }
+
+    // Frames are consumed in-place from the mapped trace.
+    const tb::trace::Frame& f{*it_++};
+    tb::VDriver::issue(tb, tb::trace::decode(f.uc));
+    tb::VDriver::issue(tb, tb::trace::decode(f.qc));
+    return true;
+  }
+
+ private:
+  tb::Test* parent_;
+  tb::ResetTracker rstt_;
+  const tb::trace::Frame* it_;
+  const tb::trace::Frame* end_;
+  int wind_down_n_;
+};
+
+struct Replay : public tb::Test {
+  CREATE_TEST_BUILDER_WITH_ARGS(Replay, args);
+
+  bool run() override {
+    const Options opts{Options::construct_from_sim()};
+    if (opts.fn.empty()) {
+      V_LOG(logger(), Error, "No trace file provided (-a file=<trace>).");
+      return true;
+    }
+    const tb::trace::Reader r{opts.fn};
+    V_LOG_IF(logger(), true, Info, "Replaying trace: ", opts.fn);
+    return tb::tests::replay::run(this, r.begin(), r.end(), opts.wind_down_n);
+  }
+
+  static tb::JsonDict args() {
+    tb::JsonArray args;
+
+    tb::JsonDict file;
+    file.add("name", "file");
+    args.add(file);
+
+    tb::JsonDict wind_down_n;
+    wind_down_n.add("name", "wind_down_n");
+    args.add(wind_down_n);
+
+    tb::JsonDict d;
+    d.add("arguments", args);
+    return d;
+  }
+};
+
+}  // namespace
+
+namespace tb::tests::replay {
+
+void init(tb::TestRegistry& r) { Replay::Builder::init(r); }
+
+bool run(Test* parent, const trace::Frame* begin, const trace::Frame* end,
+         int wind_down_n) {
+  ReplayCB cb{parent, begin, end, wind_down_n};
+  return Sim::kernel->run(std::addressof(cb));
+}
+
+}  // namespace tb::tests::replay
@@ -50,15 +50,9 @@ const char* to_string(State s) {
 }
 
 std::uint32_t expected_init_cycles() {
-  // Total initialization time (in cycles) is computed as:
-  //
-  //    Total number of contexts in the machine
-  //
-  //  + FSM transition IDLE -> BUSY (1 cycle)
-  //
-  //  + FSM transition BUSY -> DONE (1 cycle)
-  //
-  return cfg::CONTEXT_N + 2;
+  // Initialization clears the tags of all state tables in a single cycle,
+  // irrespective of the number of contexts in the machine.
+  return 1;
 }
 
 struct CheckResetCB : tb::KernelCallbacks {
@@ -0,0 +1,268 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "shm.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "../log.h"
+#include "../model.h"
+#include "../shm.h"
+#include "../tb.h"
+#include "../test.h"
+#include "../trace.h"
+#include "reset.h"
+
+namespace {
+
+// Free records required in each outbound ring before a command is accepted:
+// bounds the responses which may be emitted by commands already in-flight.
+constexpr const std::size_t RESPONSE_HEADROOM = 8;
+
+struct Options {
+  static Options construct_from_sim();
+
+  // Shared-memory region name.
+  std::string name = "/v";
+
+  // Capacity of each ring (records, power of two).
+  std::uint32_t depth = 4096;
+
+  // Stop after this many cycles (0: run until the host closes).
+  std::uint64_t cycles = 0;
+
+  // Trace file driven by a forked, in-tree host process (self-test).
+  std::string loopback;
+
+  // Idle cycles once the host has closed, such that in-flight responses are
+  // retired.
+  int wind_down_n = 10;
+};
+
+Options Options::construct_from_sim() {
+  Options opts;
+  for (const std::string& arg : tb::Sim::test_args) {
+    const std::string::size_type i = arg.find('=');
+    const std::string key{arg.substr(0, i)};
+    const std::string value{(i == std::string::npos) ? "" : arg.substr(i + 1)};
+    if (key == "name") {
+      opts.name = value;
+    } else if (key == "depth") {
+      opts.depth = static_cast<std::uint32_t>(std::stoul(value));
+    } else if (key == "cycles") {
+      opts.cycles = std::stoull(value);
+    } else if (key == "loopback") {
+      opts.loopback = value;
+    } else if (key == "wind_down_n") {
+      opts.wind_down_n = std::stoi(value);
+    } else {
+      // Unknown argument
+    }
+  }
+  return opts;
+}
+
+struct ShmCB : public tb::KernelCallbacks {
+  ShmCB(tb::Test* parent, tb::shm::Region& r, const Options& opts)
+      : rstt_(parent->logger(), true), r_(r), opts_(opts),
+        wind_down_n_(opts.wind_down_n) {}
+
+  bool on_negedge_clk(Vtb* tb) override {
+    if (!rstt_.is_done()) {
+      rstt_.check_reset(tb);
+      return !rstt_.is_failed();
+    }
+
+    // Forward responses emitted on this cycle.
+    const std::uint64_t cycle = tb::Sim::kernel->tb_cycle();
+    r_.set_cycle(cycle);
+    if (const tb::QueryResponse qr{tb::VSampler::qr(tb)}; qr.vld()) {
+      if (!r_.qr().push(tb::shm::encode(cycle, qr))) ++dropped_n;
+      ++qr_n;
+    }
+    if (const tb::NotifyResponse nr{tb::VSampler::nr(tb)}; nr.vld()) {
+      if (!r_.nr().push(tb::shm::encode(cycle, nr))) ++dropped_n;
+      ++nr_n;
+    }
+
+    if ((opts_.cycles != 0) && (++cycles_n_ > opts_.cycles)) return false;
+
+    tb::VDriver::issue(tb, tb::UpdateCommand{});
+    tb::VDriver::issue(tb, tb::QueryCommand{});
+
+    // Commands are accepted only while the host retains space for all
+    // responses which may result.
+    if ((r_.qr().free() <= RESPONSE_HEADROOM) ||
+        (r_.nr().free() <= RESPONSE_HEADROOM)) {
+      ++stall_n;
+      return true;
+    }
+
+    // Host closed flag is sampled before the ring such that no command pushed
+    // prior to close is missed.
+    const bool closed = r_.has_state(tb::shm::STATE_HOST_CLOSED);
+    tb::shm::CommandRecord f;
+    if (r_.cmd().pop(f)) {
+      tb::VDriver::issue(tb, tb::trace::decode(f.uc));
+      tb::VDriver::issue(tb, tb::trace::decode(f.qc));
+      ++cmd_n;
+    } else if (closed) {
+      return (--wind_down_n_ > 0);
+    } else {
+      // Ring is empty; yield to the host.
+      std::this_thread::yield();
+    }
+    return true;
+  }
+
+  std::uint64_t cmd_n = 0;
+  std::uint64_t qr_n = 0;
+  std::uint64_t nr_n = 0;
+  std::uint64_t stall_n = 0;
+  std::uint64_t dropped_n = 0;
+
+ private:
+  tb::ResetTracker rstt_;
+  tb::shm::Region& r_;
+  const Options& opts_;
+  std::uint64_t cycles_n_ = 0;
+  int wind_down_n_;
+};
+
+// Executed within the (forked) host process: drive the trace 'fn' through
+// the rings and check that each Query elicits one response.
+int loopback_host(const std::string& name, const std::string& fn) {
+  tb::shm::Region r{name};
+  const tb::trace::Reader tr{fn};
+
+  std::uint64_t qc_n = 0, qr_n = 0;
+  auto drain = [&]() {
+    tb::shm::QueryResponseRecord qr;
+    while (r.qr().pop(qr)) ++qr_n;
+    tb::shm::NotifyRecord nr;
+    while (r.nr().pop(nr)) {
+    }
+  };
+
+  for (const tb::trace::Frame* f = tr.begin(); f != tr.end();) {
+    if (r.cmd().push(*f)) {
+      if (f->qc.vld) ++qc_n;
+      ++f;
+    } else {
+      drain();
+      std::this_thread::yield();
+    }
+  }
+  r.set_state(tb::shm::STATE_HOST_CLOSED);
+  while (!r.has_state(tb::shm::STATE_SIM_DONE)) {
+    drain();
+    std::this_thread::yield();
+  }
+  drain();
+  return (qr_n == qc_n) ? 0 : 1;
+}
+
+struct Shm : public tb::Test {
+  CREATE_TEST_BUILDER_WITH_ARGS(Shm, args);
+
+  bool run() override {
+    const Options opts{Options::construct_from_sim()};
+    tb::shm::Region r{opts.name,
+                      tb::shm::Capacity{opts.depth, opts.depth, opts.depth}};
+
+    pid_t pid = -1;
+    if (!opts.loopback.empty()) {
+      std::cout.flush();
+      pid = ::fork();
+      if (pid < 0) throw std::runtime_error("Unable to fork");
+      if (pid == 0) {
+        int status = 1;
+        try {
+          status = loopback_host(opts.name, opts.loopback);
+        } catch (const std::exception& ex) {
+          std::cerr << "Loopback host failed: " << ex.what() << "\n";
+        }
+        ::_exit(status);
+      }
+    } else {
+      V_LOG_IF(logger(), true, Info, "Awaiting host on shared memory: ",
+               opts.name);
+    }
+
+    ShmCB cb{this, r, opts};
+    bool failed = tb::Sim::kernel->run(std::addressof(cb));
+    // Release the host, irrespective of outcome.
+    r.set_state(tb::shm::STATE_SIM_DONE);
+
+    if (pid > 0) {
+      int status;
+      ::waitpid(pid, &status, 0);
+      if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+        V_LOG(logger(), Error, "Loopback host reported failure.");
+        failed = true;
+      }
+    }
+    if (cb.dropped_n != 0) {
+      V_LOG_IF(logger(), true, Error, "Responses dropped: ",
+               std::to_string(cb.dropped_n));
+      failed = true;
+    }
+    std::cout << "Shared memory " << opts.name << ": " << cb.cmd_n
+              << " commands, " << cb.qr_n << " query responses, " << cb.nr_n
+              << " notifications, " << cb.stall_n << " stalled cycles\n";
+    return failed;
+  }
+
+  static tb::JsonDict args() {
+    tb::JsonArray args;
+    for (const char* name :
+         {"name", "depth", "cycles", "loopback", "wind_down_n"}) {
+      tb::JsonDict d;
+      d.add("name", name);
+      args.add(d);
+    }
+
+    tb::JsonDict d;
+    d.add("arguments", args);
+    return d;
+  }
+};
+
+}  // namespace
+
+namespace tb::tests::shm {
+
+void init(tb::TestRegistry& r) { Shm::Builder::init(r); }
+
+}  // namespace tb::tests::shm
@@ -269,6 +269,178 @@ struct CheckDelKey : tb::tests::Directed {
   }
 };
 
+struct CheckSnapshotCmd : tb::tests::Directed {
+  CREATE_TEST_BUILDER(CheckSnapshotCmd);
+
+  void program() override {
+    V_NOTE("Test begins...");
+
+    auto snapshot = [&]() {
+      push_back(tb::QueryCommand{0, 0, true});
+      wait_cycles(1);
+    };
+
+    // Snapshot of an empty Context returns no levels.
+    snapshot();
+
+    // Populate the Context one entry at a time, such that snapshots are
+    // taken of a partially and, finally, fully occupied Context.
+    // Keys are added in descending order, each becoming the new head.
+    for (tb::volume_t i = 0; i < cfg::ENTRIES_N; i++) {
+      const tb::key_t key = static_cast<tb::key_t>(cfg::ENTRIES_N - i);
+      push_back(tb::UpdateCommand{0, tb::Cmd::Add, key, i});
+      wait_cycles(10);
+      snapshot();
+    }
+
+    // Snapshot issued alongside an Update to the same Context: errors as busy
+    // unless Queries are forwarded.
+    const tb::key_t head = 1;
+    push_back(tb::UpdateCommand{0, tb::Cmd::Del, head, 0},
+              tb::QueryCommand{0, 0, true});
+    for (int i = 0; i < 6; i++) snapshot();
+
+    V_NOTE("Test ends...");
+  }
+};
+
+struct CheckCumCmd : tb::tests::Directed {
+  CREATE_TEST_BUILDER(CheckCumCmd);
+
+  void program() override {
+    V_NOTE("Test begins...");
+
+    // Cumulative Query of every level of the Context (including those beyond
+    // the list size, which error).
+    auto cum_all = [&]() {
+      wait_cycles(10);
+      for (tb::level_t level = 0; level < cfg::ENTRIES_N; level++) {
+        push_back(tb::QueryCommand{0, level, false, true});
+      }
+    };
+
+    auto issue = [&](tb::Cmd cmd, tb::key_t key, tb::volume_t volume) {
+      push_back(tb::UpdateCommand{0, cmd, key, volume});
+      wait_cycles(1);
+    };
+
+    // Populate the Context, with entries inserted at the head, tail and
+    // interior, such that the prefix sums are updated at each position.
+    for (tb::key_t i = 0; i < cfg::ENTRIES_N; i++) {
+      const tb::key_t key = (i % 2) ? (2 * i) : (4 * cfg::ENTRIES_N - 2 * i);
+      issue(tb::Cmd::Add, key, static_cast<tb::volume_t>(100 + i));
+    }
+    cum_all();
+
+    // Insertion into a full Context spills the tail entry.
+    issue(tb::Cmd::Add, 2 * cfg::ENTRIES_N + 1, 0xFFFF'FFFF);
+    cum_all();
+
+    // Replace and delete at the head and at the interior.
+    issue(tb::Cmd::Rep, 1 * 2, 7);
+    issue(tb::Cmd::Del, 2 * cfg::ENTRIES_N + 1, 0);
+    issue(tb::Cmd::Rep, 4 * cfg::ENTRIES_N, 0xFFFF'FFFF);
+    issue(tb::Cmd::Del, 3 * 2, 0);
+    cum_all();
+
+    V_NOTE("Test ends...");
+  }
+};
+
+struct CheckKeyLookup : tb::tests::Directed {
+  CREATE_TEST_BUILDER(CheckKeyLookup);
+
+  void program() override {
+    V_NOTE("Test begins...");
+
+    // Key Lookup of each key in [0, 4 * ENTRIES_N + 2); every other key is
+    // absent. Level Queries are interleaved, such that responses of both
+    // latencies are outstanding together.
+    auto lookup_all = [&]() {
+      wait_cycles(10);
+      for (tb::key_t key = 0; key < 4 * cfg::ENTRIES_N + 2; key++) {
+        push_back(tb::QueryCommand::lookup(0, key));
+        if (key % 3 == 0) {
+          push_back(tb::QueryCommand{0, static_cast<tb::level_t>(
+                                            key % cfg::ENTRIES_N)});
+        }
+      }
+    };
+
+    auto issue = [&](tb::Cmd cmd, tb::key_t key, tb::volume_t volume) {
+      push_back(tb::UpdateCommand{0, cmd, key, volume});
+      wait_cycles(1);
+    };
+
+    // Empty Context: all Lookups miss.
+    lookup_all();
+
+    // Populate the Context with even keys, inserted at the head, tail and
+    // interior.
+    for (tb::key_t i = 0; i < cfg::ENTRIES_N; i++) {
+      const tb::key_t key = (i % 2) ? (2 * i) : (4 * cfg::ENTRIES_N - 2 * i);
+      issue(tb::Cmd::Add, key, static_cast<tb::volume_t>(100 + i));
+    }
+    lookup_all();
+
+    // Duplicate key: the first matching entry is returned.
+    issue(tb::Cmd::Del, 4 * cfg::ENTRIES_N, 0);
+    issue(tb::Cmd::Add, 2, 7);
+    lookup_all();
+
+    // Lookups coincident with Updates to the same Context.
+    for (tb::key_t key = 1; key < 8; key += 2) {
+      push_back(tb::UpdateCommand{0, tb::Cmd::Add, key, 1},
+                tb::QueryCommand::lookup(0, key));
+      push_back(tb::QueryCommand::lookup(0, key));
+    }
+
+    V_NOTE("Test ends...");
+  }
+};
+
+struct CheckNotifyCoalesce : tb::tests::Directed {
+  CREATE_TEST_BUILDER(CheckNotifyCoalesce);
+
+  void program() override {
+    V_NOTE("Test begins...");
+
+    // Stall the egress such that notifications accumulate in the queue.
+    notify_ready(false);
+
+    // Successive notifications of a Context coalesce into a single slot,
+    // which retains the latest top-of-book.
+    push_back(tb::UpdateCommand{0, tb::Cmd::Add, 1, 1});
+    wait_cycles(1);
+    for (tb::volume_t volume = 2; volume < 5; volume++) {
+      push_back(tb::UpdateCommand{0, tb::Cmd::Rep, 1, volume});
+      wait_cycles(1);
+    }
+
+    // Notifications of an unsubscribed Context are not queued.
+    push_back(tb::SubscribeCommand{1, false});
+    push_back(tb::UpdateCommand{1, tb::Cmd::Add, 1, 1});
+
+    // Notify the remaining Contexts; where these exceed the capacity of the
+    // queue, the excess is dropped (and counted).
+    for (tb::prod_id_t id = 2; id < cfg::CONTEXT_N; id++) {
+      push_back(tb::UpdateCommand{id, tb::Cmd::Add, id, id});
+    }
+    wait_cycles(10);
+
+    // Drain the queue.
+    notify_ready(true);
+    wait_cycles(cfg::NOTIFY_QUEUE_N + 10);
+
+    // Resubscribe; notifications are once again emitted.
+    push_back(tb::SubscribeCommand{1, true});
+    push_back(tb::UpdateCommand{1, tb::Cmd::Rep, 1, 2});
+    wait_cycles(10);
+
+    V_NOTE("Test ends...");
+  }
+};
+
 }  // namespace
 
 namespace tb::tests::smoke_cmds {
@@ -281,6 +453,10 @@ void init(tb::TestRegistry& r) {
   CheckRplCmd::Builder::init(r);
   CheckAddOrder::Builder::init(r);
   CheckDelKey::Builder::init(r);
+  CheckSnapshotCmd::Builder::init(r);
+  CheckCumCmd::Builder::init(r);
+  CheckKeyLookup::Builder::init(r);
+  CheckNotifyCoalesce::Builder::init(r);
 }
 
 }  // namespace tb::tests::smoke_cmds
@@ -0,0 +1,104 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "smoke_coro.h"
+
+#include "../log.h"
+#include "../tb.h"
+#include "../test.h"
+#include "cfg.h"
+#include "coro.h"
+
+namespace {
+
+// Key which becomes the head of the Context upon its i'th Add.
+tb::key_t improving_key(std::size_t i) {
+  return cfg::is_bid_table ? static_cast<tb::key_t>(i + 1)
+                           : static_cast<tb::key_t>(cfg::ENTRIES_N - i);
+}
+
+struct CoroAddNotify : public tb::tests::Coroutine {
+  CREATE_TEST_BUILDER(CoroAddNotify);
+
+  Task program() override {
+    // Each Add displaces the head of the Context, and is therefore followed by
+    // a Notify Response carrying the new head. The next Add is issued upon
+    // its receipt.
+    for (std::size_t i = 0; i < cfg::ENTRIES_N; i++) {
+      const tb::key_t key = improving_key(i);
+      const tb::volume_t volume = static_cast<tb::volume_t>(i);
+      issue(tb::UpdateCommand{0, tb::Cmd::Add, key, volume});
+      const tb::NotifyResponse nr = co_await notify_for(0);
+      V_LOG_IF(logger(), nr.key() != key, Error,
+               "Notify carries unexpected key: ", tb::AsHex{nr.key()});
+    }
+
+    // Allow final Update to clear the pipeline before lookup.
+    co_await cycles(2);
+
+    // Query each level in turn; the response is sampled on the cycle
+    // following issue.
+    for (tb::level_t level = 0; level < cfg::ENTRIES_N; level++) {
+      issue(tb::QueryCommand{0, level});
+      co_await cycles(1);
+      const tb::key_t expected = improving_key(cfg::ENTRIES_N - 1 - level);
+      V_LOG_IF(logger(), !qr().vld() || (qr().key() != expected), Error,
+               "Unexpected Query Response at level ", tb::AsDec{level});
+    }
+  }
+};
+
+struct CoroRplNotify : public tb::tests::Coroutine {
+  CREATE_TEST_BUILDER(CoroRplNotify);
+
+  Task program() override {
+    issue(tb::UpdateCommand{1, tb::Cmd::Add, 100, 1});
+    co_await notify_for(1);
+
+    // Replacement of the head entry notifies its new volume.
+    for (tb::volume_t volume = 2; volume < 10; volume++) {
+      issue(tb::UpdateCommand{1, tb::Cmd::Rep, 100, volume});
+      const tb::NotifyResponse nr = co_await notify_for(1);
+      V_LOG_IF(logger(), nr.volume() != volume, Error,
+               "Notify carries unexpected volume: ", tb::AsDec{nr.volume()});
+    }
+
+    issue(tb::UpdateCommand{1, tb::Cmd::Clr, 0, 0});
+    co_await notify_for(1);
+  }
+};
+
+}  // namespace
+
+namespace tb::tests::smoke_coro {
+
+void init(tb::TestRegistry& r) {
+  CoroAddNotify::Builder::init(r);
+  CoroRplNotify::Builder::init(r);
+}
+
+}  // namespace tb::tests::smoke_coro
@@ -0,0 +1,154 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#include "trace.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "cfg.h"
+#include "mmap.h"
+#include "model.h"
+
+namespace tb::trace {
+
+namespace {
+
+FileHeader make_header(std::uint64_t frames_n) {
+  FileHeader h;
+  std::memset(std::addressof(h), 0, sizeof(FileHeader));
+  std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+  h.version = VERSION;
+  h.frame_bytes = sizeof(Frame);
+  h.update_ports = 1;
+  h.query_ports = 1;
+  h.context_n = cfg::CONTEXT_N;
+  h.entries_n = cfg::ENTRIES_N;
+  h.frames_n = frames_n;
+  return h;
+}
+
+void validate_header(const FileHeader& h, const std::string& fn) {
+  auto fail = [&](const char* reason) {
+    throw std::runtime_error("Invalid trace " + fn + ": " + reason);
+  };
+  if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0) fail("bad magic");
+  if (h.version != VERSION) fail("unsupported version");
+  if (h.frame_bytes != sizeof(Frame)) fail("unexpected frame size");
+  if ((h.update_ports != 1) || (h.query_ports != 1)) fail("port mismatch");
+  if (h.context_n != cfg::CONTEXT_N) fail("CONTEXT_N mismatch");
+  if (h.entries_n != cfg::ENTRIES_N) fail("ENTRIES_N mismatch");
+}
+
+}  // namespace
+
+Frame encode(const UpdateCommand& uc, const QueryCommand& qc) {
+  Frame f;
+  std::memset(std::addressof(f), 0, sizeof(Frame));
+  f.uc.vld = uc.vld() ? 1 : 0;
+  if (uc.vld()) {
+    f.uc.key = uc.key();
+    f.uc.volume = uc.volume();
+    f.uc.prod_id = uc.prod_id();
+    f.uc.cmd = static_cast<std::uint8_t>(uc.cmd());
+  }
+  f.qc.vld = qc.vld() ? 1 : 0;
+  if (qc.vld()) {
+    f.qc.prod_id = qc.prod_id();
+    f.qc.level = qc.level();
+    f.qc.mode = (qc.snapshot() ? 0b001 : 0) | (qc.cum() ? 0b010 : 0) |
+                (qc.is_lookup() ? 0b100 : 0);
+    f.qc.key = qc.key();
+  }
+  return f;
+}
+
+UpdateCommand decode(const UpdateSlot& us) {
+  if (us.vld == 0) return UpdateCommand{};
+
+  return UpdateCommand{static_cast<prod_id_t>(us.prod_id), Cmd{us.cmd}, us.key,
+                       us.volume};
+}
+
+QueryCommand decode(const QuerySlot& qs) {
+  if (qs.vld == 0) return QueryCommand{};
+
+  if ((qs.mode & 0b100) != 0) {
+    return QueryCommand::lookup(static_cast<prod_id_t>(qs.prod_id), qs.key);
+  }
+  return QueryCommand{static_cast<prod_id_t>(qs.prod_id),
+                      static_cast<level_t>(qs.level), (qs.mode & 0b01) != 0,
+                      (qs.mode & 0b10) != 0};
+}
+
+Writer::Writer(const std::string& fn)
+    : os_(fn, std::ios::binary | std::ios::trunc) {
+  if (!os_) {
+    throw std::runtime_error("Unable to open trace for writing: " + fn);
+  }
+  // Header is rewritten on close once the final frame count is known.
+  const FileHeader h{make_header(0)};
+  os_.write(reinterpret_cast<const char*>(std::addressof(h)), sizeof(h));
+}
+
+Writer::~Writer() { close(); }
+
+void Writer::write(const UpdateCommand& uc, const QueryCommand& qc) {
+  if (!os_.is_open()) return;
+
+  const Frame f{encode(uc, qc)};
+  os_.write(reinterpret_cast<const char*>(std::addressof(f)), sizeof(f));
+  ++frames_n_;
+}
+
+void Writer::close() {
+  if (!os_.is_open()) return;
+
+  const FileHeader h{make_header(frames_n_)};
+  os_.seekp(0);
+  os_.write(reinterpret_cast<const char*>(std::addressof(h)), sizeof(h));
+  os_.close();
+}
+
+Reader::Reader(const std::string& fn) {
+  mf_ = std::make_unique<MappedFile>(fn);
+  if (mf_->size() < sizeof(FileHeader)) {
+    throw std::runtime_error("Invalid trace " + fn + ": truncated header");
+  }
+  header_ = reinterpret_cast<const FileHeader*>(mf_->data());
+  validate_header(*header_, fn);
+
+  // Derive frame count from the file size such that a trace which was not
+  // cleanly closed (header not finalized) remains usable.
+  frames_n_ = (mf_->size() - sizeof(FileHeader)) / sizeof(Frame);
+  frames_ = reinterpret_cast<const Frame*>(mf_->data() + sizeof(FileHeader));
+  mf_->advise_sequential();
+}
+
+Reader::~Reader() {}
+
+}  // namespace tb::trace
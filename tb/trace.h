@@ -0,0 +1,154 @@
+//========================================================================== //
+// Copyright (c) 2022, Stephen Henry
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//========================================================================== //
+
+#ifndef V_TB_TRACE_H
+#define V_TB_TRACE_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace tb {
+
+class MappedFile;
+class UpdateCommand;
+class QueryCommand;
+
+namespace trace {
+
+// Stimulus trace file format:
+//
+//   +-------------+---------+---------+-----+---------+
+//   | FileHeader  | Frame 0 | Frame 1 | ... | Frame N |
+//   +-------------+---------+---------+-----+---------+
+//
+// A Frame holds the commands driven onto the Update and Query interfaces on
+// one cycle (including idle cycles, so that the relative timing of commands is
+// retained). All structures are naturally aligned and of fixed size such that
+// a trace can be mapped and consumed in-place without parsing. Fields are in
+// host byte-order.
+
+constexpr const char MAGIC[8] = {'V', 'T', 'R', 'A', 'C', 'E', '\0', '\0'};
+
+constexpr const std::uint32_t VERSION = 2;
+
+struct FileHeader {
+  char magic[8];
+  std::uint32_t version;
+  // Size of each Frame in bytes.
+  std::uint32_t frame_bytes;
+  // Number of Update/Query slots in each Frame.
+  std::uint16_t update_ports;
+  std::uint16_t query_ports;
+  std::uint32_t reserved0;
+  // Configuration for which the trace was recorded.
+  std::uint64_t context_n;
+  std::uint64_t entries_n;
+  // Number of Frames following header.
+  std::uint64_t frames_n;
+  std::uint8_t reserved1[16];
+};
+static_assert(sizeof(FileHeader) == 64);
+
+struct UpdateSlot {
+  std::int64_t key;
+  std::uint32_t volume;
+  std::uint32_t prod_id;
+  std::uint8_t vld;
+  std::uint8_t cmd;
+  std::uint8_t reserved[6];
+};
+static_assert(sizeof(UpdateSlot) == 24);
+
+struct QuerySlot {
+  std::uint32_t prod_id;
+  std::uint16_t level;
+  std::uint8_t vld;
+  // Query mode (formerly reserved, zero): bit 0, snapshot; bit 1,
+  // cumulative; bit 2, Key Lookup.
+  std::uint8_t mode;
+  // Key Lookups only (otherwise, zero).
+  std::int64_t key;
+};
+static_assert(sizeof(QuerySlot) == 16);
+
+struct Frame {
+  UpdateSlot uc;
+  QuerySlot qc;
+};
+static_assert(sizeof(Frame) == 40);
+
+Frame encode(const UpdateCommand& uc, const QueryCommand& qc);
+
+UpdateCommand decode(const UpdateSlot& us);
+
+QueryCommand decode(const QuerySlot& qs);
+
+class Writer {
+ public:
+  explicit Writer(const std::string& fn);
+  ~Writer();
+
+  void write(const UpdateCommand& uc, const QueryCommand& qc);
+
+  // Finalize header and close file; subsequent writes are discarded.
+  void close();
+
+  std::uint64_t frames_n() const { return frames_n_; }
+
+ private:
+  std::ofstream os_;
+  std::uint64_t frames_n_{0};
+};
+
+class Reader {
+ public:
+  explicit Reader(const std::string& fn);
+  ~Reader();
+
+  const FileHeader& header() const { return *header_; }
+
+  std::size_t size() const { return frames_n_; }
+
+  const Frame& operator[](std::size_t i) const { return frames_[i]; }
+
+  const Frame* begin() const { return frames_; }
+  const Frame* end() const { return frames_ + frames_n_; }
+
+ private:
+  std::unique_ptr<MappedFile> mf_;
+  const FileHeader* header_{nullptr};
+  const Frame* frames_{nullptr};
+  std::size_t frames_n_{0};
+};
+
+}  // namespace trace
+
+}  // namespace tb
+
+#endif